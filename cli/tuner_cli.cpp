@@ -0,0 +1,701 @@
+#include "analysis_pipeline.hpp"
+#include "audio_input.hpp"
+#include "audio_input_buffer.hpp"
+#include "shm_ipc.hpp"
+#include "spsc_ring.hpp"
+#include "zoom_scheduler.hpp"
+#include "analysis/long_analysis_engine.hpp"
+#include "analysis/octave_lock_tracker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace tuner;
+
+// Headless tuner: the GUI's analysis pipeline (ZoomFFT lanes, octave lock,
+// long analysis) on tuner_core with JSON-lines output, for rack-mounted
+// units and CI throughput runs.
+//
+// Usage: tuner_cli [options]
+//   --device NAME      ALSA device, file:<path.wav> or synth:<spec> (default "default")
+//   --rate HZ          requested sample rate (default 48000)
+//   --period N         period size in frames (default 64)
+//   --periods N        number of periods (default 2)
+//   --mode M           realtime | fast: pacing of file:/synth: sources (default realtime)
+//   --center HZ        zoom centre; overrides --key/--partial
+//   --key N            piano key 1..88 (49 = A4, default)
+//   --partial K        centre on partial K of the key (default 1)
+//   --a4 HZ            reference pitch for --key (default 440)
+//   --auto             detect each struck key across the keyboard and move
+//                      the zoom (and --adaptive schedule) to it, keeping --partial
+//   --keys             watch all 88 keys (key_channelizer.hpp) and emit an
+//                      "onset" line for each key onset
+//   --gate             skip the zoom while no periodic signal sounds
+//                      (pitch_locator.hpp)
+//   --recenter         move the zoom to the partial the coarse pitch finds
+//                      when it lies outside the span
+//   --idle DB          idle on silence: only the input level is measured
+//                      until it rises above DB dBFS (e.g. -60)
+//   --strike           measure each strike's sustain only: the zoom and the
+//                      octave lock skip the hammer attack (strike_tracker.hpp)
+//   --fft N            zoom FFT size (default 4096)
+//   --decim N          zoom decimation (default 16)
+//   --window SEC       analysed history cap (default 0.35)
+//   --hop SEC          time between frames, the STFT hop over the streamed
+//                      baseband (default 0.01; 0 = one frame per callback)
+//   --estimator E      sub-bin peak estimator: grid | qlog | jacobsen | window (default window)
+//   --span CENTS       zoom span, ±CENTS around the centre (default 120); with
+//                      --adaptive a narrower span decimates further
+//   --sdft             centre spectrum from a sliding DFT bank updated per
+//                      decimated sample instead of the zoom FFT
+//   --adaptive         pick FFT size, decimation and window for the centre
+//                      frequency (zoom_scheduler.hpp) instead of the three above
+//   --every N          emit every Nth frame (default 1; 0 = no frame lines)
+//   --spectrum         include the zoom spectrum in frame lines
+//   --long SEC         repeated long-analysis captures of SEC seconds (default off)
+//   --socket PATH      serve JSON lines on a Unix stream socket instead of stdout
+//   --shm NAME         engine mode: publish frames to shared memory for tuner_gui --attach NAME
+//                      and take note / zoom / capture commands from it
+//   --seconds SEC      stop after SEC seconds of audio (default: until EOF / SIGINT)
+//
+// Line types: "frame" per hop, "long" per long-analysis
+// result, "onset" per key onset with --keys, and one "summary" with
+// throughput figures at exit. With --shm the
+// process is the DSP engine for a separate GUI process.
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void on_signal(int) { g_stop.store(true); }
+
+constexpr int RECENTER_FRAMES = 3;  // --recenter: frames with the partial outside the span before moving
+
+// Line output to stdout, or to every client of a listening Unix socket.
+// Clients that cannot take a whole line immediately are dropped, so a slow
+// reader never stalls the analysis.
+class LineSink {
+public:
+    ~LineSink() {
+        for (int fd : clients) close(fd);
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            unlink(socket_path.c_str());
+        }
+    }
+
+    bool open_socket(const std::string& path) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "Socket path too long: " << path << std::endl;
+            return false;
+        }
+        listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0) {
+            std::perror("socket");
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(path.c_str());
+        if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listen_fd, 8) != 0) {
+            std::perror("bind/listen");
+            close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+        socket_path = path;
+        return true;
+    }
+
+    void write_line(std::string& line) {
+        line.push_back('\n');
+        if (listen_fd < 0) {
+            std::fwrite(line.data(), 1, line.size(), stdout);
+            return;
+        }
+        accept_clients();
+        for (size_t i = 0; i < clients.size();) {
+            const ssize_t n = send(clients[i], line.data(), line.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n != static_cast<ssize_t>(line.size())) {
+                close(clients[i]);
+                clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(i));
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    void flush() {
+        if (listen_fd < 0) std::fflush(stdout);
+    }
+
+private:
+    int listen_fd = -1;
+    std::string socket_path;
+    std::vector<int> clients;
+
+    void accept_clients() {
+        while (true) {
+            const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) break;
+            clients.push_back(fd);
+        }
+    }
+};
+
+void append_number(std::string& out, double v, int precision = 4) {
+    if (!std::isfinite(v)) {
+        out += "null";
+        return;
+    }
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%.*f", precision, v);
+    out += buf;
+}
+
+void append_lane(std::string& out, const char* name, const LaneMeasurement& lane) {
+    out += ",\"";
+    out += name;
+    out += "\":{\"hz\":";
+    append_number(out, lane.freq_hz);
+    out += ",\"mag\":";
+    append_number(out, lane.magnitude, 6);
+    out += ",\"snr\":";
+    append_number(out, lane.snr, 2);
+    out += ",\"phase_hz\":";
+    append_number(out, lane.phase_hz);
+    out += ",\"phase_sd\":";
+    append_number(out, std::sqrt(lane.phase_variance), 4);
+    out += ",\"locked\":";
+    out += lane.locked ? "true" : "false";
+    out += '}';
+}
+
+void format_frame(std::string& out, const AnalysisFrame& f, const gui::OctaveLockTracker& tracker, bool with_spectrum) {
+    out = "{\"type\":\"frame\",\"seq\":";
+    out += std::to_string(f.seq);
+    out += ",\"t\":";
+    append_number(out, f.sample_rate ? static_cast<double>(f.capture_position) / f.sample_rate : 0.0, 6);
+    out += ",\"capture_ns\":";
+    out += std::to_string(f.capture_time_ns);
+    out += ",\"center_hz\":";
+    append_number(out, f.center_frequency_hz);
+    out += ",\"peak_hz\":";
+    append_number(out, f.peak_frequency_hz);
+    out += ",\"peak_mag\":";
+    append_number(out, f.peak_magnitude, 6);
+    out += ",\"phase_hz\":";
+    append_number(out, f.phase_peak_hz);
+    out += ",\"phase_sd\":";
+    append_number(out, std::sqrt(f.phase_peak_variance), 4);
+    out += ",\"fast_hz\":";
+    append_number(out, f.fast_peak_hz);
+    out += ",\"fused_hz\":";
+    append_number(out, f.fused_frequency_hz);
+    out += ",\"rms\":";
+    append_number(out, f.input_rms, 6);
+    out += ",\"dsp_us\":";
+    append_number(out, f.dsp_us, 1);
+    if (f.idle) out += ",\"idle\":true";
+    if (f.nodes_run & node_bit(AnalysisNode::Strike)) {
+        static const char* const phases[] = {"waiting", "attack", "sustain"};
+        out += ",\"strike\":{\"phase\":\"";
+        out += phases[static_cast<int>(f.strike_phase)];
+        out += "\",\"strikes\":";
+        out += std::to_string(f.strikes);
+        out += ",\"age\":";
+        append_number(out, f.strike_age_seconds, 3);
+        out += '}';
+    }
+    append_lane(out, "f0", f.lane0);
+    append_lane(out, "f2", f.lane2);
+    if (f.nodes_run & node_bit(AnalysisNode::KeyDetect)) {
+        out += ",\"detect\":{\"key\":";
+        out += std::to_string(f.detected_key + 1);  // 1..88 as --key; 0 = none yet
+        out += ",\"strikes\":";
+        out += std::to_string(f.detected_strikes);
+        out += ",\"score\":";
+        append_number(out, f.detection_score, 2);
+        out += '}';
+    }
+    if (f.nodes_run & node_bit(AnalysisNode::CoarsePitch)) {
+        out += ",\"coarse\":{\"hz\":";
+        append_number(out, f.coarse_f0_hz);
+        out += ",\"periodicity\":";
+        append_number(out, f.coarse_periodicity, 3);
+        out += ",\"center_hz\":";
+        append_number(out, f.coarse_center_hz);
+        out += ",\"gated\":";
+        out += f.zoom_gated ? "true" : "false";
+        out += '}';
+    }
+    out += ",\"octave\":{\"locked\":";
+    out += tracker.locked() ? "true" : "false";
+    out += ",\"cents\":";
+    if (tracker.has_estimate()) append_number(out, tracker.estimate_cents(), 3);
+    else out += "null";
+    out += ",\"mad\":";
+    append_number(out, tracker.estimate_mad_cents(), 3);
+    out += ",\"captures\":";
+    out += std::to_string(tracker.captures_count());
+    out += '}';
+    if (with_spectrum) {
+        out += ",\"spectrum\":[";
+        for (int i = 0; i < f.num_bins; ++i) {
+            if (i) out += ',';
+            append_number(out, f.spectrum[i], 6);
+        }
+        out += ']';
+    }
+    out += '}';
+}
+
+void format_long(std::string& out, uint64_t version, const gui::LongAnalysisEngine& engine) {
+    out = "{\"type\":\"long\",\"seq\":";
+    out += std::to_string(version);
+    out += ",\"B\":";
+    append_number(out, engine.inharmonicity_B(), 8);
+    out += ",\"harmonics\":[";
+    bool first = true;
+    for (const auto& h : engine.harmonic_results()) {
+        if (!first) out += ',';
+        first = false;
+        out += "{\"n\":";
+        out += std::to_string(h.n);
+        out += ",\"hz\":";
+        append_number(out, h.frequency_hz);
+        out += ",\"cents\":";
+        append_number(out, h.cents, 3);
+        out += ",\"mag\":";
+        append_number(out, h.magnitude, 6);
+        out += '}';
+    }
+    out += "]}";
+}
+
+void format_onset(std::string& out, const AnalysisFrame& f, int key) {
+    out = "{\"type\":\"onset\",\"t\":";
+    append_number(out, f.sample_rate ? static_cast<double>(f.capture_position) / f.sample_rate : 0.0, 6);
+    out += ",\"key\":";
+    out += std::to_string(key + 1);
+    out += ",\"db\":";
+    append_number(out, f.key_level_db[static_cast<size_t>(key)], 1);
+    out += ",\"hz\":";
+    append_number(out, f.key_hz[static_cast<size_t>(key)], 2);
+    out += '}';
+}
+
+bool starts_with(const std::string& s, const char* prefix) {
+    return s.compare(0, std::strlen(prefix), prefix) == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    AudioConfig audio_config;
+    audio_config.device_name = "default";
+    AnalysisPipelineConfig pipeline_config;
+    float center_hz = 0.0f;
+    int key = 49;
+    int partial = 1;
+    float a4_hz = 440.0f;
+    int every = 1;
+    bool with_spectrum = false;
+    bool adaptive = false;
+    bool auto_note = false;
+    bool key_onsets = false;
+    bool recenter = false;
+    float long_seconds = 0.0f;
+    std::string socket_path;
+    std::string shm_name;
+    double max_seconds = 0.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--device") audio_config.device_name = value();
+        else if (arg == "--rate") audio_config.sample_rate = static_cast<unsigned int>(std::atoi(value()));
+        else if (arg == "--period") audio_config.period_size = static_cast<unsigned int>(std::atoi(value()));
+        else if (arg == "--periods") audio_config.num_periods = static_cast<unsigned int>(std::atoi(value()));
+        else if (arg == "--mode") {
+            const std::string m = value();
+            if (m == "fast") audio_config.playback_mode = PlaybackMode::AsFastAsPossible;
+            else if (m == "realtime") audio_config.playback_mode = PlaybackMode::Realtime;
+            else {
+                std::cerr << "Unknown mode: " << m << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--center") center_hz = std::strtof(value(), nullptr);
+        else if (arg == "--key") key = std::atoi(value());
+        else if (arg == "--partial") partial = std::max(1, std::atoi(value()));
+        else if (arg == "--a4") a4_hz = std::strtof(value(), nullptr);
+        else if (arg == "--fft") pipeline_config.fft_size = std::max(64, std::atoi(value()));
+        else if (arg == "--decim") pipeline_config.decimation = std::max(1, std::atoi(value()));
+        else if (arg == "--window") pipeline_config.window_seconds = std::strtof(value(), nullptr);
+        else if (arg == "--hop") pipeline_config.hop_seconds = std::max(0.0f, std::strtof(value(), nullptr));
+        else if (arg == "--estimator") {
+            const std::string e = value();
+            if (!parse_peak_estimator(e.c_str(), pipeline_config.peak_estimator)) {
+                std::cerr << "Unknown estimator: " << e << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--span") pipeline_config.span_cents = std::clamp(std::strtof(value(), nullptr), 1.0f, 1200.0f);
+        else if (arg == "--sdft") pipeline_config.sliding_dft = true;
+        else if (arg == "--every") every = std::max(0, std::atoi(value()));
+        else if (arg == "--spectrum") with_spectrum = true;
+        else if (arg == "--adaptive") adaptive = true;
+        else if (arg == "--auto") auto_note = true;
+        else if (arg == "--keys") key_onsets = true;
+        else if (arg == "--gate") pipeline_config.coarse_gate = true;
+        else if (arg == "--recenter") recenter = true;
+        else if (arg == "--strike") pipeline_config.strike_gate = true;
+        else if (arg == "--idle") {
+            pipeline_config.idle_gate = true;
+            pipeline_config.idle_threshold_db = std::min(-1.0f, std::strtof(value(), nullptr));
+        }
+        else if (arg == "--long") long_seconds = std::strtof(value(), nullptr);
+        else if (arg == "--socket") socket_path = value();
+        else if (arg == "--shm") shm_name = value();
+        else if (arg == "--seconds") max_seconds = std::strtod(value(), nullptr);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--device NAME] [--rate HZ] [--period N] [--periods N]"
+                      << " [--mode realtime|fast] [--center HZ | --key N [--partial K] [--a4 HZ]] [--auto] [--keys] [--gate] [--recenter] [--idle DB] [--strike]"
+                      << " [--fft N] [--decim N] [--window SEC] [--hop SEC] [--estimator E] [--span CENTS] [--sdft] [--adaptive] [--every N] [--spectrum]"
+                      << " [--long SEC] [--socket PATH] [--shm NAME] [--seconds SEC]" << std::endl;
+            return 1;
+        }
+    }
+    if (!(center_hz > 0.0f)) {
+        key = std::max(1, std::min(88, key));
+        center_hz = a4_hz * std::pow(2.0f, (key - 49) / 12.0f) * static_cast<float>(partial);
+    } else {
+        key = 0;  // --center: on no key until --auto detects one
+    }
+
+    // Device backends must never block on output; file/synth sources wait
+    // for the writer instead so that offline runs are lossless
+    const bool lossless = starts_with(audio_config.device_name, "file:") || starts_with(audio_config.device_name, "synth:");
+
+    // Backends report through std::cout; keep stdout for JSON lines only
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    LineSink sink;
+    if (!socket_path.empty() && !sink.open_socket(socket_path)) return 1;
+    ShmEngineChannel shm;
+    if (!shm_name.empty() && !shm.create(shm_name)) return 1;
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    auto audio = createAudioInput(audio_config);
+    if (!audio) {
+        std::cerr << "No audio backend for " << audio_config.device_name << std::endl;
+        return 1;
+    }
+    auto* buffer_source = dynamic_cast<BufferAudioInput*>(audio.get());
+    ZoomSchedulerConfig schedule;
+    schedule.span_cents = pipeline_config.span_cents;
+    schedule.pre_decimation = pipeline_config.pre_decimation;
+    // FFT size, decimation and window for a centre (--adaptive)
+    auto apply_schedule = [&](float hz) {
+        const ZoomSchedule zs = schedule_zoom(hz, audio->get_config().sample_rate, schedule);
+        pipeline_config.fft_size = zs.fft_size;
+        pipeline_config.decimation = zs.decimation;
+        pipeline_config.window_seconds = zs.window_seconds;
+        std::cerr << "Adaptive zoom: D " << zs.decimation << ", FFT " << zs.fft_size << ", window "
+                  << zs.window_seconds << " s (" << zs.resolution_cents << " cents resolution, "
+                  << zs.bin_cents << " cents/bin)" << std::endl;
+    };
+    if (adaptive) apply_schedule(center_hz);
+    pipeline_config.key_detect_a4_hz = a4_hz;
+
+    AnalysisPipeline pipeline(pipeline_config);
+    pipeline.set_center_frequency(center_hz);
+    gui::LongAnalysisEngine long_engine;
+    long_engine.configure(pipeline_config.fft_size, pipeline_config.decimation, pipeline_config.num_bins,
+                          pipeline_config.span_cents);
+    long_engine.set_center_frequency(center_hz / static_cast<float>(partial));
+    gui::OctaveLockTracker tracker;
+    // Lanes feed the octave-lock tracker; frame lines add the peak and, with
+    // --spectrum, the bins. An attached GUI subscribes through SetDemand.
+    pipeline.graph().subscribe(AnalysisConsumer::OctaveLock,
+                               node_bit(AnalysisNode::LaneCenter) | node_bit(AnalysisNode::LaneF0));
+    const AnalysisNodeMask output_nodes =
+        (every > 0 ? node_bit(AnalysisNode::FusedPeak) | (with_spectrum ? node_bit(AnalysisNode::Spectrum) : 0) : 0) |
+        (key_onsets ? node_bit(AnalysisNode::KeyBands) : 0);
+    if (output_nodes) pipeline.graph().subscribe(AnalysisConsumer::FrameOutput, output_nodes);
+    if (auto_note) pipeline.graph().subscribe(AnalysisConsumer::AutoNote, node_bit(AnalysisNode::KeyDetect));
+    if (recenter) pipeline.graph().subscribe(AnalysisConsumer::Recenter, node_bit(AnalysisNode::CoarsePitch));
+
+    // Audio thread -> writer: whole frames, so no result is lost or torn
+    SpscRing<AnalysisFrame> frames(256);
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> audio_samples{0};
+
+    // Wait (file/synth) or give up (devices) when the writer is behind
+    auto reserve_slot = [&]() -> AnalysisFrame* {
+        RingSegments<AnalysisFrame> slot = frames.write_segments(1);
+        while (slot.size() == 0 && lossless && !g_stop.load(std::memory_order_relaxed)) {
+            std::this_thread::yield();
+            slot = frames.write_segments(1);
+        }
+        if (slot.size() == 1) return slot.first.data;
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    };
+
+    audio->set_process_callback([&](const float* input, int num_samples) {
+        const unsigned int fs = audio->get_config().sample_rate;
+        long_engine.feed_audio(input, num_samples, static_cast<int>(fs));
+        // Every callback feeds the lanes; a frame is analysed once per hop
+        if (pipeline.push(input, num_samples, fs)) {
+            if (shm.is_open()) {
+                // Engine mode: analyse straight into the shared seqlock slot;
+                // the JSON writer gets a copy only if it emits frames
+                AnalysisFrame& f = shm.begin_frame();
+                pipeline.analyse(f);
+                shm.end_frame();
+                if (every > 0) {
+                    if (AnalysisFrame* slot = reserve_slot()) {
+                        *slot = f;
+                        frames.commit_write(1);
+                    }
+                }
+            } else if (AnalysisFrame* slot = reserve_slot()) {
+                pipeline.analyse(*slot);
+                frames.commit_write(1);
+            }
+        }
+        audio_samples.fetch_add(static_cast<uint64_t>(std::max(0, num_samples)), std::memory_order_relaxed);
+        long_engine.poll_process();
+    });
+
+    // Zoom settings are built on this thread; the callback only swaps them in
+    pipeline.submit_config(pipeline_config, audio->get_config().sample_rate);
+    const auto t0 = std::chrono::steady_clock::now();
+    if (!audio->start()) {
+        std::cerr << "Failed to start audio on " << audio_config.device_name << std::endl;
+        return 1;
+    }
+    const unsigned int sample_rate = audio->get_config().sample_rate;
+    if (long_seconds > 0.0f) long_engine.start_capture(long_seconds, static_cast<int>(sample_rate));
+
+    std::string line;
+    line.reserve(with_spectrum ? 16384 : 512);
+    uint64_t frames_seen = 0;
+    uint64_t frames_written = 0;
+    float idle_s = 0.0f;        // --idle: audio time idle and DSP time saved, as of the last frame
+    float idle_saved_s = 0.0f;
+    uint64_t long_version = long_engine.results_version();
+    int strikes_seen = 0;
+    std::array<int, KeyChannelizer::NUM_KEYS> onsets_seen{};
+    // --auto: move the lanes (and the schedule) to a newly struck key; the
+    // octave lock starts over for it
+    auto retarget = [&](const AnalysisFrame& f) {
+        if (!(f.nodes_run & node_bit(AnalysisNode::KeyDetect)) || f.detected_strikes == strikes_seen) return;
+        strikes_seen = f.detected_strikes;
+        if (f.detected_key < 0 || f.detected_key + 1 == key) return;
+        key = f.detected_key + 1;
+        center_hz = a4_hz * std::pow(2.0f, (key - 49) / 12.0f) * static_cast<float>(partial);
+        std::cerr << "Key " << key << " detected: centre " << center_hz << " Hz" << std::endl;
+        pipeline.set_center_frequency(center_hz);
+        long_engine.set_center_frequency(center_hz / static_cast<float>(partial));
+        tracker.reset();
+        if (adaptive) {
+            apply_schedule(center_hz);
+            pipeline.submit_config(pipeline_config, sample_rate);
+        }
+    };
+    // --recenter: move the lanes to the partial the coarse pitch found once
+    // it has stayed outside the span for a few frames. Frames analysed
+    // before the move still carry the old centre and are passed over.
+    int off_span = 0;
+    auto follow_coarse = [&](const AnalysisFrame& f) {
+        if (!(f.nodes_run & node_bit(AnalysisNode::CoarsePitch)) || f.center_frequency_hz != center_hz) return;
+        const bool outside = f.coarse_center_hz > 0.0f &&
+                             std::fabs(1200.0f * std::log2(f.coarse_center_hz / center_hz)) > f.span_cents;
+        off_span = outside ? off_span + 1 : 0;
+        if (off_span < RECENTER_FRAMES) return;
+        off_span = 0;
+        key = 0;
+        center_hz = f.coarse_center_hz;
+        std::cerr << "Partial outside the span: centre " << center_hz << " Hz" << std::endl;
+        pipeline.set_center_frequency(center_hz);
+        long_engine.set_center_frequency(center_hz / static_cast<float>(partial));
+        tracker.reset();
+        if (adaptive) {
+            apply_schedule(center_hz);
+            pipeline.submit_config(pipeline_config, sample_rate);
+        }
+    };
+    // Write out every frame the audio thread has committed; false if there was none
+    auto drain = [&]() {
+        bool any = false;
+        while (true) {
+            RingSegments<const AnalysisFrame> seg = frames.peek(1);
+            if (seg.size() == 0) break;
+            const AnalysisFrame& f = *seg.first.data;
+            any = true;
+            ++frames_seen;
+            idle_s = f.idle_seconds;
+            idle_saved_s = f.idle_saved_seconds;
+            if (auto_note) retarget(f);
+            if (recenter) follow_coarse(f);
+            if (key_onsets && (f.nodes_run & node_bit(AnalysisNode::KeyBands))) {
+                for (int k = 0; k < KeyChannelizer::NUM_KEYS; ++k) {
+                    if (f.key_onsets[static_cast<size_t>(k)] == onsets_seen[static_cast<size_t>(k)]) continue;
+                    onsets_seen[static_cast<size_t>(k)] = f.key_onsets[static_cast<size_t>(k)];
+                    format_onset(line, f, k);
+                    sink.write_line(line);
+                }
+            }
+            // Under --strike only sustain frames carry lanes; a frame from
+            // another phase is never captured
+            const bool sustain = !pipeline_config.strike_gate || f.strike_phase == StrikePhase::Monitoring;
+            if (sustain && AnalysisPipeline::lanes_valid(f)) {
+                tracker.push_frame(f.lane0.freq_hz, f.lane2.freq_hz, f.lane0.magnitude, f.lane2.magnitude,
+                                   f.lane0.snr, f.lane2.snr, f.lane0.phase_variance, f.lane2.phase_variance);
+            }
+            if (every > 0 && frames_seen % static_cast<uint64_t>(every) == 0) {
+                format_frame(line, f, tracker, with_spectrum);
+                sink.write_line(line);
+                ++frames_written;
+            }
+            frames.consume(1);
+        }
+        return any;
+    };
+    // Commands from an attached GUI (engine mode)
+    auto handle_commands = [&]() {
+        EngineCommand cmd;
+        while (shm.poll_command(cmd)) {
+            switch (cmd.type) {
+            case EngineCommandType::SetNote:
+                if (cmd.center_hz > 0.0f) pipeline.set_center_frequency(cmd.center_hz);
+                break;
+            case EngineCommandType::SetZoom: {
+                AnalysisPipelineConfig zc = pipeline_config;
+                if (cmd.fft_size > 0) zc.fft_size = cmd.fft_size;
+                if (cmd.decimation > 0) zc.decimation = cmd.decimation;
+                if (cmd.seconds > 0.0f) zc.window_seconds = cmd.seconds;
+                if (cmd.hop_seconds > 0.0f) zc.hop_seconds = cmd.hop_seconds;
+                if (cmd.sliding_dft >= 0) zc.sliding_dft = cmd.sliding_dft != 0;
+                if (cmd.span_cents > 0.0f) zc.span_cents = cmd.span_cents;
+                if (cmd.a4_hz > 0.0f) zc.key_detect_a4_hz = cmd.a4_hz;
+                if (cmd.idle_gate >= 0) zc.idle_gate = cmd.idle_gate != 0;
+                if (cmd.idle_threshold_db < 0.0f) zc.idle_threshold_db = cmd.idle_threshold_db;
+                if (cmd.strike_gate >= 0) zc.strike_gate = cmd.strike_gate != 0;
+                if (cmd.coarse_gate >= 0) zc.coarse_gate = cmd.coarse_gate != 0;
+                pipeline_config = zc;
+                pipeline.submit_config(zc, sample_rate);
+                break;
+            }
+            case EngineCommandType::StartLongCapture:
+                if (long_engine.is_capturing() || long_engine.is_processing()) break;
+                long_engine.configure(cmd.fft_size > 0 ? cmd.fft_size : pipeline_config.fft_size,
+                                      cmd.decimation > 0 ? cmd.decimation : pipeline_config.decimation,
+                                      pipeline_config.num_bins,
+                                      cmd.span_cents > 0.0f ? cmd.span_cents : pipeline_config.span_cents);
+                if (cmd.center_hz > 0.0f) long_engine.set_center_frequency(cmd.center_hz);
+                if (cmd.segments > 0) long_engine.set_num_segments(cmd.segments);
+                if (cmd.harmonics > 0) long_engine.set_num_harmonics(cmd.harmonics);
+                long_engine.start_capture(cmd.seconds, static_cast<int>(sample_rate));
+                break;
+            case EngineCommandType::Stop:
+                g_stop.store(true);
+                break;
+            case EngineCommandType::SetDemand:
+                pipeline.graph().subscribe(AnalysisConsumer::RemoteClient, cmd.nodes);
+                break;
+            case EngineCommandType::None:
+                break;
+            }
+        }
+        shm.heartbeat();
+    };
+    gui::LongAnalysisSnapshot long_snapshot;
+    while (!g_stop.load()) {
+        const bool idle = !drain();
+        if (shm.is_open()) handle_commands();
+        const uint64_t v = long_engine.results_version();
+        if (v != long_version) {
+            long_version = v;
+            format_long(line, v, long_engine);
+            sink.write_line(line);
+            if (shm.is_open()) {
+                long_engine.snapshot(long_snapshot);
+                shm.publish_long(long_snapshot);
+            }
+            if (long_seconds > 0.0f && !g_stop.load()) long_engine.start_capture(long_seconds, static_cast<int>(sample_rate));
+        }
+        sink.flush();
+
+        if (max_seconds > 0.0 && sample_rate > 0 &&
+            static_cast<double>(audio_samples.load()) / sample_rate >= max_seconds) break;
+        if (buffer_source && buffer_source->finished() && frames.read_available() == 0) break;
+        if (idle) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    g_stop.store(true);
+    audio->stop();
+    drain();
+
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const double audio_s = sample_rate ? static_cast<double>(audio_samples.load()) / sample_rate : 0.0;
+    const auto stats = audio->get_latency_stats();
+    line = "{\"type\":\"summary\",\"frames\":";
+    line += std::to_string(pipeline.frames_processed());
+    line += ",\"written\":";
+    line += std::to_string(frames_written);
+    line += ",\"dropped\":";
+    line += std::to_string(dropped.load());
+    line += ",\"xruns\":";
+    line += std::to_string(stats.xruns);
+    line += ",\"audio_s\":";
+    append_number(line, audio_s, 3);
+    line += ",\"wall_s\":";
+    append_number(line, wall_s, 3);
+    line += ",\"realtime_factor\":";
+    append_number(line, wall_s > 0.0 ? audio_s / wall_s : 0.0, 2);
+    line += ",\"frames_per_s\":";
+    append_number(line, wall_s > 0.0 ? pipeline.frames_processed() / wall_s : 0.0, 1);
+    line += ",\"hop_s\":";
+    append_number(line, pipeline.config().hop_seconds, 4);
+    line += ",\"window_s\":";
+    append_number(line, pipeline.config().window_seconds, 4);
+    if (pipeline.config().idle_gate) {
+        line += ",\"idle_s\":";
+        append_number(line, idle_s, 3);
+        line += ",\"idle_saved_s\":";
+        append_number(line, idle_saved_s, 3);
+    }
+    line += '}';
+    sink.write_line(line);
+    sink.flush();
+    return 0;
+}
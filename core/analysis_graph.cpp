@@ -0,0 +1,70 @@
+#include "analysis_graph.hpp"
+
+namespace tuner {
+
+void AnalysisGraph::subscribe(AnalysisConsumer consumer, AnalysisNodeMask nodes) {
+    const int c = static_cast<int>(consumer);
+    subscriptions[c].store(nodes, std::memory_order_relaxed);
+}
+
+AnalysisNodeMask AnalysisGraph::subscription(AnalysisConsumer consumer) const {
+    return subscriptions[static_cast<int>(consumer)].load(std::memory_order_relaxed);
+}
+
+AnalysisNodeMask AnalysisGraph::demand() const {
+    AnalysisNodeMask nodes = 0;
+    for (const auto& s : subscriptions) nodes |= s.load(std::memory_order_relaxed);
+    return with_dependencies(nodes);
+}
+
+AnalysisNodeMask AnalysisGraph::with_dependencies(AnalysisNodeMask nodes) {
+    // Dependencies point to lower-level nodes only, so one pass from the top
+    // down closes the set
+    if (nodes & node_bit(AnalysisNode::WaterfallRow)) nodes |= node_bit(AnalysisNode::Spectrum);
+    if (nodes & node_bit(AnalysisNode::FusedPeak)) nodes |= node_bit(AnalysisNode::Peak) | node_bit(AnalysisNode::ZoomFast);
+    if (nodes & node_bit(AnalysisNode::Peak)) nodes |= node_bit(AnalysisNode::Spectrum);
+    if (nodes & node_bit(AnalysisNode::Spectrum)) nodes |= node_bit(AnalysisNode::ZoomCenter);
+    if (nodes & node_bit(AnalysisNode::ZoomFast)) nodes |= node_bit(AnalysisNode::ZoomCenter);
+    if (nodes & node_bit(AnalysisNode::LaneCenter)) nodes |= node_bit(AnalysisNode::ZoomCenter);
+    if (nodes & node_bit(AnalysisNode::LaneF0)) nodes |= node_bit(AnalysisNode::ZoomF0);
+    return nodes;
+}
+
+const char* AnalysisGraph::node_name(AnalysisNode node) {
+    switch (node) {
+    case AnalysisNode::ZoomCenter: return "Zoom FFT (centre)";
+    case AnalysisNode::ZoomF0: return "Zoom FFT (f0)";
+    case AnalysisNode::ZoomFast: return "Zoom FFT (short window)";
+    case AnalysisNode::LaneCenter: return "Lane (centre)";
+    case AnalysisNode::LaneF0: return "Lane (f0)";
+    case AnalysisNode::Spectrum: return "Spectrum bins";
+    case AnalysisNode::Peak: return "Peak search";
+    case AnalysisNode::FusedPeak: return "Fused peak";
+    case AnalysisNode::KeyDetect: return "Key detection";
+    case AnalysisNode::KeyBands: return "Key bands";
+    case AnalysisNode::CoarsePitch: return "Coarse pitch";
+    case AnalysisNode::Strike: return "Strike phase";
+    case AnalysisNode::WaterfallRow: return "Waterfall row";
+    case AnalysisNode::Count: break;
+    }
+    return "?";
+}
+
+const char* AnalysisGraph::consumer_name(AnalysisConsumer consumer) {
+    switch (consumer) {
+    case AnalysisConsumer::SpectrumView: return "Spectrum view";
+    case AnalysisConsumer::WaterfallView: return "Waterfall view";
+    case AnalysisConsumer::ConcentricView: return "Concentric view";
+    case AnalysisConsumer::KeyboardView: return "Keyboard view";
+    case AnalysisConsumer::NotesState: return "Notes";
+    case AnalysisConsumer::OctaveLock: return "Octave lock";
+    case AnalysisConsumer::FrameOutput: return "Frame output";
+    case AnalysisConsumer::RemoteClient: return "Attached GUI";
+    case AnalysisConsumer::AutoNote: return "Auto note";
+    case AnalysisConsumer::Recenter: return "Recenter";
+    case AnalysisConsumer::Count: break;
+    }
+    return "?";
+}
+
+} // namespace tuner
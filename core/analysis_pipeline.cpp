@@ -0,0 +1,851 @@
+#include "analysis_pipeline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace tuner {
+
+namespace {
+constexpr int MEDIAN_STRIDE = 8;  // noise-floor sampling for lane SNR
+constexpr size_t FILTER_SETTLE_SAMPLES = 2048;  // lead-in when a lane restarts (anti-alias filter decays in ~200), per filter-stage input
+constexpr int MIN_SHORT_WINDOW = 8;  // decimated samples: floor for the fast and phase windows, which narrow spans decimate below
+constexpr float MIN_SPREAD_CENTS = 0.01f;  // floor for the fused-peak weights
+constexpr int FAST_ZERO_PAD = 2;   // short-window FFT size over its window; peaks are refined between bins
+constexpr float LOCK_MIN_SNR = 8.0f;        // lane SNR to lock; a locked lane fades out below half of it
+constexpr float LOCK_STABLE_CENTS = 2.0f;   // frame-to-frame peak change that still counts as steady
+constexpr int LOCK_STABLE_FRAMES = 3;       // steady full measurements before locking
+constexpr float COARSE_MIN_HZ = 25.0f;      // below A0
+constexpr float COARSE_BELOW = 8.0f;        // CoarsePitch searches centre / this ..
+constexpr float COARSE_ABOVE = 4.0f;        // .. centre * this
+constexpr int COARSE_GATE_FRAMES = 10;      // aperiodic frames in a row before coarse_gate idles the zoom
+constexpr float STRIKE_MIN_SUSTAIN = 0.5f;      // of the window: sustain before strike_gate runs the zoom
+constexpr float ACTIVE_COST_SMOOTHING = 0.05f;  // per active frame: the average cost idling saves against
+constexpr int FRONT_BLOCK = 4096;  // input samples the front end filters at a time (front_out holds their output)
+
+// Nodes coarse_gate, idle_gate and strike_gate skip
+constexpr AnalysisNodeMask ZOOM_NODES =
+    node_bit(AnalysisNode::ZoomCenter) | node_bit(AnalysisNode::ZoomF0) | node_bit(AnalysisNode::ZoomFast) |
+    node_bit(AnalysisNode::LaneCenter) | node_bit(AnalysisNode::LaneF0) | node_bit(AnalysisNode::Spectrum) |
+    node_bit(AnalysisNode::Peak) | node_bit(AnalysisNode::FusedPeak);
+
+int next_pow2(int n) {
+    int p = 1;
+    while (p < n && p < (1 << 30)) p <<= 1;
+    return p;
+}
+
+// cfg.decimation rounded down to a multiple of the front end's factor
+int lane_decimation(const AnalysisPipelineConfig& cfg, int factor) {
+    return factor * std::max(1, cfg.decimation / factor);
+}
+
+// Input samples in the analysed window
+int required_input(const AnalysisPipelineConfig& cfg, unsigned int sample_rate, int factor) {
+    return std::min(cfg.fft_size * lane_decimation(cfg, factor), static_cast<int>(sample_rate * cfg.window_seconds));
+}
+
+// Analysed window and the fast level's, in decimated samples
+int window_in_lane(const AnalysisPipelineConfig& cfg, unsigned int sample_rate, int factor) {
+    return std::min(cfg.fft_size, required_input(cfg, sample_rate, factor) / lane_decimation(cfg, factor));
+}
+
+int fast_window_in_lane(const AnalysisPipelineConfig& cfg, unsigned int sample_rate, int factor) {
+    if (!(cfg.fast_window_seconds > 0.0f)) return 0;
+    const int nz = std::max(MIN_SHORT_WINDOW, static_cast<int>(std::lround(cfg.fast_window_seconds * sample_rate /
+                                                                            lane_decimation(cfg, factor))));
+    return std::min(nz, cfg.fft_size);
+}
+
+// Largest front-end factor at any centre: pre_decimation at 48 kHz, and
+// proportionally more on faster devices, so the lanes run at about the same
+// rate whatever the device
+int max_front_factor(const AnalysisPipelineConfig& cfg, unsigned int sample_rate) {
+    if (cfg.pre_decimation <= 1) return 1;
+    return std::min(cfg.pre_decimation * static_cast<int>(std::max(1u, sample_rate / 48000u)), std::max(1, cfg.decimation));
+}
+
+// The front ends built for `a` also serve `b`
+bool same_fronts(const AnalysisPipelineConfig& a, const AnalysisPipelineConfig& b) {
+    return a.fft_size == b.fft_size && a.decimation == b.decimation && a.num_bins == b.num_bins &&
+           a.fast_window_seconds == b.fast_window_seconds && a.pre_decimation == b.pre_decimation &&
+           a.span_cents == b.span_cents && a.sliding_dft == b.sliding_dft &&
+           (!a.sliding_dft || a.window_seconds == b.window_seconds);
+}
+
+// Bin position of the peak at `bin` of a densely sampled spectrum, from a
+// parabola through the log magnitudes around it (the sliding DFT grid has
+// dozens of points per main lobe, where this has no measurable bias)
+float dense_peak_bin(const float* mags, int n, int bin) {
+    if (bin <= 0 || bin >= n - 1) return static_cast<float>(bin);
+    const float lm = std::log(std::max(1e-30f, mags[bin - 1]));
+    const float l0 = std::log(std::max(1e-30f, mags[bin]));
+    const float lp = std::log(std::max(1e-30f, mags[bin + 1]));
+    const float den = lm - 2.0f * l0 + lp;
+    if (!(den < 0.0f)) return static_cast<float>(bin);
+    return static_cast<float>(bin) + std::clamp(0.5f * (lm - lp) / den, -1.0f, 1.0f);
+}
+}
+
+AnalysisPipeline::AnalysisPipeline(const AnalysisPipelineConfig& config)
+    : cfg(config), front_out(static_cast<size_t>(FRONT_BLOCK) + 1), submitted_a4_hz(config.key_detect_a4_hz) {
+    NoteDetectorConfig dc;
+    dc.a4_hz = cfg.key_detect_a4_hz;
+    detector.set_config(dc);
+    KeyChannelizerConfig kc;
+    kc.a4_hz = cfg.key_detect_a4_hz;
+    key_bank.set_config(kc);
+}
+
+AnalysisPipeline::~AnalysisPipeline() {
+    Prepared* p = nullptr;
+    while (incoming.pop(p)) delete p;
+    while (retired.pop(p)) delete p;
+}
+
+void AnalysisPipeline::set_config(const AnalysisPipelineConfig& config) {
+    // The history's size follows the window too
+    if (!same_fronts(config, cfg) || config.window_seconds != cfg.window_seconds) stale = true;
+    apply_config(config);
+    if (detector.config().a4_hz != cfg.key_detect_a4_hz) {
+        NoteDetectorConfig dc = detector.config();
+        dc.a4_hz = cfg.key_detect_a4_hz;
+        detector.set_config(dc);
+    }
+    if (key_bank.config().a4_hz != cfg.key_detect_a4_hz) {
+        KeyChannelizerConfig kc = key_bank.config();
+        kc.a4_hz = cfg.key_detect_a4_hz;
+        key_bank.set_config(kc);
+    }
+}
+
+bool AnalysisPipeline::submit_config(const AnalysisPipelineConfig& config, unsigned int sample_rate) {
+    Prepared* done = nullptr;
+    while (retired.pop(done)) delete done;
+    if (sample_rate == 0 || incoming.write_available() == 0) return false;
+    std::unique_ptr<Prepared> p = prepare(config, sample_rate);
+    if (config.key_detect_a4_hz != submitted_a4_hz) {
+        NoteDetectorConfig dc;
+        dc.a4_hz = config.key_detect_a4_hz;
+        p->detector = std::make_unique<NoteDetector>();
+        p->detector->set_config(dc);
+        KeyChannelizerConfig kc;
+        kc.a4_hz = config.key_detect_a4_hz;
+        p->key_bank = std::make_unique<KeyChannelizer>();
+        p->key_bank->set_config(kc);
+        submitted_a4_hz = config.key_detect_a4_hz;
+    }
+    if (!incoming.push(p.get())) return false;
+    p.release();  // push() hands it back through `retired`
+    return true;
+}
+
+void AnalysisPipeline::apply_config(const AnalysisPipelineConfig& config) {
+    cfg = config;
+    lane_locks[0] = lane_locks[1] = LaneLock{};
+    if (sdft) sdft->reset();
+    if (!cfg.coarse_gate) {
+        zoom_gated = false;
+        aperiodic_frames = 0;
+    }
+    if (!cfg.idle_gate) {
+        idling = false;
+        quiet_samples = 0;
+    }
+}
+
+std::unique_ptr<AnalysisPipeline::Prepared> AnalysisPipeline::prepare(const AnalysisPipelineConfig& config,
+                                                                      unsigned int sample_rate) {
+    auto p = std::make_unique<Prepared>();
+    p->cfg = config;
+    p->sample_rate = sample_rate;
+    const int rate = static_cast<int>(std::max(1u, sample_rate));
+    size_t history_capacity = 0;
+    size_t input_capacity = 0;
+    for (int factor = 1; factor <= max_front_factor(config, sample_rate); factor *= 2) {
+        FrontEnd fe;
+        fe.decimator.configure(rate, factor, FRONT_BLOCK);
+        const int lane_dec = lane_decimation(config, factor) / factor;
+        ZoomFFTConfig zc;
+        zc.decimation = lane_dec;
+        zc.fft_size = config.fft_size;
+        zc.num_bins = config.num_bins;
+        zc.sample_rate = rate / factor;
+        zc.use_hann = true;
+        zc.span_cents = config.span_cents;
+        fe.zoom = std::make_unique<ZoomFFT>(zc);
+        fe.zoom_f0 = std::make_unique<ZoomFFT>(zc);
+        // Short pyramid level: transforms zoom's baseband, so only its FFT differs
+        const int fast_nz = fast_window_in_lane(config, sample_rate, factor);
+        if (fast_nz > 1) {
+            zc.fft_size = std::clamp(next_pow2(fast_nz * FAST_ZERO_PAD), 256, std::max(256, config.fft_size));
+            fe.zoom_fast = std::make_unique<ZoomFFT>(zc);
+        }
+        if (config.sliding_dft) fe.sdft.configure(config.num_bins, window_in_lane(config, sample_rate, factor));
+        p->fronts.push_back(std::move(fe));
+        // History for any centre: a lane that does not split its decimation
+        // settles longest (settle_samples())
+        const size_t held = static_cast<size_t>(std::max(1, required_input(config, sample_rate, factor) / factor)) +
+                            FILTER_SETTLE_SAMPLES * static_cast<size_t>(lane_dec);
+        history_capacity = std::max(history_capacity, held);
+        input_capacity = std::max(input_capacity, held * static_cast<size_t>(factor));
+    }
+    p->input.allocate(input_capacity);
+    p->history.allocate(history_capacity);
+    const size_t bins = static_cast<size_t>(std::max(0, config.num_bins));
+    p->lane_scratch.reserve(bins);
+    p->median_scratch.reserve(bins / MEDIAN_STRIDE + 1);
+    p->fast_spectrum.assign(bins, 0.0f);
+    p->center_bins.reserve(bins);
+    p->locator.reserve(static_cast<int>(history_capacity), static_cast<float>(rate), COARSE_MIN_HZ);
+    return p;
+}
+
+void AnalysisPipeline::install(Prepared& p) {
+    const bool same_rate = p.sample_rate == zoom_rate;
+    const bool keep_fronts = front && !stale && same_rate && same_fronts(p.cfg, cfg);
+    apply_config(p.cfg);
+    // The input and history carry over into the new rings (the newest of
+    // them, if those are smaller)
+    if (same_rate) p.input.push(input_history.latest(input_history.size()), input_history.size());
+    std::swap(input_history, p.input);
+    if (keep_fronts) {
+        p.history.push(history.latest(history.size()), history.size());
+        std::swap(history, p.history);
+    } else {
+        // select_front() decimates the history afresh for the new front ends
+        std::swap(history, p.history);
+        fronts.swap(p.fronts);
+        front = nullptr;
+        zoom = zoom_f0 = zoom_fast = nullptr;
+        sdft = nullptr;
+        zoom_rate = p.sample_rate;
+    }
+    lane_scratch.swap(p.lane_scratch);
+    median_scratch.swap(p.median_scratch);
+    fast_spectrum.swap(p.fast_spectrum);
+    center_bins.swap(p.center_bins);
+    std::swap(locator, p.locator);
+    if (p.detector) {
+        std::swap(detector, *p.detector);
+        detector_fed = false;
+    }
+    if (p.key_bank) {
+        std::swap(key_bank, *p.key_bank);
+        key_bank_fed = false;
+    }
+    stale = false;
+}
+
+void AnalysisPipeline::select_front(int factor, float center_hz) {
+    size_t i = 0;
+    while (i + 1 < fronts.size() && (2 << i) <= factor) ++i;
+    FrontEnd& fe = fronts[i];
+    front = &fe.decimator;
+    zoom = fe.zoom.get();
+    zoom_f0 = fe.zoom_f0.get();
+    zoom_fast = fe.zoom_fast.get();
+    sdft = &fe.sdft;
+    sdft->reset();
+    stream_center_lane = stream_f0_lane = false;
+    // The history at another factor is of no use to these lanes
+    front->reset();
+    history.clear();
+    const size_t len = std::min(input_history.size(),
+                                history_samples(zoom_rate, center_hz) * static_cast<size_t>(front->factor()));
+    const float* in = input_history.latest(len);
+    for (size_t done = 0; done < len; done += FRONT_BLOCK) {
+        const int n = static_cast<int>(std::min<size_t>(FRONT_BLOCK, len - done));
+        history.push(front_out.data(), static_cast<size_t>(front->process(in + done, n, front_out.data())));
+    }
+}
+
+void AnalysisPipeline::ready_front(unsigned int sample_rate, float center_hz) {
+    if (stale || zoom_rate != sample_rate) install(*prepare(cfg, sample_rate));
+    const int factor = front_factor(sample_rate, center_hz);
+    if (!front || factor != front->factor()) select_front(factor, center_hz);
+}
+
+int AnalysisPipeline::decimation() const {
+    return lane_decimation(cfg, front ? front->factor() : 1);
+}
+
+int AnalysisPipeline::fast_window_decimated(unsigned int sample_rate) const {
+    return fast_window_in_lane(cfg, sample_rate, front ? front->factor() : 1);
+}
+
+float AnalysisPipeline::span_median(const float* mags, int n) {
+    median_scratch.clear();
+    for (int b = 0; b < n; b += MEDIAN_STRIDE) median_scratch.push_back(mags[b]);
+    if (median_scratch.empty()) return 1e-9f;
+    const size_t mid = median_scratch.size() / 2;
+    std::nth_element(median_scratch.begin(), median_scratch.begin() + mid, median_scratch.end());
+    return std::max(1e-9f, median_scratch[mid]);
+}
+
+LaneMeasurement AnalysisPipeline::measure_lane(const ZoomFFT& lane_zoom, const float* spectrum, float lane_center_hz,
+                                              bool dense) {
+    LaneMeasurement lane;
+    const int n = lane_zoom.get_config().num_bins;
+    if (n < 2) return lane;
+    // Only the bins within ±lane_search_cents of the lane centre, plus a
+    // strided subset for the noise floor, are sampled (or taken from the full
+    // spectrum when that ran anyway)
+    const float span = lane_zoom.get_config().span_cents;
+    const int center_bin = (n - 1) / 2;
+    const int half_range = std::max(1, static_cast<int>(std::round(cfg.lane_search_cents * (n - 1) / (2.0f * span))));
+    const int i0 = std::max(0, center_bin - half_range);
+    const int i1 = std::min(n - 1, center_bin + half_range);
+    const int count = i1 - i0 + 1;
+    const float* mags = spectrum ? spectrum + i0 : nullptr;
+    if (!mags) {
+        lane_scratch.resize(static_cast<size_t>(count));
+        lane_zoom.sample_bins(i0, count, lane_scratch.data());
+        mags = lane_scratch.data();
+    }
+    float max_mag = 0.0f;
+    int peak_bin = center_bin;
+    for (int i = 0; i < count; ++i) {
+        if (mags[i] > max_mag) { max_mag = mags[i]; peak_bin = i0 + i; }
+    }
+    if (dense) {
+        const float bin = static_cast<float>(i0) + dense_peak_bin(mags, count, peak_bin - i0);
+        lane.freq_hz = lane_center_hz * std::pow(2.0f, (-span + 2.0f * span * bin / (n - 1)) / 1200.0f);
+    } else {
+        const float cents = -span + 2.0f * span * (static_cast<float>(peak_bin) / (n - 1));
+        lane.freq_hz = lane_zoom.refine_peak(lane_center_hz * std::pow(2.0f, cents / 1200.0f), cfg.peak_estimator);
+    }
+    lane.magnitude = max_mag;
+    lane.phase_hz = phase_frequency(lane_zoom, lane.freq_hz, lane.phase_variance);
+    // SNR as peak / median over the whole span for robustness. Every
+    // MEDIAN_STRIDE-th bin is enough and reads the same values either way.
+    median_scratch.clear();
+    for (int b = 0; b < n; b += MEDIAN_STRIDE) {
+        float v = 0.0f;
+        if (spectrum) v = spectrum[b];
+        else lane_zoom.sample_bins(b, 1, &v);
+        median_scratch.push_back(v);
+    }
+    const size_t mid = median_scratch.size() / 2;
+    std::nth_element(median_scratch.begin(), median_scratch.begin() + mid, median_scratch.end());
+    double median = median_scratch[mid];
+    if (median <= 1e-9) median = 1e-9;
+    lane.snr = static_cast<float>(max_mag / median);
+    return lane;
+}
+
+LaneMeasurement AnalysisPipeline::track_lane(int lane_index, ZoomFFT& lane_zoom, int nz, bool locked,
+                                            const float* spectrum, float lane_center_hz, bool dense) {
+    LaneLock& lock = lane_locks[lane_index];
+    LaneMeasurement lane;
+    if (locked) {
+        if (measure_locked(lock, lane_zoom, nz, lane_center_hz, lane)) return lane;
+        // Lost: the zoom FFT was skipped this frame, so run it now
+        if (!dense) lane_zoom.transform(nz);
+        lock.locked = false;
+    }
+    lane = measure_lane(lane_zoom, spectrum, lane_center_hz, dense);
+
+    const bool steady = lane.freq_hz > 0.0f && lock.hz > 0.0f && lane.snr >= LOCK_MIN_SNR &&
+                        std::fabs(1200.0f * std::log2(lane.freq_hz / lock.hz)) <= LOCK_STABLE_CENTS;
+    lock.stable_frames = steady ? lock.stable_frames + 1 : 0;
+    lock.hz = lane.freq_hz;
+    lock.noise_floor = lane.snr > 0.0f ? lane.magnitude / lane.snr : 0.0f;
+    lock.frames_since_full = 0;
+    lock.locked = cfg.lock_bins >= 3 && lock.stable_frames >= LOCK_STABLE_FRAMES;
+    return lane;
+}
+
+bool AnalysisPipeline::measure_locked(LaneLock& lock, const ZoomFFT& lane_zoom, int nz, float lane_center_hz,
+                                      LaneMeasurement& out) {
+    if (++lock.frames_since_full >= std::max(1, cfg.lock_refresh_frames)) return false;
+    const int n = lane_zoom.get_config().fft_size;
+    const float fs_dec = static_cast<float>(zoom_rate) / static_cast<float>(decimation());
+    const int max_bins = static_cast<int>(sizeof(lock_scratch) / sizeof(lock_scratch[0])) - 1;
+    const int count = std::clamp(cfg.lock_bins | 1, 3, max_bins);
+    const int k0 = static_cast<int>(std::lround((lock.hz - lane_center_hz) / fs_dec * static_cast<float>(n)));
+    const int first = k0 - count / 2;
+    lane_zoom.dtft_bins(first, count, nz, lock_scratch);
+
+    int m = 0;
+    for (int i = 1; i < count; ++i) {
+        if (std::abs(lock_scratch[i]) > std::abs(lock_scratch[m])) m = i;
+    }
+    // The peak has moved out of the bins, or faded into the noise
+    if (m == 0 || m == count - 1) return false;
+    const float magnitude = std::abs(lock_scratch[m]);
+    const float snr = lock.noise_floor > 0.0f ? magnitude / lock.noise_floor : 0.0f;
+    if (snr < 0.5f * LOCK_MIN_SNR) return false;
+
+    const int k = first + m;
+    const float delta = peak_offset(cfg.peak_estimator, &lock_scratch[m - 1], k, std::min(nz, n), n,
+                                    lane_zoom.get_config().use_hann);
+    out.freq_hz = lane_center_hz + (static_cast<float>(k) + delta) * fs_dec / static_cast<float>(n);
+    out.magnitude = magnitude;
+    out.snr = snr;
+    out.phase_hz = phase_frequency(lane_zoom, out.freq_hz, out.phase_variance);
+    out.locked = true;
+    lock.hz = out.freq_hz;
+    return true;
+}
+
+float AnalysisPipeline::phase_frequency(const ZoomFFT& lane, float hz, float& variance_cents2) const {
+    variance_cents2 = 0.0f;
+    const int dec = decimation();
+    if (!(cfg.phase_window_seconds > 0.0f) || !(hz > 0.0f)) return 0.0f;
+    const int window = std::max(MIN_SHORT_WINDOW, static_cast<int>(std::lround(cfg.phase_window_seconds * zoom_rate / dec)));
+    // Windows one analysis hop apart (a quarter window when frames follow
+    // pushes): the lag sets both the precision and the ±fs_dec / (2 lag)
+    // range around hz, which the refined magnitude peak is well within
+    const int lag = cfg.hop_seconds > 0.0f ? std::max(1, static_cast<int>(std::lround(cfg.hop_seconds * zoom_rate / dec)))
+                                           : std::max(1, window / 4);
+    float variance_hz2 = 0.0f;
+    const float f = lane.phase_frequency(hz, window, lag, cfg.phase_windows, &variance_hz2);
+    if (!(f > 0.0f)) return 0.0f;
+    const float cents_per_hz = 1731.234f / f;
+    variance_cents2 = variance_hz2 * cents_per_hz * cents_per_hz;
+    return f;
+}
+
+int AnalysisPipeline::front_factor(unsigned int sample_rate, float center_hz) const {
+    const int max_factor = max_front_factor(cfg, sample_rate);
+    if (max_factor <= 1) return 1;
+    return max_front_decimation(static_cast<int>(sample_rate), center_hz, max_factor, cfg.span_cents);
+}
+
+int AnalysisPipeline::required_samples(unsigned int sample_rate) const {
+    return required_input(cfg, sample_rate, front ? front->factor() : 1);
+}
+
+int AnalysisPipeline::window_decimated(unsigned int sample_rate) const {
+    return window_in_lane(cfg, sample_rate, front ? front->factor() : 1);
+}
+
+size_t AnalysisPipeline::history_samples(unsigned int sample_rate, float center_hz) const {
+    return static_cast<size_t>(std::max(1, required_samples(sample_rate) / front->factor())) +
+           settle_samples(sample_rate, center_hz);
+}
+
+size_t AnalysisPipeline::settle_samples(unsigned int sample_rate, float center_hz) const {
+    // A lane that splits its decimation runs its second stage at 1/first of
+    // the history's rate, so that stage needs first times the lead-in. The
+    // f0 lane, an octave down, has the narrower band and the larger split.
+    const int rate = static_cast<int>(sample_rate) / front->factor();
+    const int first = zoom_first_stage(rate, decimation() / front->factor(), 0.5f * center_hz, cfg.span_cents);
+    return FILTER_SETTLE_SAMPLES * static_cast<size_t>(std::max(1, first));
+}
+
+void AnalysisPipeline::prime_lane(ZoomFFT& lane, float hz) {
+    // Replay the window plus some lead-in so the filters have settled by the
+    // time the samples that end up in the window come through
+    lane.reset_stream(hz);
+    size_t window = static_cast<size_t>(std::max(0, required_samples(zoom_rate)) / front->factor());
+    // Under strike_gate the window starts with the sustain; the attack is
+    // left to the filters' lead-in
+    if (cfg.strike_gate) window = std::min<size_t>(window, sustain_samples() / static_cast<uint64_t>(front->factor()));
+    const size_t len = std::min(history.size(), window + settle_samples(zoom_rate, stream_center));
+    lane.push(history.latest(len), static_cast<int>(len));
+}
+
+bool AnalysisPipeline::push(const float* input, int num_samples, unsigned int sample_rate) {
+    const auto push_t0 = std::chrono::steady_clock::now();
+    // Configs submit_config() built; what they replace goes back to be freed
+    Prepared* ready = nullptr;
+    while (retired.write_available() > 0 && incoming.pop(ready)) {
+        install(*ready);
+        retired.push(ready);
+    }
+    const float center = center_frequency();
+    const float cf_guard = (center > 0.0f && std::isfinite(center)) ? center : 440.0f;
+
+    // A centre the front end's band no longer holds moves the lanes behind
+    // another factor's front end
+    ready_front(sample_rate, cf_guard);
+    double block_acc = 0.0;
+    if (input && num_samples > 0) {
+        input_history.push(input, static_cast<size_t>(num_samples));
+        for (int i = 0; i < num_samples; ++i) block_acc += static_cast<double>(input[i]) * static_cast<double>(input[i]);
+        rms_acc += block_acc;
+        rms_count += num_samples;
+        input_position += static_cast<uint64_t>(num_samples);
+    }
+
+    // Silence idle: idle_hold_seconds below the lower level idles the
+    // pipeline; the first block above the threshold wakes it, and the gate
+    // starts over so the zoom runs for the strike straight away
+    woke = false;
+    if (cfg.idle_gate && input && num_samples > 0) {
+        const float level_db = 10.0f * std::log10(static_cast<float>(block_acc / num_samples) + 1e-20f);
+        if (idling) {
+            if (level_db > cfg.idle_threshold_db) {
+                idling = false;
+                woke = true;
+                quiet_samples = 0;
+                aperiodic_frames = 0;
+                zoom_gated = false;
+            }
+        } else {
+            const int hold = static_cast<int>(std::lround(std::max(0.0f, cfg.idle_hold_seconds) * sample_rate));
+            quiet_samples = level_db < cfg.idle_threshold_db - cfg.idle_hysteresis_db
+                                ? std::min(quiet_samples + num_samples, hold) : 0;
+            idling = quiet_samples >= hold;
+        }
+    }
+    if (cf_guard != stream_center) {
+        stream_center = cf_guard;
+        stream_center_lane = stream_f0_lane = false;
+    }
+    // A restarted lane (new note, new zoom, or no longer demanded) starts unlocked
+    if (!stream_center_lane) lane_locks[0] = LaneLock{};
+    if (!stream_f0_lane) lane_locks[1] = LaneLock{};
+
+    // Lanes nobody needs are not fed; they restart from the history when
+    // demanded again. The gate needs CoarsePitch whenever the zoom runs, and
+    // while it is closed the zoom is not needed.
+    pending_demand = nodes.demand();
+    if (cfg.coarse_gate && (pending_demand & ZOOM_NODES)) pending_demand |= node_bit(AnalysisNode::CoarsePitch);
+    if (zoom_gated) pending_demand &= ~ZOOM_NODES;
+    if (cfg.strike_gate && (pending_demand & ZOOM_NODES)) {
+        pending_demand |= node_bit(AnalysisNode::Strike);
+        if (!in_sustain()) pending_demand &= ~ZOOM_NODES;
+    }
+    if (idling) pending_demand = 0;
+    auto feed = [&](ZoomFFT& lane, bool& streaming, float hz, int front_count, float& us) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool restart = !streaming;
+        if (streaming) {
+            lane.push(front_out.data(), front_count);
+        } else {
+            prime_lane(lane, hz);  // the history already holds this block
+            streaming = true;
+            if (&lane == zoom) sdft->reset();
+        }
+        // The sliding DFT follows the centre lane sample by sample
+        if (cfg.sliding_dft && &lane == zoom) sdft->update(lane);
+        const float elapsed = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        us += elapsed;
+        // Restarting the lanes on waking is work idling added
+        if (restart && woke) wake_us += elapsed;
+    };
+    // The front end filters the input a block front_out holds at a time into
+    // the history, and the lanes follow it
+    int done = 0;
+    do {
+        const int count = input ? std::min(FRONT_BLOCK, num_samples - done) : 0;
+        const int front_count = front->process(input ? input + done : nullptr, count, front_out.data());
+        history.push(front_out.data(), static_cast<size_t>(front_count));
+        if (pending_demand & node_bit(AnalysisNode::ZoomCenter)) {
+            feed(*zoom, stream_center_lane, cf_guard, front_count, pending_us[0]);
+        } else {
+            stream_center_lane = false;
+        }
+        if (pending_demand & node_bit(AnalysisNode::ZoomF0)) {
+            feed(*zoom_f0, stream_f0_lane, cf_guard * 0.5f, front_count, pending_us[1]);
+        } else {
+            stream_f0_lane = false;
+        }
+        done += std::max(0, count);
+    } while (done < num_samples && input);
+    // The detector and the key bank see the device rate; when nobody wants
+    // one, it starts over on a fresh history
+    if (pending_demand & node_bit(AnalysisNode::KeyDetect)) {
+        const auto t0 = std::chrono::steady_clock::now();
+        detector.push(input, num_samples, sample_rate);
+        detector_fed = true;
+        pending_us[2] += std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    } else if (detector_fed) {
+        detector.reset();
+        detector_fed = false;
+    }
+    if (pending_demand & node_bit(AnalysisNode::KeyBands)) {
+        const auto t0 = std::chrono::steady_clock::now();
+        key_bank.push(input, num_samples, sample_rate);
+        key_bank_fed = true;
+        pending_us[3] += std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    } else if (key_bank_fed) {
+        key_bank.reset();
+        key_bank_fed = false;
+    }
+
+    pending_dsp_us += std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - push_t0).count();
+    since_frame += std::max(0, num_samples);
+    if (woke) {
+        since_frame = 0;
+        return true;
+    }
+    const float hop_seconds = idling ? cfg.idle_hop_seconds : cfg.hop_seconds;
+    const int hop = hop_seconds > 0.0f ? std::max(1, static_cast<int>(std::lround(hop_seconds * sample_rate))) : 0;
+    if (since_frame < hop) return false;
+    // Keep the remainder so the average rate matches the hop when it is not
+    // a multiple of the callback size, but never owe more than one frame
+    since_frame = hop > 0 ? std::min(since_frame - hop, hop - 1) : 0;
+    return true;
+}
+
+void AnalysisPipeline::analyse(AnalysisFrame& frame) {
+    const auto analyse_t0 = std::chrono::steady_clock::now();
+    const uint64_t capture_time_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(analyse_t0.time_since_epoch()).count());
+    const float cf_guard = stream_center > 0.0f ? stream_center : 440.0f;
+    ready_front(zoom_rate ? zoom_rate : 48000u, cf_guard);
+
+    // Newest window of the decimated baseband; under strike_gate no more of
+    // it than the sustain
+    const int full_window = window_decimated(zoom_rate);
+    int nz_cap = full_window;
+    if (cfg.strike_gate) {
+        nz_cap = static_cast<int>(std::min<uint64_t>(nz_cap, sustain_samples() / static_cast<uint64_t>(decimation())));
+    }
+    const int nz = std::min(nz_cap, zoom->baseband_size());
+    const int nz_f0 = std::min(nz_cap, zoom_f0->baseband_size());
+    const uint64_t hop_samples = input_position - last_position;
+    const float hop_rms = rms_count > 0 ? static_cast<float>(std::sqrt(rms_acc / rms_count)) : 0.0f;
+
+    AnalysisNodeMask demand = pending_demand;
+    frame.nodes_run = 0;
+    frame.node_us.fill(0.0f);
+    auto run = [&](AnalysisNode node, auto&& step) {
+        if (!(demand & node_bit(node))) return false;
+        const auto t0 = std::chrono::steady_clock::now();
+        step();
+        frame.node_us[static_cast<int>(node)] =
+            std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        frame.nodes_run |= node_bit(node);
+        return true;
+    };
+
+    // Coarse pitch first: it decides whether the next frames run the zoom.
+    // This frame follows what push() fed, so a gate that opens here has
+    // the lanes restarted by the next push().
+    frame.coarse_f0_hz = 0.0f;
+    frame.coarse_periodicity = 0.0f;
+    frame.coarse_center_hz = 0.0f;
+    frame.zoom_gated = zoom_gated;
+    run(AnalysisNode::CoarsePitch, [&] {
+        const float rate = static_cast<float>(zoom_rate) / static_cast<float>(front->factor());
+        const float lo = std::max(COARSE_MIN_HZ, cf_guard / COARSE_BELOW);
+        const float hi = std::min(cf_guard * COARSE_ABOVE, 0.4f * rate);
+        const size_t held = std::min(history.size(), history_samples(zoom_rate, cf_guard));
+        const PitchEstimate est = locator.locate(history.latest(held), static_cast<int>(held), rate, lo, hi);
+        frame.coarse_f0_hz = est.f0_hz;
+        frame.coarse_periodicity = est.periodicity;
+        if (est.f0_hz > 0.0f) {
+            frame.coarse_center_hz = est.f0_hz * std::max(1.0f, std::round(cf_guard / est.f0_hz));
+        }
+        aperiodic_frames = est.f0_hz > 0.0f ? 0 : aperiodic_frames + 1;
+    });
+    if (cfg.coarse_gate) zoom_gated = aperiodic_frames >= COARSE_GATE_FRAMES;
+
+    // Strike phase from the hop's level. The zoom skips this frame too when
+    // it is not in a sustain long enough to measure: a new attack may have
+    // reached the lanes in the last push().
+    run(AnalysisNode::Strike, [&] {
+        strike.update(hop_rms, static_cast<int>(std::min<uint64_t>(hop_samples, 1u << 30)), zoom_rate);
+        if (in_sustain() && strike.previous_phase() != StrikePhase::Monitoring) sustain_position = input_position;
+    });
+    frame.strike_phase = strike.phase();
+    frame.strikes = strike.strikes();
+    frame.strike_age_seconds = static_cast<float>(strike.strike_age());
+    if (cfg.strike_gate && (!in_sustain() || nz_cap < STRIKE_MIN_SUSTAIN * full_window)) demand &= ~ZOOM_NODES;
+
+    // Locked lanes skip their zoom FFT; the centre one only while nobody
+    // needs the full spectrum
+    const bool lock_center = lane_locks[0].locked && (demand & node_bit(AnalysisNode::LaneCenter)) &&
+                             !(demand & node_bit(AnalysisNode::Spectrum));
+    const bool lock_f0 = lane_locks[1].locked && (demand & node_bit(AnalysisNode::LaneF0));
+
+    // Zoom node cost: the streaming since the last frame plus the transform
+    const bool dense = cfg.sliding_dft && sdft->num_bins() == cfg.num_bins;
+    if (run(AnalysisNode::ZoomCenter, [&] { if (!lock_center && !dense) zoom->transform(nz); })) {
+        frame.node_us[static_cast<int>(AnalysisNode::ZoomCenter)] += pending_us[0];
+    }
+    if (run(AnalysisNode::ZoomF0, [&] { if (!lock_f0) zoom_f0->transform(nz_f0); })) {
+        frame.node_us[static_cast<int>(AnalysisNode::ZoomF0)] += pending_us[1];
+    }
+    pending_us[0] = pending_us[1] = 0.0f;
+    frame.detected_key = -1;
+    frame.detected_strikes = 0;
+    frame.detection_score = 0.0f;
+    if (run(AnalysisNode::KeyDetect, [&] {
+            const NoteDetection& d = detector.detection();
+            frame.detected_key = d.key;
+            frame.detected_strikes = d.strikes;
+            frame.detection_score = d.score;
+        })) {
+        frame.node_us[static_cast<int>(AnalysisNode::KeyDetect)] += pending_us[2];
+    }
+    pending_us[2] = 0.0f;
+    frame.key_level_db.fill(-120.0f);
+    frame.key_hz.fill(0.0f);
+    frame.key_onsets.fill(0);
+    if (run(AnalysisNode::KeyBands, [&] {
+            for (int k = 0; k < KeyChannelizer::NUM_KEYS; ++k) {
+                const KeyBand& band = key_bank.keys()[static_cast<size_t>(k)];
+                frame.key_level_db[static_cast<size_t>(k)] = band.level_db;
+                frame.key_hz[static_cast<size_t>(k)] = band.hz;
+                frame.key_onsets[static_cast<size_t>(k)] = band.onsets;
+            }
+        })) {
+        frame.node_us[static_cast<int>(AnalysisNode::KeyBands)] += pending_us[3];
+    }
+    pending_us[3] = 0.0f;
+    frame.num_bins = 0;
+    const bool have_spectrum = run(AnalysisNode::Spectrum, [&] {
+        frame.num_bins = std::min(cfg.num_bins, AnalysisFrame::MAX_BINS);
+        if (dense) sdft->magnitudes(frame.spectrum.data(), frame.num_bins);
+        else zoom->sample_bins(0, frame.num_bins, frame.spectrum.data());
+    });
+    // Lanes read the sampled spectrum only if it covers the whole span
+    const float* spectrum = have_spectrum && frame.num_bins == cfg.num_bins ? frame.spectrum.data() : nullptr;
+    frame.lane2 = LaneMeasurement{};
+    frame.lane0 = LaneMeasurement{};
+    run(AnalysisNode::LaneCenter, [&] {
+        const float* bins = spectrum;
+        if (dense && !bins && !lock_center) {
+            center_bins.resize(static_cast<size_t>(cfg.num_bins));
+            sdft->magnitudes(center_bins.data(), cfg.num_bins);
+            bins = center_bins.data();
+        }
+        frame.lane2 = track_lane(0, *zoom, nz, lock_center, bins, cf_guard, dense);
+    });
+    run(AnalysisNode::LaneF0, [&] { frame.lane0 = track_lane(1, *zoom_f0, nz_f0, lock_f0, nullptr, cf_guard * 0.5f); });
+
+    // Full-span peak
+    frame.peak_frequency_hz = 0.0f;
+    frame.peak_magnitude = 0.0f;
+    frame.phase_peak_hz = 0.0f;
+    frame.phase_peak_variance = 0.0f;
+    run(AnalysisNode::Peak, [&] {
+        float max_mag = 0.0f;
+        int peak_bin = 0;
+        for (int i = 0; i < frame.num_bins; ++i) {
+            if (frame.spectrum[i] > max_mag) { max_mag = frame.spectrum[i]; peak_bin = i; }
+        }
+        const float bin = dense ? dense_peak_bin(frame.spectrum.data(), frame.num_bins, peak_bin) : static_cast<float>(peak_bin);
+        const float cents = -cfg.span_cents + 2.0f * cfg.span_cents * (bin / std::max(1, cfg.num_bins - 1));
+        frame.peak_frequency_hz = cf_guard * std::pow(2.0f, cents / 1200.0f);
+        if (!dense) frame.peak_frequency_hz = zoom->refine_peak(frame.peak_frequency_hz, cfg.peak_estimator);
+        frame.peak_magnitude = max_mag;
+        frame.phase_peak_hz = phase_frequency(*zoom, frame.peak_frequency_hz, frame.phase_peak_variance);
+    });
+
+    // Short pyramid level and the fused estimate
+    const float bin_cents = 2.0f * cfg.span_cents / std::max(1, cfg.num_bins - 1);
+    frame.fast_window_samples = 0;
+    frame.fast_peak_hz = 0.0f;
+    frame.fast_peak_magnitude = 0.0f;
+    run(AnalysisNode::ZoomFast, [&] {
+        if (!zoom_fast) return;
+        const int fast_nz = std::min(fast_window_decimated(zoom_rate), zoom->baseband_size());
+        zoom_fast->transform(*zoom, fast_nz);
+        zoom_fast->sample_bins(0, cfg.num_bins, fast_spectrum.data());
+        const auto peak = std::max_element(fast_spectrum.begin(), fast_spectrum.end());
+        if (peak == fast_spectrum.end()) return;
+        frame.fast_window_samples = fast_nz * decimation();
+        const float cents = -cfg.span_cents + bin_cents * static_cast<float>(peak - fast_spectrum.begin());
+        frame.fast_peak_hz = zoom_fast->refine_peak(cf_guard * std::pow(2.0f, cents / 1200.0f), cfg.peak_estimator);
+        frame.fast_peak_magnitude = *peak;
+    });
+    frame.fused_frequency_hz = 0.0f;
+    frame.fused_precise_weight = 0.0f;
+    run(AnalysisNode::FusedPeak, [&] {
+        frame.fused_frequency_hz = frame.peak_frequency_hz;
+        frame.fused_precise_weight = 1.0f;
+        if (!(frame.fast_peak_hz > 0.0f) || !(frame.peak_frequency_hz > 0.0f) || frame.num_bins != cfg.num_bins) return;
+        // Spread of each peak estimate: resolution (1/T) over the spectral
+        // SNR, the Cramer-Rao scaling. Peaks taken from the sampled grid are
+        // also no finer than half of it.
+        auto cents_per_hz = [&](float hz) { return 1731.234f * hz / cf_guard; };
+        const float fs_dec = static_cast<float>(zoom_rate) / static_cast<float>(decimation());
+        // At low notes the whole span lies inside the short window's main
+        // lobe, so its own peak/median says nothing; spectral SNR grows as
+        // sqrt(T), so scale the long window's instead
+        const float snr_precise = frame.peak_magnitude / span_median(frame.spectrum.data(), frame.num_bins);
+        const float snr_fast = snr_precise * std::sqrt(static_cast<float>(frame.fast_window_samples) /
+                                                       static_cast<float>(std::max(1, frame.window_samples)));
+        auto spread = [&](int window_decimated, float snr, int fft_size) {
+            const float sigma = std::max(MIN_SPREAD_CENTS, cents_per_hz(fs_dec / std::max(1, window_decimated)) / std::max(1.0f, snr));
+            if (cfg.peak_estimator != PeakEstimator::Grid) return sigma;
+            return std::max({sigma, 0.5f * cents_per_hz(fs_dec / fft_size), 0.5f * bin_cents});
+        };
+        const float sigma_precise = spread(nz, snr_precise, cfg.fft_size);
+        const float sigma_fast = spread(frame.fast_window_samples / decimation(), snr_fast,
+                                        zoom_fast->get_config().fft_size);
+        // Inverse-variance weights. A long-window peak that disagrees beyond
+        // both spreads is stale (the long window still spans the previous
+        // sound, e.g. right after a strike), so it is faded out.
+        const float d = 1200.0f * std::log2(frame.peak_frequency_hz / frame.fast_peak_hz);
+        const float z2 = d * d / (sigma_precise * sigma_precise + sigma_fast * sigma_fast);
+        const float w_precise = std::exp(-0.5f * z2) / (sigma_precise * sigma_precise);
+        const float w_fast = 1.0f / (sigma_fast * sigma_fast);
+        frame.fused_precise_weight = w_precise / (w_precise + w_fast);
+        frame.fused_frequency_hz = frame.fast_peak_hz +
+                                   frame.fused_precise_weight * (frame.peak_frequency_hz - frame.fast_peak_hz);
+    });
+
+    const uint64_t position = input_position;
+    frame.seq = ++frames;
+    frame.capture_time_ns = capture_time_ns;
+    frame.capture_position = position;
+    frame.hop_samples = static_cast<int>(std::min<uint64_t>(hop_samples, 1u << 30));
+    last_position = position;
+    frame.center_frequency_hz = cf_guard;
+    frame.span_cents = cfg.span_cents;
+    frame.sample_rate = zoom_rate;
+    frame.window_samples = nz * decimation();
+    frame.fft_size = cfg.fft_size;
+    frame.decimation = decimation();
+    frame.decimated_samples = nz;
+    frame.input_rms = hop_rms;
+    rms_acc = 0.0;
+    rms_count = 0;
+
+    // Idle frames save what the same audio cost while active, less their own
+    // time and the lane restart on waking. Silence has no peak to lock to, so
+    // that is the cost of a frame whose lanes search the full span; but a lane
+    // locked when idling began would have held its lock, at the far lower
+    // locked cost, while its window still spanned the note
+    frame.idle = idling;
+    frame.dsp_us = pending_dsp_us +
+                   std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - analyse_t0).count();
+    pending_dsp_us = 0.0f;
+    const float wake_us_spent = wake_us;
+    wake_us = 0.0f;
+    const float hop_s = zoom_rate ? static_cast<float>(frame.hop_samples) / static_cast<float>(zoom_rate) : 0.0f;
+    if (idling) {
+        const float search_cost = search_cost_seconds > 0.0f ? search_cost_us / search_cost_seconds : 0.0f;
+        const float locked_cost = locked_cost_seconds > 0.0f ? locked_cost_us / locked_cost_seconds : search_cost;
+        const float locked_s = std::min(hop_s, idle_locked_seconds);
+        idle_locked_seconds -= locked_s;
+        idle_seconds += hop_s;
+        idle_saved_seconds += 1e-6 * std::max(0.0f, locked_cost * locked_s + search_cost * (hop_s - locked_s) - frame.dsp_us);
+    } else {
+        idle_saved_seconds -= 1e-6 * wake_us_spent;
+        // Weighted by audio time; the frame that woke, which restarted the
+        // lanes, is left out
+        const bool locked = lock_center || lock_f0;
+        float& cost_us = locked ? locked_cost_us : search_cost_us;
+        float& cost_seconds = locked ? locked_cost_seconds : search_cost_seconds;
+        if (!woke) {
+            cost_us += ACTIVE_COST_SMOOTHING * (frame.dsp_us - cost_us);
+            cost_seconds += ACTIVE_COST_SMOOTHING * (hop_s - cost_seconds);
+        }
+        idle_locked_seconds = locked && zoom_rate ? static_cast<float>(frame.window_samples) / static_cast<float>(zoom_rate)
+                                                  : 0.0f;
+    }
+    frame.idle_seconds = static_cast<float>(idle_seconds);
+    frame.idle_saved_seconds = static_cast<float>(idle_saved_seconds);
+}
+
+bool AnalysisPipeline::process(const float* input, int num_samples, unsigned int sample_rate, AnalysisFrame& frame) {
+    if (!push(input, num_samples, sample_rate)) return false;
+    analyse(frame);
+    return true;
+}
+
+bool AnalysisPipeline::lanes_valid(const AnalysisFrame& frame, float min_snr) {
+    return frame.lane0.freq_hz > 0.0f && frame.lane2.freq_hz > 0.0f &&
+           frame.lane0.snr > min_snr && frame.lane2.snr > min_snr;
+}
+
+} // namespace tuner
@@ -26,11 +26,84 @@ static bool parse_key_value(const char* s, const char* key, bool& out) {
     const char* p = std::strstr(s, key);
     if (!p) return false;
     p = std::strchr(p, ':'); if (!p) return false; ++p;
+    while (*p == ' ' || *p == '\t') ++p;
     if (std::strncmp(p, "true", 4) == 0) { out = true; return true; }
     if (std::strncmp(p, "false", 5) == 0) { out = false; return true; }
     return false;
 }
 
+// Value of a string key, read between the quotes (no escape handling)
+static bool parse_string_value(const char* s, const char* key, std::string& out) {
+    const char* p = std::strstr(s, key);
+    if (!p) return false;
+    p = std::strchr(p, ':'); if (!p) return false; ++p;
+    while (*p == ' ' || *p == '\t') ++p;
+    if (*p != '"') return false;
+    const char* start = ++p;
+    while (*p && *p != '"' && *p != '\n' && *p != '\r') ++p;
+    out.assign(start, p - start);
+    return true;
+}
+
+// "audio_profiles": [ {...}, {...} ] -- one flat object per device
+static void parse_audio_profiles(const std::string& buf, std::vector<AudioDeviceProfile>& out) {
+    size_t p = buf.find("\"audio_profiles\"");
+    if (p == std::string::npos) return;
+    p = buf.find('[', p);
+    const size_t end = buf.find(']', p);
+    if (p == std::string::npos || end == std::string::npos) return;
+    out.clear();
+    while (true) {
+        const size_t ob = buf.find('{', p);
+        if (ob == std::string::npos || ob > end) break;
+        const size_t cb = buf.find('}', ob);
+        if (cb == std::string::npos || cb > end) break;
+        const std::string obj = buf.substr(ob, cb - ob + 1);
+        AudioDeviceProfile prof;
+        int rate = 0, period = 0, periods = 0;
+        if (parse_string_value(obj.c_str(), "\"device\"", prof.device) &&
+            parse_key_value(obj.c_str(), "\"sample_rate\"", rate) &&
+            parse_key_value(obj.c_str(), "\"period_size\"", period) &&
+            parse_key_value(obj.c_str(), "\"num_periods\"", periods) &&
+            rate > 0 && period > 0 && periods > 0) {
+            prof.sample_rate = (unsigned int)rate;
+            prof.period_size = (unsigned int)period;
+            prof.num_periods = (unsigned int)periods;
+            parse_key_value(obj.c_str(), "\"avg_load\"", prof.avg_load);
+            parse_key_value(obj.c_str(), "\"peak_load\"", prof.peak_load);
+            out.push_back(prof);
+        }
+        p = cb + 1;
+    }
+}
+
+// "zoom_overrides": [ {"first_key": 1, "last_key": 12, ...}, ... ]
+static void parse_zoom_overrides(const std::string& buf, std::vector<ZoomRegisterOverride>& out) {
+    size_t p = buf.find("\"zoom_overrides\"");
+    if (p == std::string::npos) return;
+    p = buf.find('[', p);
+    const size_t end = buf.find(']', p);
+    if (p == std::string::npos || end == std::string::npos) return;
+    out.clear();
+    while (true) {
+        const size_t ob = buf.find('{', p);
+        if (ob == std::string::npos || ob > end) break;
+        const size_t cb = buf.find('}', ob);
+        if (cb == std::string::npos || cb > end) break;
+        const std::string obj = buf.substr(ob, cb - ob + 1);
+        ZoomRegisterOverride ov;
+        if (parse_key_value(obj.c_str(), "\"first_key\"", ov.first_key) &&
+            parse_key_value(obj.c_str(), "\"last_key\"", ov.last_key) &&
+            ov.first_key >= 1 && ov.last_key <= 88 && ov.first_key <= ov.last_key) {
+            parse_key_value(obj.c_str(), "\"fft_size\"", ov.fft_size);
+            parse_key_value(obj.c_str(), "\"decimation\"", ov.decimation);
+            parse_key_value(obj.c_str(), "\"window_seconds\"", ov.window_seconds);
+            out.push_back(ov);
+        }
+        p = cb + 1;
+    }
+}
+
 bool load_settings(const char* path, AppSettings& st) {
     FILE* f = std::fopen(path, "rb");
     if (!f) return false;
@@ -47,6 +120,20 @@ bool load_settings(const char* path, AppSettings& st) {
     parse_key_value(buf.c_str(), "\"precise_fft_size\"", st.precise_fft_size);
     parse_key_value(buf.c_str(), "\"precise_decimation\"", st.precise_decimation);
     parse_key_value(buf.c_str(), "\"precise_window_seconds\"", st.precise_window_seconds);
+    parse_key_value(buf.c_str(), "\"adaptive_zoom\"", st.adaptive_zoom);
+    parse_key_value(buf.c_str(), "\"zoom_resolution_cents\"", st.zoom_resolution_cents);
+    parse_key_value(buf.c_str(), "\"zoom_bin_cents\"", st.zoom_bin_cents);
+    parse_key_value(buf.c_str(), "\"zoom_max_window_seconds\"", st.zoom_max_window_seconds);
+    parse_key_value(buf.c_str(), "\"zoom_span_cents\"", st.zoom_span_cents);
+    parse_zoom_overrides(buf, st.zoom_overrides);
+    parse_key_value(buf.c_str(), "\"analysis_rate_hz\"", st.analysis_rate_hz);
+    parse_key_value(buf.c_str(), "\"sliding_dft_spectrum\"", st.sliding_dft_spectrum);
+    parse_key_value(buf.c_str(), "\"auto_detect_note\"", st.auto_detect_note);
+    parse_key_value(buf.c_str(), "\"idle_on_silence\"", st.idle_on_silence);
+    parse_key_value(buf.c_str(), "\"idle_threshold_db\"", st.idle_threshold_db);
+    parse_key_value(buf.c_str(), "\"sustain_only\"", st.sustain_only);
+    parse_key_value(buf.c_str(), "\"pitch_gate\"", st.pitch_gate);
+    parse_key_value(buf.c_str(), "\"follow_pitch\"", st.follow_pitch);
     parse_key_value(buf.c_str(), "\"show_frequency_lines\"", st.show_frequency_lines);
     parse_key_value(buf.c_str(), "\"show_peak_line\"", st.show_peak_line);
     parse_key_value(buf.c_str(), "\"bell_curve_width\"", st.bell_curve_width);
@@ -68,6 +155,8 @@ bool load_settings(const char* path, AppSettings& st) {
             st.last_session_path.assign(start, p - start);
         }
     }
+    parse_string_value(buf.c_str(), "\"audio_device\"", st.audio_device);
+    parse_audio_profiles(buf, st.audio_profiles);
     return true;
 }
 
@@ -80,6 +169,19 @@ bool save_settings(const char* path, const AppSettings& st) {
         "  \"precise_fft_size\": %d,\n"
         "  \"precise_decimation\": %d,\n"
         "  \"precise_window_seconds\": %.3f,\n"
+        "  \"adaptive_zoom\": %s,\n"
+        "  \"zoom_resolution_cents\": %.3f,\n"
+        "  \"zoom_bin_cents\": %.3f,\n"
+        "  \"zoom_max_window_seconds\": %.3f,\n"
+        "  \"zoom_span_cents\": %.1f,\n"
+        "  \"analysis_rate_hz\": %.1f,\n"
+        "  \"sliding_dft_spectrum\": %s,\n"
+        "  \"auto_detect_note\": %s,\n"
+        "  \"idle_on_silence\": %s,\n"
+        "  \"idle_threshold_db\": %.1f,\n"
+        "  \"sustain_only\": %s,\n"
+        "  \"pitch_gate\": %s,\n"
+        "  \"follow_pitch\": %s,\n"
         
         "  \"show_frequency_lines\": %s,\n"
         "  \"show_peak_line\": %s,\n"
@@ -90,12 +192,26 @@ bool save_settings(const char* path, const AppSettings& st) {
         "  \"show_cent_labels\": %s,\n"
         "  \"cent_label_size\": %d,\n"
         "  \"ui_mode\": %d,\n"
-        "  \"last_session_path\": \"%s\"\n"
-        "}\n",
+        "  \"last_session_path\": \"%s\",\n"
+        "  \"audio_device\": \"%s\",\n"
+        "  \"audio_profiles\": [",
         st.center_frequency_hz,
         st.precise_fft_size,
         st.precise_decimation,
         st.precise_window_seconds,
+        st.adaptive_zoom ? "true" : "false",
+        st.zoom_resolution_cents,
+        st.zoom_bin_cents,
+        st.zoom_max_window_seconds,
+        st.zoom_span_cents,
+        st.analysis_rate_hz,
+        st.sliding_dft_spectrum ? "true" : "false",
+        st.auto_detect_note ? "true" : "false",
+        st.idle_on_silence ? "true" : "false",
+        st.idle_threshold_db,
+        st.sustain_only ? "true" : "false",
+        st.pitch_gate ? "true" : "false",
+        st.follow_pitch ? "true" : "false",
         st.show_frequency_lines ? "true" : "false",
         st.show_peak_line ? "true" : "false",
         st.bell_curve_width,
@@ -105,7 +221,25 @@ bool save_settings(const char* path, const AppSettings& st) {
         st.show_cent_labels ? "true" : "false",
         st.cent_label_size,
         st.ui_mode,
-        st.last_session_path.c_str());
+        st.last_session_path.c_str(),
+        st.audio_device.c_str());
+    for (size_t i = 0; i < st.audio_profiles.size(); ++i) {
+        const AudioDeviceProfile& ap = st.audio_profiles[i];
+        std::fprintf(f,
+            "%s\n    {\"device\": \"%s\", \"sample_rate\": %u, \"period_size\": %u, \"num_periods\": %u, "
+            "\"avg_load\": %.3f, \"peak_load\": %.3f}",
+            i ? "," : "", ap.device.c_str(), ap.sample_rate, ap.period_size, ap.num_periods,
+            ap.avg_load, ap.peak_load);
+    }
+    std::fprintf(f, "%s],\n  \"zoom_overrides\": [", st.audio_profiles.empty() ? "" : "\n  ");
+    for (size_t i = 0; i < st.zoom_overrides.size(); ++i) {
+        const ZoomRegisterOverride& ov = st.zoom_overrides[i];
+        std::fprintf(f,
+            "%s\n    {\"first_key\": %d, \"last_key\": %d, \"fft_size\": %d, \"decimation\": %d, "
+            "\"window_seconds\": %.3f}",
+            i ? "," : "", ov.first_key, ov.last_key, ov.fft_size, ov.decimation, ov.window_seconds);
+    }
+    std::fprintf(f, "%s]\n}\n", st.zoom_overrides.empty() ? "" : "\n  ");
     std::fclose(f);
     return true;
 }
@@ -0,0 +1,219 @@
+#include "channel_mix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace tuner {
+
+const char* channel_mode_name(ChannelMode mode) {
+    switch (mode) {
+        case ChannelMode::Select: return "select";
+        case ChannelMode::Average: return "average";
+        case ChannelMode::MaxEnergy: return "max-energy";
+    }
+    return "unknown";
+}
+
+static int deinterleave_stereo_simd(const float* in, int frames, float* l, float* r) {
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= frames; i += 8) {
+        __m256 a = _mm256_loadu_ps(in + 2 * i);
+        __m256 b = _mm256_loadu_ps(in + 2 * i + 8);
+        // Per 128-bit lane: evens/odds of a and b, then fix the lane order
+        __m256 lo = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 hi = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        lo = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(lo), _MM_SHUFFLE(3, 1, 2, 0)));
+        hi = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(hi), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(l + i, lo);
+        _mm256_storeu_ps(r + i, hi);
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(in + 2 * i);
+        __m128 b = _mm_loadu_ps(in + 2 * i + 4);
+        _mm_storeu_ps(l + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(r + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t v = vld2q_f32(in + 2 * i);
+        vst1q_f32(l + i, v.val[0]);
+        vst1q_f32(r + i, v.val[1]);
+    }
+#else
+    (void)in; (void)l; (void)r;
+#endif
+    return i;
+}
+
+static int deinterleave_quad_simd(const float* in, int frames, float* const* p) {
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= frames; i += 4) {
+        __m128 r0 = _mm_loadu_ps(in + 4 * i);
+        __m128 r1 = _mm_loadu_ps(in + 4 * i + 4);
+        __m128 r2 = _mm_loadu_ps(in + 4 * i + 8);
+        __m128 r3 = _mm_loadu_ps(in + 4 * i + 12);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(p[0] + i, r0);
+        _mm_storeu_ps(p[1] + i, r1);
+        _mm_storeu_ps(p[2] + i, r2);
+        _mm_storeu_ps(p[3] + i, r3);
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x4_t v = vld4q_f32(in + 4 * i);
+        vst1q_f32(p[0] + i, v.val[0]);
+        vst1q_f32(p[1] + i, v.val[1]);
+        vst1q_f32(p[2] + i, v.val[2]);
+        vst1q_f32(p[3] + i, v.val[3]);
+    }
+#else
+    (void)in; (void)p;
+#endif
+    return i;
+}
+
+void deinterleave(const float* interleaved, int frames, int channels, float* const* planes) {
+    if (!interleaved || !planes || frames <= 0 || channels <= 0) return;
+    if (channels == 1) {
+        std::memcpy(planes[0], interleaved, static_cast<size_t>(frames) * sizeof(float));
+        return;
+    }
+    int done = 0;
+    if (channels == 2) done = deinterleave_stereo_simd(interleaved, frames, planes[0], planes[1]);
+    else if (channels == 4) done = deinterleave_quad_simd(interleaved, frames, planes);
+    for (int i = done; i < frames; ++i) {
+        const float* frame = interleaved + static_cast<size_t>(i) * channels;
+        for (int c = 0; c < channels; ++c) planes[c][i] = frame[c];
+    }
+}
+
+void ChannelCombiner::configure(int channels, ChannelMode mode, int select_channel, int sample_rate, int max_frames) {
+    num_channels = std::max(1, channels);
+    channel_mode = mode;
+    active = std::max(0, std::min(num_channels - 1, select_channel));
+    if (mode == ChannelMode::Average) active = -1;
+    planes.assign(num_channels, std::vector<float>(std::max(1, max_frames), 0.0f));
+    plane_ptrs.resize(num_channels);
+    for (int c = 0; c < num_channels; ++c) plane_ptrs[c] = planes[c].data();
+    energy.assign(num_channels, 0.0f);
+    // Energy EMA with ~100 ms time constant at the expected block size
+    const float block_sec = static_cast<float>(std::max(1, max_frames)) / static_cast<float>(std::max(1, sample_rate));
+    energy_alpha = 1.0f - std::exp(-block_sec / 0.1f);
+
+    active_low = active;
+    low_energy.assign(num_channels, 0.0f);
+    high_energy.assign(num_channels, 0.0f);
+    lp_state.assign(static_cast<size_t>(num_channels) * 2, 0.0f);
+    if (mode == ChannelMode::MaxEnergy && num_channels > 1) {
+        low_planes.assign(num_channels, std::vector<float>(std::max(1, max_frames), 0.0f));
+        // Bilinear-transform Butterworth lowpass (Q = 1/sqrt(2))
+        const double w0 = 2.0 * M_PI * CROSSOVER_HZ / std::max(1, sample_rate);
+        const double alpha = std::sin(w0) / std::sqrt(2.0);
+        const double a0 = 1.0 + alpha;
+        const double cw = std::cos(w0);
+        lp_b0 = static_cast<float>((1.0 - cw) * 0.5 / a0);
+        lp_b1 = static_cast<float>((1.0 - cw) / a0);
+        lp_b2 = lp_b0;
+        lp_a1 = static_cast<float>(-2.0 * cw / a0);
+        lp_a2 = static_cast<float>((1.0 - alpha) / a0);
+    } else {
+        low_planes.clear();
+    }
+}
+
+int ChannelCombiner::pick_channel(const std::vector<float>& e, int current) const {
+    int best = current;
+    for (int c = 0; c < num_channels; ++c) {
+        if (e[c] > e[best]) best = c;
+    }
+    // Only switch when the new channel is clearly stronger
+    return (best != current && e[best] > switch_ratio * e[current]) ? best : current;
+}
+
+void ChannelCombiner::process(const float* interleaved, int frames, float* mono) {
+    if (!interleaved || !mono || frames <= 0) return;
+    if (num_channels == 1) {
+        std::memcpy(mono, interleaved, static_cast<size_t>(frames) * sizeof(float));
+        return;
+    }
+    if (frames > static_cast<int>(planes[0].size())) {
+        // Oversized block: fall back to growing (only happens if the device lied about period size)
+        for (auto& p : planes) p.resize(frames);
+        for (auto& p : low_planes) p.resize(frames);
+        for (int c = 0; c < num_channels; ++c) plane_ptrs[c] = planes[c].data();
+    }
+    deinterleave(interleaved, frames, num_channels, plane_ptrs.data());
+
+    switch (channel_mode) {
+        case ChannelMode::Select: {
+            std::memcpy(mono, plane_ptrs[active], static_cast<size_t>(frames) * sizeof(float));
+            break;
+        }
+        case ChannelMode::Average: {
+            const float scale = 1.0f / static_cast<float>(num_channels);
+            const float* p0 = plane_ptrs[0];
+            for (int i = 0; i < frames; ++i) mono[i] = p0[i];
+            for (int c = 1; c < num_channels; ++c) {
+                const float* pc = plane_ptrs[c];
+                for (int i = 0; i < frames; ++i) mono[i] += pc[i];
+            }
+            for (int i = 0; i < frames; ++i) mono[i] *= scale;
+            break;
+        }
+        case ChannelMode::MaxEnergy: {
+            const float inv = 1.0f / static_cast<float>(frames);
+            for (int c = 0; c < num_channels; ++c) {
+                const float* pc = plane_ptrs[c];
+                float* lo = low_planes[c].data();
+                float z1 = lp_state[2 * c];
+                float z2 = lp_state[2 * c + 1];
+                float acc_lo = 0.0f;
+                float acc_hi = 0.0f;
+                for (int i = 0; i < frames; ++i) {
+                    // Transposed direct form II
+                    const float x = pc[i];
+                    const float y = lp_b0 * x + z1;
+                    z1 = lp_b1 * x - lp_a1 * y + z2;
+                    z2 = lp_b2 * x - lp_a2 * y;
+                    lo[i] = y;
+                    const float h = x - y;
+                    acc_lo += y * y;
+                    acc_hi += h * h;
+                }
+                lp_state[2 * c] = z1;
+                lp_state[2 * c + 1] = z2;
+                low_energy[c] += energy_alpha * (acc_lo * inv - low_energy[c]);
+                high_energy[c] += energy_alpha * (acc_hi * inv - high_energy[c]);
+                energy[c] = low_energy[c] + high_energy[c];
+            }
+            active_low = pick_channel(low_energy, active_low);
+            active = pick_channel(high_energy, active);
+            if (active_low == active) {
+                std::memcpy(mono, plane_ptrs[active], static_cast<size_t>(frames) * sizeof(float));
+                break;
+            }
+            // low[bass] + (x - low)[treble]
+            const float* lo = low_planes[active_low].data();
+            const float* x = plane_ptrs[active];
+            const float* xl = low_planes[active].data();
+            for (int i = 0; i < frames; ++i) mono[i] = lo[i] + (x[i] - xl[i]);
+            break;
+        }
+    }
+}
+
+} // namespace tuner
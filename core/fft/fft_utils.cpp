@@ -1,32 +1,42 @@
 #include "tuner/fft/fft_utils.hpp"
-#include <unordered_map>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <mutex>
+#include <utility>
 
 namespace tuner::fft {
 
-static std::unordered_map<int, std::vector<int>> g_bitrev;
-static std::unordered_map<int, std::vector<std::vector<std::complex<float>>>> g_twiddles;
+namespace {
+struct Tables {
+    std::vector<int> bitrev;
+    std::vector<std::vector<std::complex<float>>> twiddles;  // per stage
+};
 
-static const std::vector<int>& get_or_build_bitrev(int n) {
-    auto it = g_bitrev.find(n);
-    if (it != g_bitrev.end()) return it->second;
-    int bits = 0; while ((1 << bits) < n) ++bits;
-    std::vector<int> br(n);
+// One slot per power of two; filled once and never freed, so a lookup is a
+// single atomic load and a transform never allocates once its size is built
+std::array<std::atomic<const Tables*>, 31> g_tables{};
+std::mutex g_build_mutex;
+
+int log2_size(int n) {
+    int bits = 0;
+    while ((1 << bits) < n) ++bits;
+    return bits;
+}
+
+const Tables& build_tables(int n) {
+    const int bits = log2_size(n);
+    std::lock_guard<std::mutex> lock(g_build_mutex);
+    if (const Tables* t = g_tables[bits].load(std::memory_order_acquire)) return *t;
+    auto* t = new Tables;
+    t->bitrev.resize(static_cast<size_t>(n));
     for (int i = 0; i < n; ++i) {
         unsigned int v = static_cast<unsigned int>(i);
         unsigned int r = 0;
         for (int b = 0; b < bits; ++b) { r = (r << 1) | (v & 1u); v >>= 1; }
-        br[i] = static_cast<int>(r);
+        t->bitrev[static_cast<size_t>(i)] = static_cast<int>(r);
     }
-    auto [ins, _] = g_bitrev.emplace(n, std::move(br));
-    return ins->second;
-}
-
-static const std::vector<std::vector<std::complex<float>>>& get_or_build_twiddles(int n) {
-    auto it = g_twiddles.find(n);
-    if (it != g_twiddles.end()) return it->second;
     const float two_pi = 6.28318530717958647692f;
-    std::vector<std::vector<std::complex<float>>> stages;
     for (int len = 2; len <= n; len <<= 1) {
         const float angle = -two_pi / static_cast<float>(len);
         const std::complex<float> wlen(std::cos(angle), std::sin(angle));
@@ -34,27 +44,37 @@ static const std::vector<std::vector<std::complex<float>>>& get_or_build_twiddle
         std::vector<std::complex<float>> stage(half);
         std::complex<float> w(1.0f, 0.0f);
         for (int k = 0; k < half; ++k) { stage[k] = w; w *= wlen; }
-        stages.push_back(std::move(stage));
+        t->twiddles.push_back(std::move(stage));
     }
-    auto [ins, _] = g_twiddles.emplace(n, std::move(stages));
-    return ins->second;
+    g_tables[bits].store(t, std::memory_order_release);
+    return *t;
+}
+
+const Tables& tables_for(int n) {
+    if (const Tables* t = g_tables[log2_size(n)].load(std::memory_order_acquire)) return *t;
+    return build_tables(n);
+}
+}
+
+void prepare_fft(int n) {
+    if (n > 1) tables_for(n);
 }
 
 void compute_fft_inplace(std::vector<std::complex<float>>& data) {
     const int n = static_cast<int>(data.size());
     if (n <= 1) return;
+    const Tables& tables = tables_for(n);
 
-    // Bit-reversal
-    const auto& br = get_or_build_bitrev(n);
-    std::vector<std::complex<float>> tmp(n);
-    for (int i = 0; i < n; ++i) tmp[br[i]] = data[i];
-    data.swap(tmp);
+    // Bit-reversal, in place
+    const std::vector<int>& br = tables.bitrev;
+    for (int i = 0; i < n; ++i) {
+        if (i < br[i]) std::swap(data[i], data[br[i]]);
+    }
 
     // Iterative radix-2
-    const auto& stages = get_or_build_twiddles(n);
     int stageIndex = 0;
     for (int len = 2; len <= n; len <<= 1, ++stageIndex) {
-        const auto& W = stages[stageIndex];
+        const auto& W = tables.twiddles[stageIndex];
         for (int i = 0; i < n; i += len) {
             for (int k = 0; k < len / 2; ++k) {
                 const auto u = data[i + k];
@@ -67,5 +87,3 @@ void compute_fft_inplace(std::vector<std::complex<float>>& data) {
 }
 
 } // namespace tuner::fft
-
-
@@ -0,0 +1,307 @@
+#include "key_channelizer.hpp"
+
+#include "fft/fft_utils.hpp"
+#include "piano_synth.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+
+namespace tuner {
+
+namespace {
+constexpr float TOP_HZ = 4200.0f;        // the highest fundamental (C8) must pass the first tier
+constexpr int FRONT_MAX_FACTOR = 16;
+constexpr int TIER_FACTOR = 4;           // each tier two octaves below the one before
+constexpr float PASSBAND_FRACTION = 0.4f;  // of a tier's rate (PreDecimator)
+constexpr float FLOOR_DB = -120.0f;
+constexpr float SMOOTHING = 0.25f;       // per frame, of the power onsets are detected on
+constexpr float LOW_CREEP_DB = 0.25f;    // per frame, how fast an onset's reference low rises
+constexpr float THUMP_SECONDS = 0.2f;    // longest a hammer's thump still counts in a channel
+constexpr int STRONG_PARTIALS = 4;       // a lower key's partials that settle whether it explains a rise
+constexpr float RISE_DELAY = 0.4f;       // of a prototype's length, from a strike until its rise shows
+constexpr float RISE_SLACK = 0.125f;     // of a prototype's length, how much later one partial's rise may show
+}
+
+KeyChannelizer::KeyChannelizer(const KeyChannelizerConfig& config) : cfg(config) {}
+
+void KeyChannelizer::set_config(const KeyChannelizerConfig& config) {
+    cfg = config;
+    rate = 0;  // rebuilt on the next push
+    reset();
+}
+
+void KeyChannelizer::reset() {
+    for (Tier& tier : tiers) {
+        tier.decimator.reset();
+        tier.history.clear();
+        // Start from silence, so frames run from the first block
+        tier.out.assign(prototype.size(), 0.0f);
+        tier.history.push(tier.out.data(), tier.out.size());
+        tier.since_frame = 0;
+        tier.primed = false;
+    }
+    for (KeyState& s : key_state) {
+        s.smooth = 0.0f;
+        s.low_db = FLOOR_DB;
+        s.hold = 0;
+        s.above = 0;
+        s.struck_at = -1e9;
+        s.rising_since = -1.0;
+        s.pending = false;
+    }
+    bands.fill(KeyBand{});
+    clock = 0;
+}
+
+void KeyChannelizer::configure(unsigned int sample_rate) {
+    rate = sample_rate;
+    int m = 16;
+    while (m < cfg.channels && m < 4096) m <<= 1;
+    cfg.channels = m;
+    cfg.taps_per_channel = std::clamp(cfg.taps_per_channel, 1, 16);
+    const int length = m * cfg.taps_per_channel;
+
+    // Windowed-sinc lowpass cutting off half a channel out: neighbouring
+    // channels cross at -6 dB. Blackman, so a loud key leaks little into
+    // keys a few channels away.
+    prototype.resize(static_cast<size_t>(length));
+    double sum = 0.0;
+    for (int n = 0; n < length; ++n) {
+        const double t = (n - 0.5 * (length - 1)) / m;
+        const double sinc = t == 0.0 ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+        const double a = 2.0 * M_PI * n / (length - 1);
+        const double w = 0.42 - 0.5 * std::cos(a) + 0.08 * std::cos(2.0 * a);
+        prototype[static_cast<size_t>(n)] = static_cast<float>(sinc * w);
+        sum += sinc * w;
+    }
+    gain = static_cast<float>(2.0 / sum);
+    folded.resize(static_cast<size_t>(m));
+    channel_mag.assign(static_cast<size_t>(m / 2 + 1), 0.0f);
+    channel_hz.assign(static_cast<size_t>(m / 2 + 1), 0.0f);
+
+    double in_rate = sample_rate;
+    for (int t = 0; t < NUM_TIERS; ++t) {
+        Tier& tier = tiers[static_cast<size_t>(t)];
+        const int factor = t == 0 ? PreDecimator::factor_for(static_cast<int>(sample_rate), TOP_HZ, FRONT_MAX_FACTOR)
+                                  : TIER_FACTOR;
+        tier.decimator.configure(static_cast<int>(std::lround(in_rate)), factor);
+        tier.rate = static_cast<float>(in_rate / tier.decimator.factor());
+        in_rate = tier.rate;
+        tier.history.allocate(static_cast<size_t>(length));
+        tier.last_phase.assign(static_cast<size_t>(m / 2 + 1), 0.0f);
+        tier.first_key = tier.end_key = 0;
+        const int hop = m / 2;
+        tier.confirm_frames = std::max(1, static_cast<int>(std::ceil(THUMP_SECONDS * tier.rate / hop)));
+        tier.hop_seconds = static_cast<float>(hop) / tier.rate;
+        tier.lag = RISE_DELAY * static_cast<float>(length) / tier.rate;
+        tier.spread = 0.5f * static_cast<float>(length) / tier.rate;
+        tier.latency = tier.spread + static_cast<float>(tier.confirm_frames) * tier.hop_seconds;
+    }
+
+    // Each key from the lowest-rate tier whose passband holds its band
+    const float half_step = std::pow(2.0f, 1.0f / 24.0f);
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        const float f = cfg.a4_hz * std::pow(2.0f, (key - 48) / 12.0f);
+        int t = NUM_TIERS - 1;
+        while (t > 0 && f * half_step > PASSBAND_FRACTION * tiers[static_cast<size_t>(t)].rate) --t;
+        Tier& tier = tiers[static_cast<size_t>(t)];
+        if (tier.end_key == 0) tier.first_key = key;
+        tier.end_key = key + 1;
+        const float spacing = tier.rate / static_cast<float>(m);
+        KeyState& s = key_state[static_cast<size_t>(key)];
+        s.lo_hz = f / half_step;
+        s.hi_hz = f * half_step;
+        s.lo = std::clamp(static_cast<int>(std::lround(f / half_step / spacing)), 1, m / 2 - 1);
+        s.hi = std::clamp(static_cast<int>(std::lround(f * half_step / spacing)), s.lo, m / 2 - 1);
+        s.tier = t;
+    }
+
+    // Which keys hold a partial (2 .. max_partials) of each key
+    const float tol = std::pow(2.0f, cfg.partial_tolerance_cents / 1200.0f);
+    std::array<std::bitset<NUM_KEYS>, NUM_KEYS> partial_keys{};
+    std::array<std::bitset<NUM_KEYS>, NUM_KEYS> strong_keys{};  // the key itself and its partials 2 .. STRONG_PARTIALS
+    for (int lower = 0; lower < NUM_KEYS; ++lower) {
+        const double f1 = cfg.a4_hz * std::pow(2.0, (lower - 48) / 12.0);
+        const double B = typical_inharmonicity(lower + 21);
+        strong_keys[static_cast<size_t>(lower)].set(static_cast<size_t>(lower));
+        for (int k = 2; k <= cfg.max_partials; ++k) {
+            const float f = static_cast<float>(piano_partial_frequency(f1, B, k));
+            for (int key = lower + 1; key < NUM_KEYS; ++key) {
+                const KeyState& s = key_state[static_cast<size_t>(key)];
+                if (f < s.lo_hz / tol || f >= s.hi_hz * tol) continue;
+                partial_keys[static_cast<size_t>(lower)].set(static_cast<size_t>(key));
+                if (k <= STRONG_PARTIALS) strong_keys[static_cast<size_t>(lower)].set(static_cast<size_t>(key));
+            }
+        }
+    }
+    // A rise on a key is a lower key's partial if that key rose with it, or
+    // one of its strongest partials that is not among this key's own. The
+    // rise waits for each lower key until the first of these has had time to
+    // show the strike, a late rise's allowance included.
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        KeyState& s = key_state[static_cast<size_t>(key)];
+        const float own = tiers[static_cast<size_t>(s.tier)].latency;
+        s.evidence.reset();
+        s.wait = 0.0f;
+        for (int lower = 0; lower < key; ++lower) {
+            if (!partial_keys[static_cast<size_t>(lower)].test(static_cast<size_t>(key))) continue;
+            std::bitset<NUM_KEYS> ev = strong_keys[static_cast<size_t>(lower)] & ~partial_keys[static_cast<size_t>(key)];
+            ev.reset(static_cast<size_t>(key));
+            float first = 1e9f;
+            for (int e = 0; e < NUM_KEYS; ++e) {
+                if (!ev.test(static_cast<size_t>(e))) continue;
+                const Tier& t = tiers[static_cast<size_t>(key_state[static_cast<size_t>(e)].tier)];
+                first = std::min(first, t.latency + t.hop_seconds + RISE_SLACK * 2.0f * t.spread);
+            }
+            s.evidence |= ev;
+            s.wait = std::max(s.wait, first - own);
+        }
+    }
+    reset();
+}
+
+void KeyChannelizer::push(const float* input, int num_samples, unsigned int sample_rate) {
+    if (!input || num_samples <= 0 || sample_rate == 0) return;
+    if (sample_rate != rate) configure(sample_rate);
+    const int hop = cfg.channels / 2;
+    const size_t length = prototype.size();
+    const float* in = input;
+    int count = num_samples;
+    clock += static_cast<uint64_t>(num_samples);
+    for (Tier& tier : tiers) {
+        tier.out.resize(static_cast<size_t>(tier.decimator.max_output(count)));
+        count = tier.decimator.process(in, count, tier.out.data());
+        in = tier.out.data();
+        // A frame exactly every hop samples, however the block falls, so
+        // the phase advance between frames is always over one hop
+        for (int i = 0; i < count;) {
+            const int n = std::min(count - i, hop - tier.since_frame);
+            tier.history.push(in + i, static_cast<size_t>(n));
+            tier.since_frame += n;
+            i += n;
+            if (tier.since_frame < hop) break;
+            tier.since_frame = 0;
+            if (tier.history.size() >= length) run_frame(tier);
+        }
+    }
+    resolve_onsets();
+}
+
+void KeyChannelizer::run_frame(Tier& tier) {
+    const int m = cfg.channels;
+    const int taps = cfg.taps_per_channel;
+    const float* x = tier.history.latest(prototype.size());
+    for (int i = 0; i < m; ++i) {
+        float v = 0.0f;
+        for (int p = 0; p < taps; ++p) v += prototype[static_cast<size_t>(i + p * m)] * x[i + p * m];
+        folded[static_cast<size_t>(i)] = {v, 0.0f};
+    }
+    fft::compute_fft_inplace(folded);
+
+    // Each channel advances by pi c per hop of channels / 2 at its centre;
+    // what it gains beyond that, up to ±pi, places the tone within ±1 channel
+    const float spacing = tier.rate / static_cast<float>(m);
+    for (int c = 0; c <= m / 2; ++c) {
+        const std::complex<float> z = folded[static_cast<size_t>(c)];
+        const float phase = std::arg(z);
+        channel_mag[static_cast<size_t>(c)] = gain * std::abs(z);
+        channel_hz[static_cast<size_t>(c)] = 0.0f;
+        if (tier.primed) {
+            const float advance = phase - tier.last_phase[static_cast<size_t>(c)] - static_cast<float>(M_PI) * c;
+            const float wrapped = std::remainder(advance, static_cast<float>(2.0 * M_PI));
+            channel_hz[static_cast<size_t>(c)] = (static_cast<float>(c) + wrapped / static_cast<float>(M_PI)) * spacing;
+        }
+        tier.last_phase[static_cast<size_t>(c)] = phase;
+    }
+
+    // A channel must be a peak among its neighbours. Where the channels are
+    // wide enough for a low note's partials to fall in neighbouring ones, a
+    // louder neighbour carrying another tone does not hide it: both channels
+    // then read a frequency within half a channel of their centre.
+    const bool crowded = 2.0f * spacing > cfg.a4_hz / 16.0f;
+    const auto centred = [&](int c) {
+        return std::fabs(channel_hz[static_cast<size_t>(c)] - static_cast<float>(c) * spacing) < 0.5f * spacing;
+    };
+    const auto masked = [&](int c, int n) {
+        return channel_mag[static_cast<size_t>(n)] > channel_mag[static_cast<size_t>(c)] &&
+               !(crowded && centred(c) && centred(n));
+    };
+    for (int key = tier.first_key; key < tier.end_key; ++key) {
+        KeyState& s = key_state[static_cast<size_t>(key)];
+        KeyBand& band = bands[static_cast<size_t>(key)];
+        float best = 0.0f;
+        band.hz = 0.0f;
+        for (int c = std::max(1, s.lo - 1); c <= std::min(m / 2 - 1, s.hi + 1); ++c) {
+            const float hz = channel_hz[static_cast<size_t>(c)];
+            const float mag = channel_mag[static_cast<size_t>(c)];
+            if (hz >= s.lo_hz && hz < s.hi_hz && mag > best && !masked(c, c - 1) && !masked(c, c + 1)) {
+                best = mag;
+                band.hz = hz;
+            }
+        }
+        band.level_db = std::max(FLOOR_DB, 20.0f * std::log10(std::max(1e-30f, best)));
+
+        // Onset: the level, and the level smoothed, staying onset_rise_db
+        // over the smoothed level's recent low for confirm_frames. Smoothed
+        // in power, because noise alone dips deep for a frame or two; the
+        // low creeps up so that the deepest dip does not stay the reference.
+        // Staying, because a hammer's thump lifts every band for a moment:
+        // for THUMP_SECONDS, and at least a frame. The level climbs for about
+        // a prototype length after a strike, and the low follows it that
+        // long. The strike is timed from where the rise began out of the
+        // noise, RISE_DELAY back: a partial's beats can hold off the
+        // confirmation.
+        s.smooth += SMOOTHING * (best * best - s.smooth);
+        const float smooth_db = std::max(FLOOR_DB, 10.0f * std::log10(std::max(1e-30f, s.smooth)));
+        const double now = static_cast<double>(clock) / rate;
+        if (s.hold > 0) {
+            s.low_db = smooth_db;
+            --s.hold;
+        } else {
+            s.low_db = std::min(s.low_db + LOW_CREEP_DB, smooth_db);
+            const bool lifted = std::min(smooth_db, band.level_db) - s.low_db >= cfg.onset_rise_db;
+            const bool risen = lifted && smooth_db >= cfg.onset_min_db;
+            s.above = risen ? s.above + 1 : 0;
+            const bool audible = smooth_db >= cfg.onset_min_db - cfg.onset_rise_db;
+            if (lifted && audible && s.rising_since < 0.0) s.rising_since = now;
+            else if (!audible || smooth_db - s.low_db < 0.5f * cfg.onset_rise_db) s.rising_since = -1.0;
+            if (s.above >= tier.confirm_frames) {
+                // Counted once no lower key's partial explains it
+                s.struck_at = s.rising_since - tier.lag;
+                s.decide_at = now + s.wait;
+                s.pending = true;
+                s.rising_since = -1.0;
+                s.above = 0;
+                s.hold = 2 * taps;
+            }
+        }
+    }
+    tier.primed = true;
+}
+
+void KeyChannelizer::resolve_onsets() {
+    const double now = static_cast<double>(clock) / rate;
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        KeyState& s = key_state[static_cast<size_t>(key)];
+        if (!s.pending) continue;
+        // Rose at about the same time: strike estimates within the slower tier's spread
+        const auto with = [&](int e) {
+            const KeyState& other = key_state[static_cast<size_t>(e)];
+            const float spread = std::max(tiers[static_cast<size_t>(other.tier)].spread, tiers[static_cast<size_t>(s.tier)].spread);
+            return std::fabs(other.struck_at - s.struck_at) <= spread;
+        };
+        bool explained = false;
+        for (int e = 0; e < NUM_KEYS && !explained; ++e) {
+            explained = s.evidence.test(static_cast<size_t>(e)) && with(e);
+        }
+        if (explained) {
+            s.pending = false;
+        } else if (now >= s.decide_at) {
+            s.pending = false;
+            ++bands[static_cast<size_t>(key)].onsets;
+        }
+    }
+}
+
+} // namespace tuner
@@ -0,0 +1,145 @@
+#include "latency_calibrator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+namespace tuner {
+
+LatencyCalibrator::LatencyCalibrator(const AudioConfig& base, CalibrationOptions opts, Factory f)
+    : base_config(base), options(std::move(opts)), factory(std::move(f)) {
+    // Non-device sources must be paced like a device to produce meaningful numbers
+    base_config.playback_mode = PlaybackMode::Realtime;
+    base_config.loop_playback = true;
+}
+
+CalibrationResult LatencyCalibrator::run(const IAudioInput::ProcessCallback& process,
+                                         const ProgressCallback& progress,
+                                         const std::atomic<bool>* cancel) {
+    std::vector<std::pair<unsigned int, unsigned int>> candidates;
+    for (unsigned int ps : options.period_sizes) {
+        for (unsigned int np : options.period_counts) {
+            if (ps > 0 && np >= 2) candidates.emplace_back(ps, np);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    CalibrationResult result;
+    const int total = static_cast<int>(candidates.size());
+    for (int i = 0; i < total; ++i) {
+        if (cancel && cancel->load()) break;
+        CalibrationTrial trial = run_trial(candidates[i].first, candidates[i].second, process, cancel);
+        if (cancel && cancel->load()) break;
+        result.trials.push_back(trial);
+        if (progress) progress(trial, i, total);
+        if (trial.stable && (!result.found || trial.latency_ms < result.best_trial.latency_ms)) {
+            result.found = true;
+            result.best = trial.negotiated;
+            result.best_trial = trial;
+        }
+        if (result.found && options.stop_at_first_stable) break;
+    }
+    return result;
+}
+
+CalibrationTrial LatencyCalibrator::run_trial(unsigned int period_size, unsigned int num_periods,
+                                              const IAudioInput::ProcessCallback& process,
+                                              const std::atomic<bool>* cancel) {
+    using clock = std::chrono::steady_clock;
+
+    CalibrationTrial trial;
+    trial.period_size = period_size;
+    trial.num_periods = num_periods;
+
+    AudioConfig cfg = base_config;
+    cfg.period_size = period_size;
+    cfg.num_periods = num_periods;
+    auto input = factory(cfg);
+    if (!input) return trial;
+
+    // Only touched on the audio thread until stop() joins it
+    struct Meter {
+        clock::time_point measure_from;
+        int callbacks = 0;
+        long long frames = 0;
+        double sum_ms = 0.0;
+        double max_ms = 0.0;
+    } meter;
+    meter.measure_from = clock::now() + std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<float>(options.warmup_seconds));
+
+    input->set_process_callback([&](const float* in, int n) {
+        auto t0 = clock::now();
+        if (process) process(in, n);
+        auto t1 = clock::now();
+        if (t0 < meter.measure_from) return;
+        const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        meter.callbacks++;
+        meter.frames += n;
+        meter.sum_ms += ms;
+        meter.max_ms = std::max(meter.max_ms, ms);
+    });
+
+    if (!input->start()) return trial;
+    trial.started = true;
+    trial.negotiated = input->get_config();
+
+    auto sleep_checked = [&](float seconds) {
+        const auto until = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<float>(seconds));
+        while (clock::now() < until && !(cancel && cancel->load())) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    };
+    sleep_checked(options.warmup_seconds);
+    const int xruns_before = input->get_latency_stats().xruns;
+    sleep_checked(options.trial_seconds);
+    trial.xruns = input->get_latency_stats().xruns - xruns_before;
+    input->stop();
+
+    const AudioConfig& neg = trial.negotiated;
+    const float period_ms = 1000.0f * static_cast<float>(neg.period_size) / static_cast<float>(std::max(1u, neg.sample_rate));
+    trial.latency_ms = period_ms;
+    trial.callbacks = meter.callbacks;
+    if (meter.callbacks > 0 && period_ms > 0.0f) {
+        trial.avg_load = static_cast<float>(meter.sum_ms / meter.callbacks) / period_ms;
+        trial.peak_load = static_cast<float>(meter.max_ms) / period_ms;
+    }
+
+    // A device that silently stops delivering is not stable either
+    const double expected = options.trial_seconds * neg.sample_rate;
+    const bool delivered = meter.frames >= static_cast<long long>(0.8 * expected);
+    const float peak_limit = options.max_peak_headroom * static_cast<float>(std::max(1u, neg.num_periods - 1));
+    trial.stable = delivered && trial.xruns <= options.max_xruns &&
+                   trial.avg_load <= options.max_avg_load && trial.peak_load <= peak_limit;
+    return trial;
+}
+
+void store_audio_profile(AppSettings& settings, const std::string& device, const CalibrationTrial& trial) {
+    AudioDeviceProfile prof;
+    prof.device = device;
+    prof.sample_rate = trial.negotiated.sample_rate;
+    prof.period_size = trial.negotiated.period_size;
+    prof.num_periods = trial.negotiated.num_periods;
+    prof.avg_load = trial.avg_load;
+    prof.peak_load = trial.peak_load;
+    for (auto& p : settings.audio_profiles) {
+        if (p.device == device) { p = prof; return; }
+    }
+    settings.audio_profiles.push_back(prof);
+}
+
+bool apply_audio_profile(const AppSettings& settings, AudioConfig& config) {
+    for (const auto& p : settings.audio_profiles) {
+        if (p.device != config.device_name) continue;
+        config.sample_rate = p.sample_rate;
+        config.period_size = p.period_size;
+        config.num_periods = p.num_periods;
+        return true;
+    }
+    return false;
+}
+
+} // namespace tuner
@@ -0,0 +1,151 @@
+#include "mirrored_ring.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace tuner {
+
+MirroredRingBuffer::~MirroredRingBuffer() {
+    release();
+}
+
+MirroredRingBuffer::MirroredRingBuffer(MirroredRingBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+MirroredRingBuffer& MirroredRingBuffer::operator=(MirroredRingBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        base = std::exchange(other.base, nullptr);
+        cap = std::exchange(other.cap, 0);
+        map_bytes = std::exchange(other.map_bytes, 0);
+        mirrored = std::exchange(other.mirrored, false);
+        written.store(other.written.exchange(0));
+    }
+    return *this;
+}
+
+bool MirroredRingBuffer::map_mirrored(size_t min_capacity) {
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t bytes = ((min_capacity * sizeof(float) + page - 1) / page) * page;
+
+    int fd = memfd_create("tuner_ring", MFD_CLOEXEC);
+    if (fd < 0) return false;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        close(fd);
+        return false;
+    }
+    // Reserve 2x address space, then map the same pages into both halves
+    void* reserve = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserve == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    char* p = static_cast<char*>(reserve);
+    void* a = mmap(p, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    void* b = mmap(p + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    close(fd);
+    if (a != p || b != p + bytes) {
+        munmap(reserve, 2 * bytes);
+        return false;
+    }
+    base = reinterpret_cast<float*>(p);
+    cap = bytes / sizeof(float);
+    map_bytes = bytes;
+    mirrored = true;
+    return true;
+#else
+    (void)min_capacity;
+    return false;
+#endif
+}
+
+bool MirroredRingBuffer::allocate(size_t min_capacity) {
+    release();
+    if (min_capacity == 0) return false;
+    if (!map_mirrored(min_capacity)) {
+        base = static_cast<float*>(std::calloc(2 * min_capacity, sizeof(float)));
+        if (!base) return false;
+        cap = min_capacity;
+        map_bytes = 2 * min_capacity * sizeof(float);
+        mirrored = false;
+    }
+    clear();
+    return true;
+}
+
+void MirroredRingBuffer::release() {
+    if (base) {
+#if defined(__linux__)
+        if (mirrored) munmap(base, 2 * map_bytes);
+        else std::free(base);
+#else
+        std::free(base);
+#endif
+    }
+    base = nullptr;
+    cap = 0;
+    map_bytes = 0;
+    mirrored = false;
+    written.store(0, std::memory_order_relaxed);
+}
+
+void MirroredRingBuffer::clear() {
+    if (base) std::memset(base, 0, mirrored ? map_bytes : 2 * cap * sizeof(float));
+    written.store(0, std::memory_order_release);
+}
+
+void MirroredRingBuffer::push(const float* data, size_t count) {
+    if (!base || !data || count == 0) return;
+    uint64_t pos = written.load(std::memory_order_relaxed);
+    if (count > cap) {
+        // Only the tail survives anyway
+        pos += count - cap;
+        data += count - cap;
+        count = cap;
+    }
+    const size_t w = static_cast<size_t>(pos % cap);
+    if (mirrored) {
+        // w + count <= 2*cap: the part past the first half lands at the start via the mirror
+        std::memcpy(base + w, data, count * sizeof(float));
+    } else {
+        // Keep both halves identical so any window [s, s+n) with s < cap is contiguous
+        const size_t first = std::min(count, cap - w);
+        std::memcpy(base + w, data, first * sizeof(float));
+        std::memcpy(base + w + cap, data, first * sizeof(float));
+        if (count > first) {
+            std::memcpy(base, data + first, (count - first) * sizeof(float));
+            std::memcpy(base + cap, data + first, (count - first) * sizeof(float));
+        }
+    }
+    written.store(pos + count, std::memory_order_release);
+}
+
+const float* MirroredRingBuffer::window_at(uint64_t end, size_t count) const {
+    if (!base) return nullptr;
+    if (count > cap) count = cap;
+    const size_t start = static_cast<size_t>((end + cap - count) % cap);
+    return base + start;
+}
+
+bool MirroredRingBuffer::still_valid(uint64_t end, size_t count, size_t in_flight) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t now = written.load(std::memory_order_acquire);
+    return count <= cap && now >= end && now - end + count + in_flight <= cap;
+}
+
+size_t MirroredRingBuffer::size() const {
+    const uint64_t w = write_position();
+    return w < cap ? static_cast<size_t>(w) : cap;
+}
+
+} // namespace tuner
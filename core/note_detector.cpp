@@ -0,0 +1,183 @@
+#include "note_detector.hpp"
+
+#include "fft/fft_utils.hpp"
+#include "piano_synth.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tuner {
+
+namespace {
+constexpr float TOP_HZ = 4200.0f;       // the highest fundamental (C8) must pass the front end
+constexpr float FLOOR_HZ = 20.0f;       // the noise floor is taken from here up
+constexpr int FLOOR_BLOCK = 64;         // bins per local noise floor
+constexpr float FLOOR_MARGIN = 4.5f;    // levels count from this far over a block's 25th percentile (~10 dB over noise)
+constexpr int FRONT_MAX_FACTOR = 16;
+}
+
+NoteDetector::NoteDetector(const NoteDetectorConfig& config) : cfg(config) {}
+
+void NoteDetector::set_config(const NoteDetectorConfig& config) {
+    cfg = config;
+    rate = 0;  // rebuilt on the next push
+    reset();
+}
+
+void NoteDetector::reset() {
+    history.clear();
+    front.reset();
+    since_pass = 0;
+    streak = 0;
+    result = NoteDetection{};
+    scores.clear();
+    std::fill(past.begin(), past.end(), std::log(1e-20f));  // the first window rises from silence
+    past_next = 0;
+}
+
+void NoteDetector::configure(unsigned int sample_rate) {
+    rate = sample_rate;
+    const int n = std::max(64, cfg.fft_size);
+    int size = 64;
+    while (size < n && size < (1 << 20)) size <<= 1;
+    cfg.fft_size = size;
+
+    front.configure(static_cast<int>(sample_rate),
+                    PreDecimator::factor_for(static_cast<int>(sample_rate), TOP_HZ, FRONT_MAX_FACTOR));
+    history.allocate(static_cast<size_t>(size));
+
+    const int half = size / 2;
+    window.resize(static_cast<size_t>(size));
+    for (int i = 0; i < size; ++i) {
+        window[static_cast<size_t>(i)] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / size));
+    }
+    packed.resize(static_cast<size_t>(half));
+    twiddle.resize(static_cast<size_t>(half));
+    for (int k = 0; k < half; ++k) twiddle[static_cast<size_t>(k)] = std::polar(1.0f, static_cast<float>(-2.0 * M_PI * k / size));
+    level.assign(static_cast<size_t>(half), 0.0f);
+    rise.assign(static_cast<size_t>(half), 0.0f);
+    // Levels one window back: passes that share no samples with this one
+    const int hop = std::max(1, static_cast<int>(std::lround(cfg.hop_seconds * front.output_rate())));
+    lag = std::max(1, (size + hop - 1) / hop);
+    past.assign(static_cast<size_t>(lag) * static_cast<size_t>(half), 0.0f);
+
+    // Comb per key, up to the front end's passband
+    const float fs = static_cast<float>(front.output_rate());
+    const float df = fs / static_cast<float>(size);
+    const float top = std::min(PreDecimator::passband_hz(static_cast<int>(sample_rate), front.factor()), 0.5f * fs);
+    const float tol = std::pow(2.0f, cfg.partial_tolerance_cents / 1200.0f);
+    band_lo = std::clamp(static_cast<int>(std::ceil(FLOOR_HZ / df)), 1, half - 1);
+    band_hi = std::clamp(static_cast<int>(top / df), band_lo, half - 1);
+    block_floor.assign(static_cast<size_t>((band_hi - band_lo) / FLOOR_BLOCK + 1), 0.0f);
+    partials.clear();
+    key_first.assign(NUM_KEYS + 1, 0);
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        key_first[static_cast<size_t>(key)] = static_cast<int>(partials.size());
+        const double f1 = cfg.a4_hz * std::pow(2.0, (key - 48) / 12.0);
+        const double B = typical_inharmonicity(key + 21);
+        for (int k = 1; k <= std::max(1, cfg.max_partials); ++k) {
+            const float f = static_cast<float>(piano_partial_frequency(f1, B, k));
+            if (f > top) break;
+            Partial p;
+            p.lo = std::clamp(static_cast<int>(std::lround(f / tol / df)), band_lo, band_hi);
+            p.hi = std::clamp(static_cast<int>(std::lround(f * tol / df)), p.lo, band_hi);
+            p.weight = 1.0f / static_cast<float>(k);
+            partials.push_back(p);
+        }
+    }
+    key_first[NUM_KEYS] = static_cast<int>(partials.size());
+    reset();
+}
+
+bool NoteDetector::push(const float* input, int num_samples, unsigned int sample_rate) {
+    if (!input || num_samples <= 0 || sample_rate == 0) return false;
+    if (sample_rate != rate) configure(sample_rate);
+    front_out.resize(static_cast<size_t>(front.max_output(num_samples)));
+    const int produced = front.process(input, num_samples, front_out.data());
+    history.push(front_out.data(), static_cast<size_t>(produced));
+    since_pass += produced;
+
+    const int hop = std::max(1, static_cast<int>(std::lround(cfg.hop_seconds * front.output_rate())));
+    if (since_pass < hop || history.size() < static_cast<size_t>(cfg.fft_size)) return false;
+    since_pass = std::min(since_pass - hop, hop - 1);
+    run_pass();
+    return true;
+}
+
+void NoteDetector::run_pass() {
+    const int n = cfg.fft_size;
+    const int half = n / 2;
+    const float* x = history.latest(static_cast<size_t>(n));
+    for (int i = 0; i < half; ++i) {
+        packed[static_cast<size_t>(i)] = {x[2 * i] * window[static_cast<size_t>(2 * i)],
+                                          x[2 * i + 1] * window[static_cast<size_t>(2 * i + 1)]};
+    }
+    fft::compute_fft_inplace(packed);
+
+    // Unpack the real spectrum: X[k] = E[k] + W^k O[k], where E and O are the
+    // transforms of the even and odd samples
+    for (int k = band_lo; k <= band_hi; ++k) {
+        const std::complex<float> zk = packed[static_cast<size_t>(k)];
+        const std::complex<float> zc = std::conj(packed[static_cast<size_t>(half - k)]);
+        const std::complex<float> even = 0.5f * (zk + zc);
+        const std::complex<float> odd = std::complex<float>(0.0f, -0.5f) * (zk - zc);
+        level[static_cast<size_t>(k)] = std::abs(even + twiddle[static_cast<size_t>(k)] * odd);
+    }
+
+    // Log level over the local floor: a low percentile of each block of
+    // bins, interpolated between block centres. A percentile, because
+    // bass partials fill much of a block; local, because a strike's thump
+    // lifts the low band more than the rest. Then how far each bin rose
+    // since the window before, which a ringing note does not. That is of
+    // the magnitude itself, so a lifted floor cannot make ringing partials
+    // dip and then rise against it.
+    const int blocks = static_cast<int>(block_floor.size());
+    for (int b = 0; b < blocks; ++b) {
+        const int k0 = band_lo + b * FLOOR_BLOCK;
+        scratch.assign(level.begin() + k0, level.begin() + std::min(band_hi + 1, k0 + FLOOR_BLOCK));
+        const size_t q = scratch.size() / 4;
+        std::nth_element(scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(q), scratch.end());
+        block_floor[static_cast<size_t>(b)] = std::log(FLOOR_MARGIN * std::max(1e-20f, scratch[q]));
+    }
+    float* before = past.data() + static_cast<size_t>(past_next) * static_cast<size_t>(half);
+    for (int k = band_lo; k <= band_hi; ++k) {
+        const float pos = std::clamp(static_cast<float>(k - band_lo) / FLOOR_BLOCK - 0.5f, 0.0f,
+                                     static_cast<float>(blocks - 1));
+        const int b = std::min(static_cast<int>(pos), blocks - 1);
+        const float t = pos - static_cast<float>(b);
+        const float floor = b + 1 < blocks ? (1.0f - t) * block_floor[static_cast<size_t>(b)] +
+                                                 t * block_floor[static_cast<size_t>(b) + 1]
+                                           : block_floor[static_cast<size_t>(b)];
+        float& v = level[static_cast<size_t>(k)];
+        const float log_mag = std::log(std::max(1e-20f, v));
+        v = std::max(0.0f, log_mag - floor);
+        rise[static_cast<size_t>(k)] = std::clamp(log_mag - before[k], 0.0f, v);
+        before[k] = log_mag;
+    }
+    past_next = (past_next + 1) % lag;
+
+    scores.assign(NUM_KEYS, 0.0f);
+    int best = 0;
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        float s = 0.0f;
+        for (int i = key_first[static_cast<size_t>(key)]; i < key_first[static_cast<size_t>(key) + 1]; ++i) {
+            const Partial& p = partials[static_cast<size_t>(i)];
+            s += p.weight * *std::max_element(rise.begin() + p.lo, rise.begin() + p.hi + 1);
+        }
+        scores[static_cast<size_t>(key)] = s;
+        if (s > scores[static_cast<size_t>(best)]) best = key;
+    }
+
+    const int candidate = scores[static_cast<size_t>(best)] >= cfg.min_score ? best : -1;
+    streak = candidate >= 0 && candidate == result.candidate ? streak + 1 : (candidate >= 0 ? 1 : 0);
+    result.candidate = candidate;
+    result.score = scores[static_cast<size_t>(best)];
+    // Once per strike: the streak goes on while the new key keeps rising
+    if (candidate >= 0 && streak == std::max(1, cfg.confirm_passes)) {
+        result.key = candidate;
+        ++result.strikes;
+    }
+    ++result.passes;
+}
+
+} // namespace tuner
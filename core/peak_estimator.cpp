@@ -0,0 +1,119 @@
+#include "peak_estimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace tuner {
+
+namespace {
+
+// Spectrum of the window, in bins of an N-point FFT, with its linear phase
+// removed (real): rectangular S(u) = sin(pi u L / N) / sin(pi u / N); the Hann
+// window 0.5 - 0.5 cos(2 pi n / (L - 1)) adds two copies shifted by N / (L - 1)
+struct WindowKernel {
+    double length;
+    double size;
+    bool hann;
+
+    double dirichlet(double u) const {
+        const double d = std::sin(M_PI * u / size);
+        if (std::fabs(d) < 1e-12) return length;
+        return std::sin(M_PI * u * length / size) / d;
+    }
+    double operator()(double u) const {
+        if (!hann) return dirichlet(u);
+        const double a = size / std::max(1.0, length - 1.0);
+        return 0.5 * dirichlet(u) + 0.25 * dirichlet(u - a) + 0.25 * dirichlet(u + a);
+    }
+    // Re[(Y+ - Y-) / Y0] for a tone `delta` bins above the centre bin
+    double ratio(double delta) const {
+        return ((*this)(1.0 - delta) - (*this)(-1.0 - delta)) / (*this)(-delta);
+    }
+    // Jacobsen's ratio Re[(Y+ - Y-) / (2 Y0 - Y- - Y+)] for the same tone
+    double jacobsen_ratio(double delta) const {
+        const double km = (*this)(-1.0 - delta), k0 = (*this)(-delta), kp = (*this)(1.0 - delta);
+        return (kp - km) / (2.0 * k0 - km - kp);
+    }
+};
+
+// Bin k with the window's linear phase exp(-j pi k (L - 1) / N) removed, so
+// the three bins around a peak differ only by the real kernel
+std::complex<double> align(const std::complex<float>& x, int k, int window_length, int fft_size) {
+    const long long n2 = 2LL * fft_size;
+    const long long m = ((static_cast<long long>(k) * (window_length - 1)) % n2 + n2) % n2;
+    return std::complex<double>(x) * std::polar(1.0, M_PI * static_cast<double>(m) / fft_size);
+}
+
+} // namespace
+
+const char* peak_estimator_name(PeakEstimator method) {
+    switch (method) {
+    case PeakEstimator::Grid: return "grid";
+    case PeakEstimator::QuadraticLog: return "qlog";
+    case PeakEstimator::Jacobsen: return "jacobsen";
+    case PeakEstimator::WindowCorrected: return "window";
+    }
+    return "?";
+}
+
+bool parse_peak_estimator(const char* name, PeakEstimator& out) {
+    for (PeakEstimator m : {PeakEstimator::Grid, PeakEstimator::QuadraticLog, PeakEstimator::Jacobsen,
+                            PeakEstimator::WindowCorrected}) {
+        if (std::strcmp(name, peak_estimator_name(m)) == 0) {
+            out = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+float peak_offset(PeakEstimator method, const std::complex<float> bins[3], int k, int window_length, int fft_size,
+                  bool hann) {
+    if (method == PeakEstimator::Grid || window_length < 2 || fft_size < 3) return 0.0f;
+
+    if (method == PeakEstimator::QuadraticLog) {
+        const double lm = std::log(std::max(1e-30, static_cast<double>(std::abs(bins[0]))));
+        const double l0 = std::log(std::max(1e-30, static_cast<double>(std::abs(bins[1]))));
+        const double lp = std::log(std::max(1e-30, static_cast<double>(std::abs(bins[2]))));
+        const double den = lm - 2.0 * l0 + lp;
+        if (!(den < 0.0)) return 0.0f;  // not a maximum
+        return static_cast<float>(std::clamp(0.5 * (lm - lp) / den, -1.0, 1.0));
+    }
+
+    const std::complex<double> ym = align(bins[0], k - 1, window_length, fft_size);
+    const std::complex<double> y0 = align(bins[1], k, window_length, fft_size);
+    const std::complex<double> yp = align(bins[2], k + 1, window_length, fft_size);
+    if (std::abs(y0) <= 0.0) return 0.0f;
+    const WindowKernel kernel{static_cast<double>(window_length), static_cast<double>(fft_size), hann};
+
+    // Jacobsen's ratio is proportional to the offset for small offsets; the
+    // factor depends on the window and the zero padding, so take it from the
+    // kernel at a quarter bin
+    const std::complex<double> jden = 2.0 * y0 - ym - yp;
+    double delta = 0.0;
+    if (std::abs(jden) > 0.0) {
+        const double q = 0.25 / kernel.jacobsen_ratio(0.25);
+        delta = std::clamp(q * std::real((yp - ym) / jden), -0.75, 0.75);
+    }
+    if (method == PeakEstimator::Jacobsen) return static_cast<float>(delta);
+
+    // WindowCorrected: solve kernel.ratio(delta) = measured ratio, which rises
+    // monotonically over the main lobe. Newton from Jacobsen's estimate, kept
+    // inside a shrinking bracket.
+    const double r = std::real((yp - ym) / y0);
+    double lo = -0.75, hi = 0.75;
+    for (int it = 0; it < 8; ++it) {
+        const double g = kernel.ratio(delta) - r;
+        if (std::fabs(g) < 1e-9) break;
+        if (g > 0.0) hi = delta; else lo = delta;
+        const double h = 1e-4;
+        const double slope = (kernel.ratio(delta + h) - kernel.ratio(delta - h)) / (2.0 * h);
+        double next = slope > 0.0 ? delta - g / slope : 0.5 * (lo + hi);
+        if (!(next > lo && next < hi)) next = 0.5 * (lo + hi);
+        delta = next;
+    }
+    return static_cast<float>(delta);
+}
+
+} // namespace tuner
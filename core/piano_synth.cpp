@@ -0,0 +1,238 @@
+#include "piano_synth.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <random>
+
+namespace tuner {
+
+namespace {
+
+// std::*_distribution output is implementation defined; derive everything from
+// the raw mt19937 stream so a seed renders the same buffer on every platform
+struct SynthRng {
+    explicit SynthRng(uint32_t seed) : gen(seed) {}
+    double uniform() { return (static_cast<double>(gen() >> 5) + 0.5) * (1.0 / 134217728.0); }  // (0,1)
+    double gaussian() {
+        if (have_spare) { have_spare = false; return spare; }
+        const double u1 = uniform(), u2 = uniform();
+        const double r = std::sqrt(-2.0 * std::log(u1));
+        spare = r * std::sin(2.0 * M_PI * u2);
+        have_spare = true;
+        return r * std::cos(2.0 * M_PI * u2);
+    }
+    std::mt19937 gen;
+    double spare = 0.0;
+    bool have_spare = false;
+};
+
+void render_note(const PianoNoteSpec& note, int sample_rate, SynthRng& rng, std::vector<float>& out,
+                 PianoNoteTruth& truth) {
+    const int total = static_cast<int>(out.size());
+    const int start = std::max(0, static_cast<int>(std::lround(note.onset_s * sample_rate)));
+    truth.f1 = note.f1;
+    truth.B = note.B;
+    truth.onset_s = static_cast<float>(start) / sample_rate;
+    truth.partial_hz.clear();
+    if (start >= total || note.f1 <= 0.0f) return;
+
+    const int strings = std::max(1, std::min(3, note.unison_strings));
+    const double fs = static_cast<double>(sample_rate);
+    const int attack = std::max(1, sample_rate / 2000);  // 0.5 ms raised-cosine onset
+    std::vector<double> partial(static_cast<size_t>(total - start), 0.0);
+
+    for (int k = 1; k <= note.num_partials; ++k) {
+        const double fk = piano_partial_frequency(note.f1, note.B, k);
+        if (fk >= 0.45 * fs) break;
+        truth.partial_hz.push_back(static_cast<float>(fk));
+
+        const double amp = note.amplitude / std::pow(static_cast<double>(k), note.rolloff) / strings;
+        const double tau = note.decay_s / (1.0 + note.decay_slope * (k - 1));
+        const double env_step = tau > 0.0 ? std::exp(-1.0 / (tau * fs)) : 0.0;
+
+        for (int s = 0; s < strings; ++s) {
+            // Strings spread symmetrically (in cents) around the partial
+            const double offset = strings == 1 ? 0.0
+                : note.unison_detune_cents * (static_cast<double>(s) / (strings - 1) - 0.5);
+            const double f = fk * std::pow(2.0, offset / 1200.0);
+            const double phase0 = 2.0 * M_PI * rng.uniform();
+            const std::complex<double> w = std::polar(1.0, 2.0 * M_PI * f / fs);
+            std::complex<double> z = std::polar(1.0, phase0);
+            double env = amp;
+            for (size_t i = 0; i < partial.size(); ++i) {
+                partial[i] += env * z.imag();
+                z *= w;
+                env *= env_step;
+                if ((i & 1023) == 1023) z /= std::abs(z);
+            }
+        }
+    }
+
+    // Hammer thump: low-passed noise burst with a fast exponential decay
+    if (note.hammer_noise > 0.0f && note.hammer_noise_ms > 0.0f) {
+        const double cutoff = std::min(0.2 * fs, std::max(1000.0, 4.0 * note.f1));
+        const double a = std::exp(-2.0 * M_PI * cutoff / fs);
+        const double decay = std::exp(-1000.0 / (note.hammer_noise_ms * fs));
+        const size_t len = std::min(partial.size(), static_cast<size_t>(note.hammer_noise_ms * 8e-3 * fs));
+        double env = note.amplitude * note.hammer_noise, lp = 0.0;
+        for (size_t i = 0; i < len; ++i) {
+            lp = a * lp + (1.0 - a) * rng.gaussian();
+            partial[i] += env * lp * 3.0;  // ~unit RMS after the low-pass at typical cutoffs
+            env *= decay;
+        }
+    }
+
+    for (size_t i = 0; i < partial.size(); ++i) {
+        double g = 1.0;
+        if (static_cast<int>(i) < attack) g = 0.5 - 0.5 * std::cos(M_PI * static_cast<double>(i) / attack);
+        out[start + i] += static_cast<float>(g * partial[i]);
+    }
+}
+
+int parse_note_name(const std::string& s) {
+    if (s.empty()) return -1;
+    if (std::isdigit(static_cast<unsigned char>(s[0]))) return std::atoi(s.c_str());
+    static const int semis[7] = {9, 11, 0, 2, 4, 5, 7};  // A..G
+    const char c = static_cast<char>(std::toupper(static_cast<unsigned char>(s[0])));
+    if (c < 'A' || c > 'G') return -1;
+    int semi = semis[c - 'A'];
+    size_t i = 1;
+    if (i < s.size() && s[i] == '#') { ++semi; ++i; }
+    else if (i < s.size() && s[i] == 'b') { --semi; ++i; }
+    if (i >= s.size()) return -1;
+    char* end = nullptr;
+    const long octave = std::strtol(s.c_str() + i, &end, 10);
+    if (*end != '\0') return -1;
+    return static_cast<int>(12 * (octave + 1) + semi);
+}
+
+} // namespace
+
+double piano_partial_frequency(double f1, double B, int k) {
+    const double kk = static_cast<double>(k);
+    return kk * f1 * std::sqrt(1.0 + B * kk * kk);
+}
+
+float typical_inharmonicity(int midi_note) {
+    // log10(B) at A0, A1, ... A7 and C8; bass strings are wound and sit lowest around A1-A2
+    static const int keys[] = {21, 33, 45, 57, 69, 81, 93, 105, 108};
+    static const float logb[] = {-3.6f, -3.95f, -3.85f, -3.5f, -3.2f, -2.8f, -2.3f, -1.85f, -1.75f};
+    const int n = static_cast<int>(sizeof(keys) / sizeof(keys[0]));
+    if (midi_note <= keys[0]) return std::pow(10.0f, logb[0]);
+    for (int i = 1; i < n; ++i) {
+        if (midi_note <= keys[i]) {
+            const float t = static_cast<float>(midi_note - keys[i - 1]) / static_cast<float>(keys[i] - keys[i - 1]);
+            return std::pow(10.0f, logb[i - 1] + t * (logb[i] - logb[i - 1]));
+        }
+    }
+    return std::pow(10.0f, logb[n - 1]);
+}
+
+std::vector<float> synthesize_piano(const PianoSynthConfig& config, PianoGroundTruth* truth) {
+    const int sample_rate = std::max(1, config.sample_rate);
+    const size_t total = static_cast<size_t>(std::max(0.0f, config.duration_s) * sample_rate);
+    std::vector<float> out(total, 0.0f);
+    SynthRng rng(config.seed);
+
+    PianoGroundTruth gt;
+    gt.sample_rate = sample_rate;
+    gt.notes.resize(config.notes.size());
+    for (size_t n = 0; n < config.notes.size(); ++n) {
+        render_note(config.notes[n], sample_rate, rng, out, gt.notes[n]);
+    }
+
+    double power = 0.0;
+    for (float v : out) power += static_cast<double>(v) * v;
+    gt.signal_rms = total > 0 ? static_cast<float>(std::sqrt(power / total)) : 0.0f;
+
+    if (std::fabs(config.snr_db) < 200.0f && gt.signal_rms > 0.0f) {
+        gt.noise_rms = gt.signal_rms * std::pow(10.0f, -config.snr_db / 20.0f);
+        for (float& v : out) v += static_cast<float>(gt.noise_rms * rng.gaussian());
+    }
+
+    if (truth) *truth = std::move(gt);
+    return out;
+}
+
+bool parse_piano_synth_spec(const std::string& spec, PianoSynthConfig& out, std::string* error) {
+    auto fail = [&](const std::string& msg) {
+        if (error) *error = msg;
+        return false;
+    };
+
+    std::string body = spec;
+    if (body.rfind("synth:", 0) == 0) body = body.substr(6);
+
+    PianoSynthConfig cfg = out;
+    cfg.notes.clear();
+
+    size_t note_begin = 0;
+    while (note_begin <= body.size()) {
+        size_t note_end = body.find(';', note_begin);
+        if (note_end == std::string::npos) note_end = body.size();
+        const std::string note_str = body.substr(note_begin, note_end - note_begin);
+
+        PianoNoteSpec note;
+        bool explicit_b = false;
+        bool has_note = false;  // a per-note key was given: the segment is a note
+        int midi = -1;
+        size_t pos = 0;
+        while (pos < note_str.size()) {
+            size_t comma = note_str.find(',', pos);
+            if (comma == std::string::npos) comma = note_str.size();
+            const std::string kv = note_str.substr(pos, comma - pos);
+            pos = comma + 1;
+            if (kv.empty()) continue;
+
+            const size_t eq = kv.find('=');
+            if (eq == std::string::npos) return fail("expected key=value, got '" + kv + "'");
+            const std::string key = kv.substr(0, eq);
+            const std::string val = kv.substr(eq + 1);
+
+            if (key == "note") {
+                midi = parse_note_name(val);
+                if (midi < 0 || midi > 127) return fail("bad note '" + val + "'");
+                has_note = true;
+                continue;
+            }
+            char* end = nullptr;
+            const double v = std::strtod(val.c_str(), &end);
+            if (val.empty() || *end != '\0') return fail("bad value for " + key + ": '" + val + "'");
+
+            if (key == "f1") note.f1 = static_cast<float>(v);
+            else if (key == "B") { note.B = static_cast<float>(v); explicit_b = true; }
+            else if (key == "partials") note.num_partials = static_cast<int>(v);
+            else if (key == "strings") note.unison_strings = static_cast<int>(v);
+            else if (key == "detune") note.unison_detune_cents = static_cast<float>(v);
+            else if (key == "amp") note.amplitude = static_cast<float>(v);
+            else if (key == "rolloff") note.rolloff = static_cast<float>(v);
+            else if (key == "decay") note.decay_s = static_cast<float>(v);
+            else if (key == "onset") note.onset_s = static_cast<float>(v);
+            else if (key == "hammer") note.hammer_noise = static_cast<float>(v);
+            else if (key == "snr") { cfg.snr_db = static_cast<float>(v); continue; }
+            else if (key == "dur") { cfg.duration_s = static_cast<float>(v); continue; }
+            else if (key == "seed") { cfg.seed = static_cast<uint32_t>(v); continue; }
+            else if (key == "rate") { cfg.sample_rate = static_cast<int>(v); continue; }
+            else return fail("unknown key '" + key + "'");
+            has_note = true;
+        }
+        if (midi >= 0) {
+            // Equal-tempered pitch of the first partial, so the note sounds at its name
+            const double target = 440.0 * std::pow(2.0, (midi - 69) / 12.0);
+            if (!explicit_b) note.B = typical_inharmonicity(midi);
+            note.f1 = static_cast<float>(target / std::sqrt(1.0 + note.B));
+        }
+        if (has_note) cfg.notes.push_back(note);
+        note_begin = note_end + 1;
+    }
+    if (cfg.notes.empty()) cfg.notes.push_back(PianoNoteSpec{});  // "synth:" alone plays the default A4
+
+    if (cfg.sample_rate <= 0 || cfg.duration_s <= 0.0f) return fail("rate and dur must be positive");
+    out = std::move(cfg);
+    return true;
+}
+
+} // namespace tuner
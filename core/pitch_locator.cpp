@@ -0,0 +1,233 @@
+#include "pitch_locator.hpp"
+
+#include "fft/fft_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace tuner {
+
+namespace {
+// The FFT path costs about this many direct lag products per N log2 N:
+// two complex transforms with fft_utils against vectorised multiply-adds
+// (pitch_locator_bench)
+constexpr float FFT_CROSSOVER = 100.0f;
+constexpr int MIN_PERIOD = 8;       // lags; shorter periods are upsampled to at least this
+constexpr int MAX_UPSAMPLE = 8;
+constexpr int INTERP_HALF = 8;      // input samples either side in the interpolator
+
+// Sum of (a[k] - b[k])^2; two vector accumulators, so the adds need not
+// wait on each other
+float squared_difference(const float* a, const float* b, int n) {
+    int k = 0;
+    float sum = 0.0f;
+#if defined(__AVX2__)
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    for (; k + 16 <= n; k += 16) {
+        const __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + k), _mm256_loadu_ps(b + k));
+        const __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + k + 8), _mm256_loadu_ps(b + k + 8));
+#if defined(__FMA__)
+        a0 = _mm256_fmadd_ps(d0, d0, a0);
+        a1 = _mm256_fmadd_ps(d1, d1, a1);
+#else
+        a0 = _mm256_add_ps(a0, _mm256_mul_ps(d0, d0));
+        a1 = _mm256_add_ps(a1, _mm256_mul_ps(d1, d1));
+#endif
+    }
+    const __m256 s = _mm256_add_ps(a0, a1);
+    __m128 q = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+    q = _mm_add_ps(q, _mm_movehl_ps(q, q));
+    q = _mm_add_ss(q, _mm_shuffle_ps(q, q, 1));
+    sum = _mm_cvtss_f32(q);
+#elif defined(__SSE2__)
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+    for (; k + 8 <= n; k += 8) {
+        const __m128 d0 = _mm_sub_ps(_mm_loadu_ps(a + k), _mm_loadu_ps(b + k));
+        const __m128 d1 = _mm_sub_ps(_mm_loadu_ps(a + k + 4), _mm_loadu_ps(b + k + 4));
+        a0 = _mm_add_ps(a0, _mm_mul_ps(d0, d0));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(d1, d1));
+    }
+    __m128 q = _mm_add_ps(a0, a1);
+    q = _mm_add_ps(q, _mm_movehl_ps(q, q));
+    q = _mm_add_ss(q, _mm_shuffle_ps(q, q, 1));
+    sum = _mm_cvtss_f32(q);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    float32x4_t a0 = vdupq_n_f32(0.0f), a1 = vdupq_n_f32(0.0f);
+    for (; k + 8 <= n; k += 8) {
+        const float32x4_t d0 = vsubq_f32(vld1q_f32(a + k), vld1q_f32(b + k));
+        const float32x4_t d1 = vsubq_f32(vld1q_f32(a + k + 4), vld1q_f32(b + k + 4));
+        a0 = vmlaq_f32(a0, d0, d0);
+        a1 = vmlaq_f32(a1, d1, d1);
+    }
+    const float32x4_t q = vaddq_f32(a0, a1);
+    sum = vgetq_lane_f32(q, 0) + vgetq_lane_f32(q, 1) + vgetq_lane_f32(q, 2) + vgetq_lane_f32(q, 3);
+#endif
+    for (; k < n; ++k) {
+        const float d = a[k] - b[k];
+        sum += d * d;
+    }
+    return sum;
+}
+
+int next_pow2(int n) {
+    int p = 1;
+    while (p < n && p < (1 << 30)) p <<= 1;
+    return p;
+}
+}
+
+PitchLocator::PitchLocator(const PitchLocatorConfig& config) : cfg(config) {}
+
+void PitchLocator::build_interpolator(int factor) {
+    // Windowed sinc per phase p / factor between two input samples
+    upsample = factor;
+    interpolator.assign(static_cast<size_t>(factor * 2 * INTERP_HALF), 0.0f);
+    for (int p = 0; p < factor; ++p) {
+        for (int k = 0; k < 2 * INTERP_HALF; ++k) {
+            const double t = static_cast<double>(k - INTERP_HALF + 1) - static_cast<double>(p) / factor;
+            const double sinc = t == 0.0 ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+            const double w = 0.42 + 0.5 * std::cos(M_PI * t / INTERP_HALF) + 0.08 * std::cos(2.0 * M_PI * t / INTERP_HALF);
+            interpolator[static_cast<size_t>(p * 2 * INTERP_HALF + k)] = static_cast<float>(sinc * w);
+        }
+    }
+}
+
+void PitchLocator::reserve(int max_count, float sample_rate, float min_hz) {
+    if (max_count <= 0 || !(sample_rate > 0.0f) || !(min_hz > 0.0f)) return;
+    // The longest lag at the highest upsampling, as locate() bounds it
+    const int available = max_count * MAX_UPSAMPLE;
+    const int longest = std::min(static_cast<int>(std::ceil(sample_rate * MAX_UPSAMPLE / min_hz)) + 1, available / 2);
+    difference.reserve(static_cast<size_t>(longest) + 1);
+    energy.reserve(static_cast<size_t>(2 * longest) + 1);
+    spectrum.reserve(static_cast<size_t>(next_pow2(2 * longest)));
+    upsampled.reserve(static_cast<size_t>(2 * longest + MAX_UPSAMPLE));
+    interpolator.reserve(static_cast<size_t>(MAX_UPSAMPLE * 2 * INTERP_HALF));
+    for (int n = 2; n <= next_pow2(2 * longest); n *= 2) fft::prepare_fft(n);
+}
+
+PitchEstimate PitchLocator::locate(const float* x, int count, float sample_rate, float min_hz, float max_hz) {
+    PitchEstimate est;
+    if (!x || !(sample_rate > 0.0f) || !(min_hz > 0.0f) || !(max_hz > min_hz)) return est;
+    // Short periods fall between whole lags, where the nearest lag can miss
+    // the dip and the parabola through it is far off: those are searched
+    // at a multiple of the rate
+    int factor = 1;
+    while (factor < MAX_UPSAMPLE && sample_rate / max_hz * static_cast<float>(factor) < MIN_PERIOD) factor *= 2;
+    const float rate = sample_rate * static_cast<float>(factor);
+    // The window is as long as the longest period, so every lag compares
+    // whole periods
+    const int available = factor == 1 ? count : (count - 2 * INTERP_HALF) * factor;
+    const int longest = std::min(static_cast<int>(std::ceil(rate / min_hz)) + 1, available / 2);
+    const int shortest = std::max(2, static_cast<int>(rate / max_hz));
+    if (longest < shortest + 2) return est;
+    const int w = longest;
+    const float* s = x + count - 2 * w;
+    if (factor > 1) {
+        if (upsample != factor) build_interpolator(factor);
+        const int inputs = (2 * w + factor - 1) / factor;
+        const float* in = x + count - inputs - INTERP_HALF;
+        if (upsampled.size() < static_cast<size_t>(inputs * factor)) upsampled.resize(static_cast<size_t>(inputs * factor));
+        for (int i = 0; i < inputs; ++i) {
+            for (int p = 0; p < factor; ++p) {
+                const float* h = &interpolator[static_cast<size_t>(p * 2 * INTERP_HALF)];
+                float v = 0.0f;
+                for (int k = 0; k < 2 * INTERP_HALF; ++k) v += h[k] * in[i + k - INTERP_HALF + 1];
+                upsampled[static_cast<size_t>(i * factor + p)] = v;
+            }
+        }
+        s = upsampled.data() + inputs * factor - 2 * w;
+    }
+    if (difference.size() < static_cast<size_t>(longest) + 1) difference.resize(static_cast<size_t>(longest) + 1);
+
+    const int n = next_pow2(2 * w);
+    used = forced;
+    if (used == LagMethod::Auto) {
+        const float direct = static_cast<float>(w) * static_cast<float>(longest);
+        used = direct > FFT_CROSSOVER * static_cast<float>(n) * std::log2(static_cast<float>(n)) ? LagMethod::Fft
+                                                                                                 : LagMethod::Direct;
+    }
+    if (used == LagMethod::Direct) {
+        for (int tau = 1; tau <= longest; ++tau) {
+            difference[static_cast<size_t>(tau)] = squared_difference(s, s + tau, w);
+        }
+    } else {
+        // d(tau) = E(0) + E(tau) - 2 r(tau), with r the cross-correlation of
+        // the first window with the whole span. Both go through one complex
+        // transform, the window as real part and the span as imaginary.
+        if (spectrum.size() != static_cast<size_t>(n)) spectrum.resize(static_cast<size_t>(n));
+        for (int i = 0; i < n; ++i) {
+            const float b = i < 2 * w ? s[i] : 0.0f;
+            spectrum[static_cast<size_t>(i)] = {i < w ? s[i] : 0.0f, b};
+        }
+        fft::compute_fft_inplace(spectrum);
+        // Split the two spectra, A = (Z[k] + Z*[-k]) / 2 and B = (Z[k] - Z*[-k]) / 2i,
+        // and form conj(A[k]) B[k] for k and -k together
+        for (int k = 0; k <= n / 2; ++k) {
+            const int m = (n - k) % n;
+            const std::complex<float> zk = spectrum[static_cast<size_t>(k)];
+            const std::complex<float> zm = spectrum[static_cast<size_t>(m)];
+            const std::complex<float> ak = 0.5f * (zk + std::conj(zm));
+            const std::complex<float> bk = std::complex<float>(0.0f, -0.5f) * (zk - std::conj(zm));
+            const std::complex<float> am = std::conj(ak), bm = std::conj(bk);
+            // Conjugated again for the inverse transform by a forward one
+            spectrum[static_cast<size_t>(k)] = ak * std::conj(bk);
+            spectrum[static_cast<size_t>(m)] = am * std::conj(bm);
+        }
+        fft::compute_fft_inplace(spectrum);
+        if (energy.size() < static_cast<size_t>(2 * w) + 1) energy.resize(static_cast<size_t>(2 * w) + 1);
+        energy[0] = 0.0;
+        for (int i = 0; i < 2 * w; ++i) {
+            energy[static_cast<size_t>(i) + 1] = energy[static_cast<size_t>(i)] + static_cast<double>(s[i]) * s[i];
+        }
+        const double e0 = energy[static_cast<size_t>(w)];
+        const double scale = 1.0 / n;
+        for (int tau = 1; tau <= longest; ++tau) {
+            const double et = energy[static_cast<size_t>(tau + w)] - energy[static_cast<size_t>(tau)];
+            const double r = spectrum[static_cast<size_t>(tau)].real() * scale;
+            difference[static_cast<size_t>(tau)] = static_cast<float>(std::max(0.0, e0 + et - 2.0 * r));
+        }
+    }
+
+    // Cumulative mean normalised difference
+    double sum = 0.0;
+    difference[0] = 1.0f;
+    for (int tau = 1; tau <= longest; ++tau) {
+        sum += difference[static_cast<size_t>(tau)];
+        difference[static_cast<size_t>(tau)] =
+            sum > 0.0 ? static_cast<float>(difference[static_cast<size_t>(tau)] * tau / sum) : 1.0f;
+    }
+
+    // The first dip whose bottom, interpolated between lags, is below the
+    // threshold: a short period falls between whole lags, where the
+    // nearest lag can stay well above it
+    float lowest = 1.0f;
+    for (int tau = std::max(shortest, 2); tau < longest; ++tau) {
+        const float a = difference[static_cast<size_t>(tau) - 1];
+        const float b = difference[static_cast<size_t>(tau)];
+        const float c = difference[static_cast<size_t>(tau) + 1];
+        if (b > a || b > c) continue;
+        const float den = a - 2.0f * b + c;
+        const float shift = den > 0.0f ? std::clamp(0.5f * (a - c) / den, -0.5f, 0.5f) : 0.0f;
+        const float bottom = std::max(0.0f, b - 0.25f * (a - c) * shift);
+        lowest = std::min(lowest, bottom);
+        if (bottom < cfg.threshold) {
+            est.f0_hz = rate / (static_cast<float>(tau) + shift);
+            est.periodicity = 1.0f - bottom;
+            return est;
+        }
+    }
+    est.periodicity = std::clamp(1.0f - lowest, 0.0f, 1.0f);
+    return est;
+}
+
+} // namespace tuner
@@ -0,0 +1,145 @@
+#include "pre_decimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace tuner {
+
+namespace {
+constexpr double STOPBAND_DB = 80.0;
+constexpr double PASSBAND_FRACTION = 0.4;  // of the output rate; the stopband starts at 1 - this
+
+// Zeroth-order modified Bessel function of the first kind (Kaiser window)
+double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 50 && term > 1e-12 * sum; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// Two vector accumulators, so the adds need not wait on each other
+float dot(const float* h, const float* x, int n) {
+    int k = 0;
+    float sum = 0.0f;
+#if defined(__AVX2__)
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    for (; k + 16 <= n; k += 16) {
+#if defined(__FMA__)
+        a0 = _mm256_fmadd_ps(_mm256_loadu_ps(h + k), _mm256_loadu_ps(x + k), a0);
+        a1 = _mm256_fmadd_ps(_mm256_loadu_ps(h + k + 8), _mm256_loadu_ps(x + k + 8), a1);
+#else
+        a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(h + k), _mm256_loadu_ps(x + k)));
+        a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(h + k + 8), _mm256_loadu_ps(x + k + 8)));
+#endif
+    }
+    const __m256 a = _mm256_add_ps(a0, a1);
+    __m128 q = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    q = _mm_add_ps(q, _mm_movehl_ps(q, q));
+    q = _mm_add_ss(q, _mm_shuffle_ps(q, q, 1));
+    sum = _mm_cvtss_f32(q);
+#elif defined(__SSE2__)
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+    for (; k + 8 <= n; k += 8) {
+        a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(h + k), _mm_loadu_ps(x + k)));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(h + k + 4), _mm_loadu_ps(x + k + 4)));
+    }
+    __m128 q = _mm_add_ps(a0, a1);
+    q = _mm_add_ps(q, _mm_movehl_ps(q, q));
+    q = _mm_add_ss(q, _mm_shuffle_ps(q, q, 1));
+    sum = _mm_cvtss_f32(q);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    float32x4_t a0 = vdupq_n_f32(0.0f), a1 = vdupq_n_f32(0.0f);
+    for (; k + 8 <= n; k += 8) {
+        a0 = vmlaq_f32(a0, vld1q_f32(h + k), vld1q_f32(x + k));
+        a1 = vmlaq_f32(a1, vld1q_f32(h + k + 4), vld1q_f32(x + k + 4));
+    }
+    const float32x4_t q = vaddq_f32(a0, a1);
+    sum = vgetq_lane_f32(q, 0) + vgetq_lane_f32(q, 1) + vgetq_lane_f32(q, 2) + vgetq_lane_f32(q, 3);
+#endif
+    for (; k < n; ++k) sum += h[k] * x[k];
+    return sum;
+}
+}
+
+void PreDecimator::configure(int sample_rate, int factor, int max_block) {
+    rate = std::max(1, sample_rate);
+    r = 1;
+    while (r * 2 <= std::min(factor, 16)) r *= 2;
+    taps.clear();
+    if (r > 1) {
+        // Kaiser design: cutoff halfway across the transition band, which is
+        // 1 - 2 * PASSBAND_FRACTION of the output rate wide
+        const double transition = 2.0 * M_PI * (1.0 - 2.0 * PASSBAND_FRACTION) / r;  // rad / input sample
+        const double beta = 0.1102 * (STOPBAND_DB - 8.7);
+        int n = static_cast<int>(std::ceil((STOPBAND_DB - 8.0) / (2.285 * transition))) + 1;
+        n |= 1;  // odd: the centre tap is a whole sample
+        const double cutoff = M_PI / r;
+        const double mid = 0.5 * (n - 1);
+        taps.resize(static_cast<size_t>(n));
+        double sum = 0.0;
+        for (int i = 0; i < n; ++i) {
+            const double t = i - mid;
+            const double sinc = t == 0.0 ? cutoff / M_PI : std::sin(cutoff * t) / (M_PI * t);
+            const double u = t / mid;
+            const double h = sinc * bessel_i0(beta * std::sqrt(std::max(0.0, 1.0 - u * u))) / bessel_i0(beta);
+            taps[static_cast<size_t>(i)] = static_cast<float>(h);
+            sum += h;
+        }
+        for (float& h : taps) h = static_cast<float>(h / sum);  // unity gain at DC
+        std::reverse(taps.begin(), taps.end());
+        // Zeros ahead of the oldest tap, so dot() runs in whole vectors
+        taps.insert(taps.begin(), static_cast<size_t>((16 - n % 16) % 16), 0.0f);
+        line.reserve(taps.size() - 1 + static_cast<size_t>(std::max(0, max_block)));
+    }
+    reset();
+}
+
+void PreDecimator::reset() {
+    line.assign(taps.empty() ? 0 : taps.size() - 1, 0.0f);
+    skip = 0;
+}
+
+int PreDecimator::process(const float* input, int num_samples, float* out) {
+    if (!input || num_samples <= 0) return 0;
+    if (r == 1) {
+        std::copy(input, input + num_samples, out);
+        return num_samples;
+    }
+    const size_t history = taps.size() - 1;
+    line.insert(line.end(), input, input + num_samples);
+    int produced = 0;
+    const float* h = taps.data();
+    const int n = static_cast<int>(taps.size());
+    for (int i = skip; i < num_samples; i += r) {
+        const float* x = line.data() + i;  // the n inputs ending at input[i]
+        out[produced++] = dot(h, x, n);
+    }
+    skip = (skip - num_samples % r + r) % r;
+    line.erase(line.begin(), line.end() - static_cast<std::ptrdiff_t>(history));
+    return produced;
+}
+
+float PreDecimator::passband_hz(int sample_rate, int factor) {
+    if (factor <= 1) return 0.5f * static_cast<float>(sample_rate);
+    return static_cast<float>(PASSBAND_FRACTION) * static_cast<float>(sample_rate) / static_cast<float>(factor);
+}
+
+int PreDecimator::factor_for(int sample_rate, float hz, int max_factor) {
+    int f = 1;
+    while (f * 2 <= std::min(max_factor, 16) && passband_hz(sample_rate, f * 2) >= hz) f *= 2;
+    return f;
+}
+
+} // namespace tuner
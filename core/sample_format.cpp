@@ -0,0 +1,295 @@
+#include "sample_format.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace tuner {
+
+namespace {
+
+constexpr float kScale16 = 1.0f / 32768.0f;
+constexpr float kScale32 = 1.0f / 2147483648.0f;
+
+inline int32_t load_s24_3le(const uint8_t* p) {
+    // Place the 24-bit word in the top of an int32 so the sign comes for free
+    uint32_t v = (static_cast<uint32_t>(p[0]) << 8) |
+                 (static_cast<uint32_t>(p[1]) << 16) |
+                 (static_cast<uint32_t>(p[2]) << 24);
+    return static_cast<int32_t>(v);
+}
+
+inline int32_t read_s32(const uint8_t* p) {
+    int32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline int16_t read_s16(const uint8_t* p) {
+    int16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Scalar tail/reference for every integer format; `i` is the first sample to convert
+void convert_tail(SampleFormat fmt, const uint8_t* src, float* dst, std::size_t i, std::size_t count) {
+    switch (fmt) {
+        case SampleFormat::Float32LE:
+            if (count > i) std::memcpy(dst + i, src + i * 4, (count - i) * sizeof(float));
+            break;
+        case SampleFormat::S32LE:
+            for (; i < count; ++i) dst[i] = static_cast<float>(read_s32(src + i * 4)) * kScale32;
+            break;
+        case SampleFormat::S24LE:
+            for (; i < count; ++i) {
+                uint32_t u = static_cast<uint32_t>(read_s32(src + i * 4)) << 8;
+                dst[i] = static_cast<float>(static_cast<int32_t>(u)) * kScale32;
+            }
+            break;
+        case SampleFormat::S24_3LE:
+            for (; i < count; ++i) dst[i] = static_cast<float>(load_s24_3le(src + i * 3)) * kScale32;
+            break;
+        case SampleFormat::S16LE:
+            for (; i < count; ++i) dst[i] = static_cast<float>(read_s16(src + i * 2)) * kScale16;
+            break;
+    }
+}
+
+#if defined(__AVX2__)
+
+std::size_t convert_simd(SampleFormat fmt, const uint8_t* src, float* dst, std::size_t count) {
+    std::size_t i = 0;
+    switch (fmt) {
+        case SampleFormat::S16LE: {
+            const __m256 scale = _mm256_set1_ps(kScale16);
+            for (; i + 8 <= count; i += 8) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+                __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(s));
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(f, scale));
+            }
+            break;
+        }
+        case SampleFormat::S32LE: {
+            const __m256 scale = _mm256_set1_ps(kScale32);
+            for (; i + 8 <= count; i += 8) {
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+            }
+            break;
+        }
+        case SampleFormat::S24LE: {
+            const __m256 scale = _mm256_set1_ps(kScale32);
+            for (; i + 8 <= count; i += 8) {
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+                s = _mm256_slli_epi32(s, 8);
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+            }
+            break;
+        }
+        case SampleFormat::S24_3LE: {
+            // Each 128-bit lane expands 4 packed samples (12 bytes) into 4 int32.
+            // Two 16-byte loads at +0 and +12 read up to byte 28, so keep 10 samples of slack.
+            const __m256 scale = _mm256_set1_ps(kScale32);
+            const __m256i shuf = _mm256_setr_epi8(
+                -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            for (; i + 10 <= count; i += 8) {
+                const uint8_t* p = src + i * 3;
+                __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 12));
+                __m256i s = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+                s = _mm256_shuffle_epi8(s, shuf);
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+            }
+            break;
+        }
+        case SampleFormat::Float32LE:
+            break;
+    }
+    return i;
+}
+
+#elif defined(__SSE2__)
+
+std::size_t convert_simd(SampleFormat fmt, const uint8_t* src, float* dst, std::size_t count) {
+    std::size_t i = 0;
+    switch (fmt) {
+        case SampleFormat::S16LE: {
+            const __m128 scale = _mm_set1_ps(kScale16);
+            for (; i + 8 <= count; i += 8) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+                // Interleave with itself then arithmetic shift to sign-extend to 32 bits
+                __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+                __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+                _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+            }
+            break;
+        }
+        case SampleFormat::S32LE: {
+            const __m128 scale = _mm_set1_ps(kScale32);
+            for (; i + 4 <= count; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(s), scale));
+            }
+            break;
+        }
+        case SampleFormat::S24LE: {
+            const __m128 scale = _mm_set1_ps(kScale32);
+            for (; i + 4 <= count; i += 4) {
+                __m128i s = _mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4)), 8);
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(s), scale));
+            }
+            break;
+        }
+        case SampleFormat::S24_3LE: {
+#if defined(__SSSE3__)
+            // 4 packed samples per step; the 16-byte load needs 6 samples of slack
+            const __m128 scale = _mm_set1_ps(kScale32);
+            const __m128i shuf = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            for (; i + 6 <= count; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+                s = _mm_shuffle_epi8(s, shuf);
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(s), scale));
+            }
+#else
+            // No byte shuffle: shift the register so each sample's three bytes land
+            // in the top of its lane, then mask them out and merge. Same slack as above.
+            const __m128 scale = _mm_set1_ps(kScale32);
+            const __m128i m0 = _mm_setr_epi32(static_cast<int>(0xFFFFFF00u), 0, 0, 0);
+            const __m128i m1 = _mm_setr_epi32(0, static_cast<int>(0xFFFFFF00u), 0, 0);
+            const __m128i m2 = _mm_setr_epi32(0, 0, static_cast<int>(0xFFFFFF00u), 0);
+            const __m128i m3 = _mm_setr_epi32(0, 0, 0, static_cast<int>(0xFFFFFF00u));
+            for (; i + 6 <= count; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+                __m128i v = _mm_or_si128(_mm_and_si128(_mm_slli_si128(s, 1), m0),
+                                         _mm_and_si128(_mm_slli_si128(s, 2), m1));
+                v = _mm_or_si128(v, _mm_and_si128(_mm_slli_si128(s, 3), m2));
+                v = _mm_or_si128(v, _mm_and_si128(_mm_slli_si128(s, 4), m3));
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+            }
+#endif
+            break;
+        }
+        case SampleFormat::Float32LE:
+            break;
+    }
+    return i;
+}
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+std::size_t convert_simd(SampleFormat fmt, const uint8_t* src, float* dst, std::size_t count) {
+    std::size_t i = 0;
+    switch (fmt) {
+        case SampleFormat::S16LE: {
+            for (; i + 8 <= count; i += 8) {
+                int16x8_t s = vld1q_s16(reinterpret_cast<const int16_t*>(src + i * 2));
+                vst1q_f32(dst + i, vcvtq_n_f32_s32(vmovl_s16(vget_low_s16(s)), 15));
+                vst1q_f32(dst + i + 4, vcvtq_n_f32_s32(vmovl_s16(vget_high_s16(s)), 15));
+            }
+            break;
+        }
+        case SampleFormat::S32LE: {
+            for (; i + 4 <= count; i += 4) {
+                int32x4_t s = vld1q_s32(reinterpret_cast<const int32_t*>(src + i * 4));
+                vst1q_f32(dst + i, vcvtq_n_f32_s32(s, 31));
+            }
+            break;
+        }
+        case SampleFormat::S24LE: {
+            for (; i + 4 <= count; i += 4) {
+                int32x4_t s = vshlq_n_s32(vld1q_s32(reinterpret_cast<const int32_t*>(src + i * 4)), 8);
+                vst1q_f32(dst + i, vcvtq_n_f32_s32(s, 31));
+            }
+            break;
+        }
+        case SampleFormat::S24_3LE: {
+            // vld3 de-interleaves 8 packed samples into byte planes b0/b1/b2
+            for (; i + 8 <= count; i += 8) {
+                uint8x8x3_t b = vld3_u8(src + i * 3);
+                uint16x8_t b0 = vmovl_u8(b.val[0]);
+                uint16x8_t b1 = vmovl_u8(b.val[1]);
+                uint16x8_t b2 = vmovl_u8(b.val[2]);
+                uint32x4_t lo = vorrq_u32(vorrq_u32(vshlq_n_u32(vmovl_u16(vget_low_u16(b0)), 8),
+                                                    vshlq_n_u32(vmovl_u16(vget_low_u16(b1)), 16)),
+                                          vshlq_n_u32(vmovl_u16(vget_low_u16(b2)), 24));
+                uint32x4_t hi = vorrq_u32(vorrq_u32(vshlq_n_u32(vmovl_u16(vget_high_u16(b0)), 8),
+                                                    vshlq_n_u32(vmovl_u16(vget_high_u16(b1)), 16)),
+                                          vshlq_n_u32(vmovl_u16(vget_high_u16(b2)), 24));
+                vst1q_f32(dst + i, vcvtq_n_f32_s32(vreinterpretq_s32_u32(lo), 31));
+                vst1q_f32(dst + i + 4, vcvtq_n_f32_s32(vreinterpretq_s32_u32(hi), 31));
+            }
+            break;
+        }
+        case SampleFormat::Float32LE:
+            break;
+    }
+    return i;
+}
+
+#else
+
+std::size_t convert_simd(SampleFormat, const uint8_t*, float*, std::size_t) { return 0; }
+
+#endif
+
+} // namespace
+
+int bytes_per_sample(SampleFormat fmt) {
+    switch (fmt) {
+        case SampleFormat::Float32LE: return 4;
+        case SampleFormat::S32LE: return 4;
+        case SampleFormat::S24LE: return 4;
+        case SampleFormat::S24_3LE: return 3;
+        case SampleFormat::S16LE: return 2;
+    }
+    return 4;
+}
+
+const char* sample_format_name(SampleFormat fmt) {
+    switch (fmt) {
+        case SampleFormat::Float32LE: return "FLOAT_LE";
+        case SampleFormat::S32LE: return "S32_LE";
+        case SampleFormat::S24LE: return "S24_LE";
+        case SampleFormat::S24_3LE: return "S24_3LE";
+        case SampleFormat::S16LE: return "S16_LE";
+    }
+    return "unknown";
+}
+
+const char* sample_format_simd_backend() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSSE3__)
+    return "SSSE3";
+#elif defined(__SSE2__)
+    return "SSE2";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+void convert_to_float(SampleFormat fmt, const void* src, float* dst, std::size_t count) {
+    if (!src || !dst || count == 0) return;
+    const uint8_t* bytes = static_cast<const uint8_t*>(src);
+    std::size_t done = convert_simd(fmt, bytes, dst, count);
+    convert_tail(fmt, bytes, dst, done, count);
+}
+
+void convert_to_float_scalar(SampleFormat fmt, const void* src, float* dst, std::size_t count) {
+    if (!src || !dst || count == 0) return;
+    convert_tail(fmt, static_cast<const uint8_t*>(src), dst, 0, count);
+}
+
+} // namespace tuner
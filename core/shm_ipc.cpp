@@ -0,0 +1,198 @@
+#include "shm_ipc.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tuner {
+
+namespace {
+
+constexpr uint32_t SHM_MAGIC = 0x544e5246;  // "TNRF"
+constexpr uint32_t SHM_LAYOUT_VERSION = 14;
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct ShmHeader {
+    std::atomic<uint32_t> magic{0};       // written last by the creator
+    uint32_t layout_version = SHM_LAYOUT_VERSION;
+    uint32_t segment_size = 0;
+    int32_t engine_pid = 0;
+    std::atomic<uint64_t> heartbeat_ns{0};  // steady_clock (CLOCK_MONOTONIC, shared across processes)
+};
+
+// Map `bytes` of shm object `path`. create: O_CREAT|O_TRUNC read-write.
+void* map_segment(const std::string& path, size_t bytes, bool create, bool writable) {
+    const int flags = create ? (O_CREAT | O_TRUNC | O_RDWR) : (writable ? O_RDWR : O_RDONLY);
+    const int fd = shm_open(path.c_str(), flags, 0600);
+    if (fd < 0) return nullptr;
+    if (create && ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return nullptr;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != bytes) {
+        ::close(fd);
+        return nullptr;
+    }
+    void* p = mmap(nullptr, bytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+bool header_valid(const ShmHeader& h, size_t bytes) {
+    return h.magic.load(std::memory_order_acquire) == SHM_MAGIC && h.layout_version == SHM_LAYOUT_VERSION &&
+           h.segment_size == bytes;
+}
+
+} // namespace
+
+struct ShmFrameSegment {
+    ShmHeader header;
+    LatestSnapshot<AnalysisFrame, 4> frames;
+    LatestSnapshot<gui::LongAnalysisSnapshot, 2> long_results;
+};
+
+struct ShmCommandSegment {
+    ShmHeader header;
+    InlineSpscQueue<EngineCommand, 64> queue;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared atomics must be lock-free");
+
+// ---- engine ----
+
+ShmEngineChannel::~ShmEngineChannel() {
+    close();
+}
+
+bool ShmEngineChannel::create(const std::string& name) {
+    close();
+    base_name = "/" + name;
+    void* f = map_segment(base_name + ".frames", sizeof(ShmFrameSegment), true, true);
+    void* c = map_segment(base_name + ".cmd", sizeof(ShmCommandSegment), true, true);
+    if (!f || !c) {
+        std::cerr << "Failed to create shared memory " << base_name << ".{frames,cmd}" << std::endl;
+        if (f) munmap(f, sizeof(ShmFrameSegment));
+        if (c) munmap(c, sizeof(ShmCommandSegment));
+        shm_unlink((base_name + ".frames").c_str());
+        shm_unlink((base_name + ".cmd").c_str());
+        return false;
+    }
+    frames = new (f) ShmFrameSegment();
+    commands = new (c) ShmCommandSegment();
+    for (ShmHeader* h : {&frames->header, &commands->header}) {
+        h->engine_pid = static_cast<int32_t>(getpid());
+        h->heartbeat_ns.store(now_ns(), std::memory_order_relaxed);
+    }
+    frames->header.segment_size = sizeof(ShmFrameSegment);
+    commands->header.segment_size = sizeof(ShmCommandSegment);
+    frames->header.magic.store(SHM_MAGIC, std::memory_order_release);
+    commands->header.magic.store(SHM_MAGIC, std::memory_order_release);
+    return true;
+}
+
+void ShmEngineChannel::close() {
+    if (frames) {
+        frames->header.magic.store(0, std::memory_order_release);
+        munmap(frames, sizeof(ShmFrameSegment));
+        shm_unlink((base_name + ".frames").c_str());
+        frames = nullptr;
+    }
+    if (commands) {
+        commands->header.magic.store(0, std::memory_order_release);
+        munmap(commands, sizeof(ShmCommandSegment));
+        shm_unlink((base_name + ".cmd").c_str());
+        commands = nullptr;
+    }
+}
+
+AnalysisFrame& ShmEngineChannel::begin_frame() {
+    return frames->frames.begin_write();
+}
+
+void ShmEngineChannel::end_frame() {
+    frames->frames.end_write();
+    frames->header.heartbeat_ns.store(now_ns(), std::memory_order_relaxed);
+}
+
+void ShmEngineChannel::publish_long(const gui::LongAnalysisSnapshot& snapshot) {
+    if (frames) frames->long_results.publish(snapshot);
+}
+
+bool ShmEngineChannel::poll_command(EngineCommand& cmd) {
+    return commands && commands->queue.pop(cmd);
+}
+
+void ShmEngineChannel::heartbeat() {
+    if (frames) frames->header.heartbeat_ns.store(now_ns(), std::memory_order_relaxed);
+}
+
+// ---- client ----
+
+ShmClientChannel::~ShmClientChannel() {
+    detach();
+}
+
+bool ShmClientChannel::attach(const std::string& name) {
+    detach();
+    const std::string base = "/" + name;
+    void* f = map_segment(base + ".frames", sizeof(ShmFrameSegment), false, false);
+    void* c = map_segment(base + ".cmd", sizeof(ShmCommandSegment), false, true);
+    const auto* fs = static_cast<const ShmFrameSegment*>(f);
+    auto* cs = static_cast<ShmCommandSegment*>(c);
+    if (!fs || !cs || !header_valid(fs->header, sizeof(ShmFrameSegment)) ||
+        !header_valid(cs->header, sizeof(ShmCommandSegment))) {
+        if (f) munmap(f, sizeof(ShmFrameSegment));
+        if (c) munmap(c, sizeof(ShmCommandSegment));
+        return false;
+    }
+    frames = fs;
+    commands = cs;
+    return true;
+}
+
+void ShmClientChannel::detach() {
+    if (frames) munmap(const_cast<ShmFrameSegment*>(frames), sizeof(ShmFrameSegment));
+    if (commands) munmap(commands, sizeof(ShmCommandSegment));
+    frames = nullptr;
+    commands = nullptr;
+}
+
+uint64_t ShmClientChannel::frame_version() const {
+    return frames ? frames->frames.version() : 0;
+}
+
+bool ShmClientChannel::read_frame(AnalysisFrame& out, uint64_t* version) const {
+    return frames && frames->frames.read(out, version);
+}
+
+uint64_t ShmClientChannel::long_version() const {
+    return frames ? frames->long_results.version() : 0;
+}
+
+bool ShmClientChannel::read_long(gui::LongAnalysisSnapshot& out, uint64_t* version) const {
+    return frames && frames->long_results.read(out, version);
+}
+
+bool ShmClientChannel::send(const EngineCommand& cmd) {
+    return commands && commands->queue.push(cmd);
+}
+
+bool ShmClientChannel::engine_alive(int max_age_ms) const {
+    if (!frames || frames->header.magic.load(std::memory_order_acquire) != SHM_MAGIC) return false;
+    const uint64_t beat = frames->header.heartbeat_ns.load(std::memory_order_relaxed);
+    const uint64_t now = now_ns();
+    return now < beat || now - beat <= static_cast<uint64_t>(max_age_ms) * 1000000ull;
+}
+
+} // namespace tuner
@@ -0,0 +1,214 @@
+#include "sliding_dft.hpp"
+#include "zoom_fft.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tuner {
+
+namespace {
+// Twiddle phases are taken modulo 2 pi from (i - origin); past this many
+// samples the origin moves forward so they stay exact in double
+constexpr size_t REBASE_SAMPLES = size_t{1} << 24;
+// Samples an update gathers at a time; its scratch is sized for this once
+constexpr size_t MAX_BLOCK = 512;
+}
+
+void SlidingDftBank::configure(int num_bins, int window, int resync_windows) {
+    bins = std::max(0, num_bins);
+    length = std::max(1, window - 1);
+    resync_interval = static_cast<size_t>(std::max(1, resync_windows)) * static_cast<size_t>(length);
+    grid_center = 0.0f;
+    grid_rate = 0.0;
+    grid_span = 0.0f;
+    valid = false;
+    for (auto* v : {&omega, &tw_re, &tw_im, &step_re, &step_im, &back_re, &back_im,
+                    &y0_re, &y0_im, &yp_re, &yp_im, &ym_re, &ym_im}) {
+        v->assign(static_cast<size_t>(bins), 0.0);
+    }
+    in_band.assign(static_cast<size_t>(bins), 0);
+    block.resize(MAX_BLOCK * 6);
+    psi_re.resize(static_cast<size_t>(length));
+    psi_im.resize(static_cast<size_t>(length));
+    for (int l = 0; l < length; ++l) {
+        psi_re[l] = std::cos(2.0 * M_PI * l / length);
+        psi_im[l] = std::sin(2.0 * M_PI * l / length);
+    }
+}
+
+void SlidingDftBank::build_grid(float center_hz, double fs_dec, float span_cents) {
+    grid_center = center_hz;
+    grid_rate = fs_dec;
+    grid_span = span_cents;
+    for (int b = 0; b < bins; ++b) {
+        // Same grid as ZoomFFT::sample_bins
+        const double cents = span_cents * (2.0 * static_cast<double>(b) / std::max(1, bins - 1) - 1.0);
+        const double baseband_hz = center_hz * (std::pow(2.0, cents / 1200.0) - 1.0);
+        in_band[b] = std::fabs(baseband_hz) <= 0.5 * fs_dec;
+        omega[b] = 2.0 * M_PI * baseband_hz / fs_dec;
+        step_re[b] = std::cos(omega[b]);
+        step_im[b] = -std::sin(omega[b]);
+        back_re[b] = std::cos(omega[b] * length);
+        back_im[b] = std::sin(omega[b] * length);
+    }
+}
+
+void SlidingDftBank::resync_bin(const ZoomFFT& stream, int b) {
+    // Exact sums over the M samples before `position`, with the twiddle
+    // and rotator phases taken from the origin directly
+    const size_t start = position - static_cast<size_t>(length);
+    const double w = omega[b];
+    const double a0 = std::fmod(w * static_cast<double>(start - origin), 2.0 * M_PI);
+    double tr = std::cos(a0), ti = -std::sin(a0);
+    size_t l_psi = (start - origin) % static_cast<size_t>(length);
+    double s0r = 0.0, s0i = 0.0, spr = 0.0, spi = 0.0, smr = 0.0, smi = 0.0;
+    for (int l = 0; l < length; ++l) {
+        const std::complex<float> x = stream.baseband_sample(start + static_cast<size_t>(l));
+        const double dr = x.real() * tr - x.imag() * ti;
+        const double di = x.real() * ti + x.imag() * tr;
+        const double pr = psi_re[l_psi], pi = psi_im[l_psi];
+        if (++l_psi == static_cast<size_t>(length)) l_psi = 0;
+        s0r += dr; s0i += di;
+        spr += dr * pr - di * pi; spi += dr * pi + di * pr;
+        smr += dr * pr + di * pi; smi += di * pr - dr * pi;
+        const double nr = tr * step_re[b] - ti * step_im[b];
+        ti = tr * step_im[b] + ti * step_re[b];
+        tr = nr;
+    }
+    y0_re[b] = s0r; y0_im[b] = s0i;
+    yp_re[b] = spr; yp_im[b] = spi;
+    ym_re[b] = smr; ym_im[b] = smi;
+    const double a1 = std::fmod(w * static_cast<double>(position - origin), 2.0 * M_PI);
+    tw_re[b] = std::cos(a1);
+    tw_im[b] = -std::sin(a1);
+}
+
+void SlidingDftBank::rebase() {
+    // Whole windows, and no further than the current window start
+    const size_t start = position - static_cast<size_t>(length);
+    const size_t shift = (start - origin) / static_cast<size_t>(length) * static_cast<size_t>(length);
+    // Sums and twiddles referred to the new origin: times e^{+j omega shift};
+    // the Hann rotators are periodic in M and do not change
+    for (int b = 0; b < bins; ++b) {
+        const double a = std::fmod(omega[b] * static_cast<double>(shift), 2.0 * M_PI);
+        const double cr = std::cos(a), ci = std::sin(a);
+        auto turn = [&](double& re, double& im) {
+            const double r = re * cr - im * ci;
+            im = re * ci + im * cr;
+            re = r;
+        };
+        turn(tw_re[b], tw_im[b]);
+        turn(y0_re[b], y0_im[b]);
+        turn(yp_re[b], yp_im[b]);
+        turn(ym_re[b], ym_im[b]);
+    }
+    origin += shift;
+}
+
+void SlidingDftBank::update(const ZoomFFT& stream) {
+    if (bins == 0) return;
+    const ZoomFFTConfig& zc = stream.get_config();
+    const double fs_dec = static_cast<double>(zc.sample_rate) / std::max(1, zc.decimation);
+    if (stream.center_frequency() != grid_center || fs_dec != grid_rate || zc.span_cents != grid_span) {
+        build_grid(stream.center_frequency(), fs_dec, zc.span_cents);
+        valid = false;
+    }
+    // The newest sample has zero weight in transform()'s window, so the sum
+    // stops one short of it
+    const size_t written = stream.baseband_count();
+    if (written < static_cast<size_t>(length) + 1) {
+        valid = false;
+        return;
+    }
+    const size_t end = written - 1;
+    const size_t held = static_cast<size_t>(stream.baseband_size());
+    if (!valid || end < position || end - position + static_cast<size_t>(length) + 1 > held) {
+        // Restarted, retuned or too far behind: every bin from scratch
+        position = end;
+        origin = end - static_cast<size_t>(length);
+        for (int b = 0; b < bins; ++b) resync_bin(stream, b);
+        resync_due = 0.0;
+        resync_cursor = 0;
+        ++resyncs;
+        valid = true;
+        return;
+    }
+
+    // Samples of this block, then each bin's state stays in registers
+    // while it runs through them; a long update goes MAX_BLOCK at a time
+    const size_t count = end - position;
+    for (size_t first = position; first < end; first += MAX_BLOCK) {
+        const size_t n = std::min(MAX_BLOCK, end - first);
+        for (size_t j = 0; j < n; ++j) {
+            const size_t i = first + j;
+            const std::complex<float> xn = stream.baseband_sample(i);
+            const std::complex<float> xo = stream.baseband_sample(i - static_cast<size_t>(length));
+            // Rotator shared by the Hann neighbours; periodic in M, so the
+            // leaving sample's equals the entering one's
+            const size_t l = (i - origin) % static_cast<size_t>(length);
+            double* q = &block[j * 6];
+            q[0] = xn.real(); q[1] = xn.imag();
+            q[2] = xo.real(); q[3] = xo.imag();
+            q[4] = psi_re[l]; q[5] = psi_im[l];
+        }
+        for (int b = 0; b < bins; ++b) {
+            double twr = tw_re[b], twi = tw_im[b];
+            double a0r = y0_re[b], a0i = y0_im[b], apr = yp_re[b], api = yp_im[b], amr = ym_re[b], ami = ym_im[b];
+            const double bkr = back_re[b], bki = back_im[b], str = step_re[b], sti = step_im[b];
+            for (size_t j = 0; j < n; ++j) {
+                const double* q = &block[j * 6];
+                // e = x_new - x_old e^{+j omega M}; d = e * twiddle
+                const double er = q[0] - (q[2] * bkr - q[3] * bki);
+                const double ei = q[1] - (q[2] * bki + q[3] * bkr);
+                const double dr = er * twr - ei * twi;
+                const double di = er * twi + ei * twr;
+                a0r += dr; a0i += di;
+                const double a = dr * q[4], c = di * q[5], e = dr * q[5], f = di * q[4];
+                apr += a - c; api += e + f;
+                amr += a + c; ami += f - e;
+                const double nr = twr * str - twi * sti;
+                twi = twr * sti + twi * str;
+                twr = nr;
+            }
+            tw_re[b] = twr; tw_im[b] = twi;
+            y0_re[b] = a0r; y0_im[b] = a0i;
+            yp_re[b] = apr; yp_im[b] = api;
+            ym_re[b] = amr; ym_im[b] = ami;
+        }
+    }
+    position = end;
+    if (position - origin >= REBASE_SAMPLES) rebase();
+
+    // Staggered exact recompute: all bins once per resync_interval samples
+    resync_due += static_cast<double>(bins) * static_cast<double>(count) / static_cast<double>(resync_interval);
+    while (resync_due >= 1.0) {
+        resync_bin(stream, resync_cursor);
+        resync_due -= 1.0;
+        if (++resync_cursor == bins) {
+            resync_cursor = 0;
+            ++resyncs;
+        }
+    }
+}
+
+void SlidingDftBank::magnitudes(float* out, int count) const {
+    const int n = std::min(count, bins);
+    std::fill(out, out + std::max(0, count), 0.0f);
+    if (!valid) return;
+    // Periodic Hann w[l] = 0.5 - 0.25 (e^{j2pi l/M} + e^{-j2pi l/M}) with l
+    // counted from the window start, theta = that start's rotator phase
+    const size_t start = position - static_cast<size_t>(length);
+    const size_t l = (start - origin) % static_cast<size_t>(length);
+    const double cr = psi_re[l], ci = psi_im[l];
+    for (int b = 0; b < n; ++b) {
+        if (!in_band[b]) continue;
+        // 0.5 Y0 - 0.25 e^{-j theta} Yp - 0.25 e^{+j theta} Ym
+        const double pr = cr * yp_re[b] + ci * yp_im[b], pi = cr * yp_im[b] - ci * yp_re[b];
+        const double mr = cr * ym_re[b] - ci * ym_im[b], mi = cr * ym_im[b] + ci * ym_re[b];
+        const double xr = 0.5 * y0_re[b] - 0.25 * (pr + mr);
+        const double xi = 0.5 * y0_im[b] - 0.25 * (pi + mi);
+        out[b] = static_cast<float>(std::sqrt(xr * xr + xi * xi));
+    }
+}
+
+} // namespace tuner
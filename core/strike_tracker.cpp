@@ -0,0 +1,77 @@
+#include "strike_tracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tuner {
+
+namespace {
+constexpr float ATTACK_FLOOR = 0.8f;  // of the strike's threshold: below it during the attack, no strike
+}
+
+StrikeTracker::StrikeTracker(const StrikeTrackerConfig& config) : cfg(config) {}
+
+void StrikeTracker::reset() {
+    const StrikeTrackerConfig keep = cfg;
+    *this = StrikeTracker(keep);
+}
+
+void StrikeTracker::start_attack(float level) {
+    current = StrikePhase::Attack;
+    strike_start = now;
+    strike_threshold = cfg.threshold_scale * envelope;
+    decaying = 0;
+    last_level = level;
+}
+
+StrikePhase StrikeTracker::update(float level, int samples, unsigned int sample_rate) {
+    previous = current;
+    if (sample_rate == 0 || samples <= 0 || !std::isfinite(level)) return current;
+    const double dt = static_cast<double>(samples) / sample_rate;
+    now += dt;
+    level = std::max(0.0f, level);
+
+    if (cfg.envelope_half_life > 0.0f) {
+        envelope *= static_cast<float>(std::exp2(-dt / cfg.envelope_half_life));
+    }
+    envelope = std::max(envelope, level);
+    // A jump over the recent level, not merely a level above the threshold:
+    // a note decaying more slowly than the envelope would otherwise strike
+    // again and again
+    const bool onset = level >= cfg.min_level && level > cfg.threshold_scale * envelope &&
+                       level > cfg.onset_ratio * background;
+
+    switch (current) {
+    case StrikePhase::Waiting:
+        if (onset) start_attack(level);
+        break;
+    case StrikePhase::Attack: {
+        decaying = level < last_level ? decaying + 1 : 0;
+        const double age = now - strike_start;
+        if (level < ATTACK_FLOOR * strike_threshold) {
+            current = StrikePhase::Waiting;
+        } else if (age >= cfg.attack_seconds && (decaying >= cfg.decaying_frames || age >= cfg.max_attack_seconds)) {
+            // Counted only now: an attack that fell back to waiting was no strike
+            current = StrikePhase::Monitoring;
+            entry_level = level;
+            ++strike_count;
+        }
+        break;
+    }
+    case StrikePhase::Monitoring:
+        if (onset && level > cfg.retrigger_scale * entry_level) {
+            start_attack(level);
+        } else if (level < cfg.reset_scale * entry_level) {
+            current = StrikePhase::Waiting;
+        }
+        break;
+    }
+
+    last_level = level;
+    const float a = cfg.background_seconds > 0.0f
+                        ? 1.0f - static_cast<float>(std::exp(-dt / cfg.background_seconds)) : 1.0f;
+    background += a * (level - background);
+    return current;
+}
+
+} // namespace tuner
@@ -0,0 +1,85 @@
+#include "wav_reader.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace tuner {
+
+static uint16_t read_u16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+static uint32_t read_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static bool fail(std::string* error, const std::string& msg) {
+    if (error) *error = msg;
+    return false;
+}
+
+bool read_wav_file(const std::string& path, WavData& out, std::string* error) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return fail(error, "cannot open " + path);
+    std::fseek(f, 0, SEEK_END);
+    long sz = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    if (sz < 12) { std::fclose(f); return fail(error, "file too small"); }
+    std::vector<uint8_t> buf(static_cast<size_t>(sz));
+    size_t n = std::fread(buf.data(), 1, buf.size(), f);
+    std::fclose(f);
+    if (n != buf.size()) return fail(error, "short read");
+
+    if (std::memcmp(buf.data(), "RIFF", 4) != 0 || std::memcmp(buf.data() + 8, "WAVE", 4) != 0) {
+        return fail(error, "not a RIFF/WAVE file");
+    }
+
+    uint16_t tag = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    const uint8_t* data = nullptr;
+    uint32_t data_size = 0;
+
+    // Walk chunks; chunks are word aligned
+    size_t pos = 12;
+    while (pos + 8 <= buf.size()) {
+        const uint8_t* ck = buf.data() + pos;
+        uint32_t ck_size = read_u32(ck + 4);
+        size_t body = pos + 8;
+        size_t avail = buf.size() - body;
+        if (std::memcmp(ck, "fmt ", 4) == 0 && ck_size >= 16 && avail >= 16) {
+            tag = read_u16(ck + 8);
+            channels = read_u16(ck + 10);
+            rate = read_u32(ck + 12);
+            bits = read_u16(ck + 22);
+            // WAVE_FORMAT_EXTENSIBLE: real tag is the first two bytes of the subformat GUID
+            if (tag == 0xFFFE && ck_size >= 40 && avail >= 40) tag = read_u16(ck + 32);
+        } else if (std::memcmp(ck, "data", 4) == 0) {
+            data = ck + 8;
+            // Tolerate truncated files and streaming writers that leave the size at 0/-1
+            data_size = static_cast<uint32_t>(ck_size == 0 || ck_size > avail ? avail : ck_size);
+            break;
+        }
+        pos = body + ck_size + (ck_size & 1u);
+    }
+
+    if (channels == 0 || rate == 0) return fail(error, "missing fmt chunk");
+    if (!data) return fail(error, "missing data chunk");
+
+    SampleFormat fmt;
+    if (tag == 1 && bits == 16) fmt = SampleFormat::S16LE;
+    else if (tag == 1 && bits == 24) fmt = SampleFormat::S24_3LE;
+    else if (tag == 1 && bits == 32) fmt = SampleFormat::S32LE;
+    else if (tag == 3 && bits == 32) fmt = SampleFormat::Float32LE;
+    else return fail(error, "unsupported WAV encoding (tag " + std::to_string(tag) + ", " + std::to_string(bits) + " bits)");
+
+    const size_t frame_bytes = static_cast<size_t>(bytes_per_sample(fmt)) * channels;
+    const size_t frames = data_size / frame_bytes;
+
+    out.sample_rate = static_cast<int>(rate);
+    out.channels = channels;
+    out.format = fmt;
+    out.samples.resize(frames * channels);
+    convert_to_float(fmt, data, out.samples.data(), out.samples.size());
+    return true;
+}
+
+} // namespace tuner
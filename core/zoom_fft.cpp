@@ -61,6 +61,14 @@ bool ButterworthFilter::process_and_decimate(const std::complex<float>& input,
     return true;
 }
 
+float ButterworthFilter::dc_gain() const {
+    float g = 1.0f;
+    for (const auto& section : sections) {
+        g *= (section.b0 + section.b1 + section.b2) / (1.0f + section.a1 + section.a2);
+    }
+    return g;
+}
+
 void ButterworthFilter::reset() {
     for (auto& section : sections) {
         section.reset();
@@ -75,29 +83,41 @@ ZoomFFT::ZoomFFT(const ZoomFFTConfig& cfg)
       decimated_buffer(cfg.fft_size),
       oscillator_phase(1.0f, 0.0f),
       renorm_counter(0),
-      last_center_freq(440.0f) {
+      last_center_freq(440.0f),
+      baseband(static_cast<size_t>(std::max(1, cfg.fft_size))) {
     
-    filter.configure(config.sample_rate, config.decimation);
+    configure_filters(last_center_freq);
+    // Streaming runs on the audio thread: nothing it does may allocate
+    tuner::fft::prepare_fft(cfg.fft_size);
+}
+
+void ZoomFFT::configure_filters(float center_freq_hz) {
+    const int first = zoom_first_stage(config.sample_rate, config.decimation, center_freq_hz, config.span_cents);
+    filter.configure(config.sample_rate, first);
+    two_stage = first < config.decimation;
+    if (two_stage) {
+        filter2.configure(config.sample_rate / first, config.decimation / first);
+        stage_gain = 1.0f / filter.dc_gain();
+    }
 }
 
 ZoomFFT::~ZoomFFT() = default;
 
 std::vector<float> ZoomFFT::process(const float* input, int input_length, float center_freq_hz) {
+    std::vector<float> magnitudes(config.num_bins, 0.0f);
+    compute(input, input_length, center_freq_hz);
+    sample_bins(0, config.num_bins, magnitudes.data());
+    return magnitudes;
+}
+
+void ZoomFFT::compute(const float* input, int input_length, float center_freq_hz) {
+    has_spectrum = false;
     if (!input || input_length <= 0 || center_freq_hz <= 0) {
-        return std::vector<float>(config.num_bins, 0.0f);
+        return;
     }
     
-    // Store center frequency for magnitude sampling
-    last_center_freq = center_freq_hz;
-    
-    const float two_pi = 2.0f * M_PI;
-    const float omega = two_pi * center_freq_hz / static_cast<float>(config.sample_rate);
-    const std::complex<float> phase_increment(std::cos(-omega), std::sin(-omega));
-    
-    // Reset for new processing
-    filter.reset();
-    oscillator_phase = std::complex<float>(1.0f, 0.0f);
-    renorm_counter = 0;
+    // Restart the oscillator and filter at the first input sample
+    reset_stream(center_freq_hz);
     
     // Maximum samples we can process after decimation
     const int max_decimated = std::min(config.fft_size, input_length / config.decimation);
@@ -108,23 +128,8 @@ std::vector<float> ZoomFFT::process(const float* input, int input_length, float
     // Heterodyne mixing + filtering + decimation
     int decimated_count = 0;
     for (int i = 0; i < input_length && decimated_count < max_decimated; ++i) {
-        // Mix input with complex exponential to shift center frequency to DC
-        std::complex<float> mixed = oscillator_phase * input[i];
-        
-        // Update oscillator
-        oscillator_phase *= phase_increment;
-        
-        // Periodic renormalization to prevent numerical drift
-        if ((++renorm_counter & 8191) == 0) {
-            float mag = std::abs(oscillator_phase);
-            if (mag > 0.0f) {
-                oscillator_phase /= mag;
-            }
-        }
-        
-        // Filter and decimate
         std::complex<float> filtered;
-        if (filter.process_and_decimate(mixed, filtered)) {
+        if (mix_sample(input[i], filtered)) {
             decimated_buffer[decimated_count++] = filtered;
         }
     }
@@ -147,9 +152,82 @@ std::vector<float> ZoomFFT::process(const float* input, int input_length, float
     
     // Compute FFT
     tuner::fft::compute_fft_inplace(fft_buffer);
+    window_length = decimated_count;
+    has_spectrum = true;
+}
+
+bool ZoomFFT::mix_sample(float x, std::complex<float>& out) {
+    // Mix input with complex exponential to shift center frequency to DC
+    const std::complex<float> mixed = oscillator_phase * x;
+    
+    // Update oscillator
+    oscillator_phase *= phase_increment;
+    
+    // Periodic renormalization to prevent numerical drift
+    if ((++renorm_counter & 8191) == 0) {
+        float mag = std::abs(oscillator_phase);
+        if (mag > 0.0f) {
+            oscillator_phase /= mag;
+        }
+    }
     
-    // Sample magnitudes at desired cent offsets
-    return sample_magnitudes(fft_buffer);
+    // Filter and decimate
+    if (!two_stage) return filter.process_and_decimate(mixed, out);
+    std::complex<float> first;
+    return filter.process_and_decimate(mixed, first) && filter2.process_and_decimate(first * stage_gain, out);
+}
+
+void ZoomFFT::reset_stream(float center_freq_hz) {
+    // Store center frequency for magnitude sampling
+    last_center_freq = center_freq_hz;
+    const float omega = 2.0f * static_cast<float>(M_PI) * center_freq_hz / static_cast<float>(config.sample_rate);
+    phase_increment = std::complex<float>(std::cos(-omega), std::sin(-omega));
+    configure_filters(center_freq_hz);
+    oscillator_phase = std::complex<float>(1.0f, 0.0f);
+    renorm_counter = 0;
+    baseband_written = 0;
+}
+
+void ZoomFFT::push(const float* input, int input_length) {
+    if (!input || input_length <= 0) return;
+    const size_t n = baseband.size();
+    for (int i = 0; i < input_length; ++i) {
+        std::complex<float> filtered;
+        if (mix_sample(input[i], filtered)) {
+            baseband[baseband_written % n] = filtered;
+            ++baseband_written;
+        }
+    }
+}
+
+int ZoomFFT::baseband_size() const {
+    return static_cast<int>(std::min(baseband_written, baseband.size()));
+}
+
+void ZoomFFT::transform(int count) {
+    transform(*this, count);
+}
+
+void ZoomFFT::transform(const ZoomFFT& stream, int count) {
+    has_spectrum = false;
+    last_center_freq = stream.last_center_freq;
+    const int nw = std::min({std::max(0, count), stream.baseband_size(), config.fft_size});
+    std::fill(fft_buffer.begin(), fft_buffer.end(), std::complex<float>(0.0f, 0.0f));
+    if (nw <= 0) return;
+    
+    // Newest nw samples, oldest first, Hann windowed and zero-padded
+    const std::vector<std::complex<float>>& ring = stream.baseband;
+    const size_t n = ring.size();
+    const size_t start = stream.baseband_written - static_cast<size_t>(nw);
+    const float two_pi = 2.0f * M_PI;
+    for (int i = 0; i < nw; ++i) {
+        const float wv = (config.use_hann && nw > 1) ? 0.5f * (1.0f - std::cos(two_pi * i / (nw - 1))) : 1.0f;
+        fft_buffer[i] = ring[(start + static_cast<size_t>(i)) % n] * wv;
+    }
+    
+    tuner::fft::compute_fft_inplace(fft_buffer);
+    window_length = nw;
+    has_spectrum = true;
 }
 
 void ZoomFFT::apply_window(std::vector<std::complex<float>>& data) {
@@ -168,24 +246,27 @@ void ZoomFFT::compute_fft(std::vector<std::complex<float>>& data) {
     tuner::fft::compute_fft_inplace(data);
 }
 
-std::vector<float> ZoomFFT::sample_magnitudes(const std::vector<std::complex<float>>& spectrum) {
-    std::vector<float> magnitudes(config.num_bins, 0.0f);
+void ZoomFFT::sample_bins(int first_bin, int count, float* out) const {
+    const int b0 = std::max(0, first_bin);
+    const int b1 = std::min(config.num_bins, first_bin + count);
+    std::fill(out, out + std::max(0, count), 0.0f);
+    if (!has_spectrum) return;
+    const std::vector<std::complex<float>>& spectrum = fft_buffer;
     
     // This matches the exact logic from zoom_engine.cpp lines 166-185
     const float fsz = static_cast<float>(config.sample_rate) / static_cast<float>(config.decimation);
-    const float centsSpan = 240.0f;
-    const float centsMin = -120.0f;
+    const float centsSpan = 2.0f * config.span_cents;
+    const float centsMin = -config.span_cents;
     
     // We need center_freq_hz but it's not passed here - it's stored during processing
     float center_freq_hz = last_center_freq;  // We'll need to store this
     
-    for (int b = 0; b < config.num_bins; ++b) {
+    for (int b = b0; b < b1; ++b) {
         const float cents = centsMin + centsSpan * (static_cast<float>(b) / static_cast<float>(config.num_bins - 1));
         const float targetHzAbs = center_freq_hz * std::pow(2.0f, cents / 1200.0f);
         const float basebandHz = targetHzAbs - center_freq_hz;
         
         if (std::fabs(basebandHz) > (fsz * 0.5f)) { 
-            magnitudes[b] = 0.0f; 
             continue; 
         }
         
@@ -197,10 +278,114 @@ std::vector<float> ZoomFFT::sample_magnitudes(const std::vector<std::complex<flo
         
         const float v0 = std::abs(spectrum[i0]);
         const float v1 = std::abs(spectrum[i1]);
-        magnitudes[b] = v0 * (1.0f - frac) + v1 * frac;
+        out[b - first_bin] = v0 * (1.0f - frac) + v1 * frac;
     }
+}
+
+float ZoomFFT::refine_peak(float approx_hz, PeakEstimator method) const {
+    if (!has_spectrum || method == PeakEstimator::Grid || window_length < 2) return approx_hz;
+    const int n = config.fft_size;
+    const float fsz = static_cast<float>(config.sample_rate) / static_cast<float>(config.decimation);
+    auto bin = [&](int k) { return fft_buffer[((k % n) + n) % n]; };
     
-    return magnitudes;
+    // The sampled bins interpolate magnitudes linearly, so the FFT bin
+    // nearest the best sampled one is at or next to the local maximum
+    int k = static_cast<int>(std::lround((approx_hz - last_center_freq) / fsz * static_cast<float>(n)));
+    for (int step = 0; step < 4; ++step) {
+        if (std::abs(bin(k + 1)) > std::abs(bin(k))) ++k;
+        else if (std::abs(bin(k - 1)) > std::abs(bin(k))) --k;
+        else break;
+    }
+    const std::complex<float> bins[3] = {bin(k - 1), bin(k), bin(k + 1)};
+    const float delta = peak_offset(method, bins, k, window_length, n, config.use_hann);
+    return last_center_freq + (static_cast<float>(k) + delta) * fsz / static_cast<float>(n);
+}
+
+float ZoomFFT::phase_frequency(float approx_hz, int window, int lag, int count, float* variance_hz2) const {
+    if (variance_hz2) *variance_hz2 = 0.0f;
+    if (window < 2 || lag < 1 || baseband.empty()) return 0.0f;
+    // As many windows as the baseband holds, up to `count`
+    count = std::min(count, (baseband_size() - window) / lag + 1);
+    if (count < 3) return 0.0f;
+    
+    const size_t n = baseband.size();
+    const double fsz = static_cast<double>(config.sample_rate) / static_cast<double>(config.decimation);
+    const double omega = 2.0 * M_PI * (static_cast<double>(approx_hz) - last_center_freq) / fsz;
+    const std::complex<double> step = std::polar(1.0, -omega);
+    const std::complex<double> hann_step = std::polar(1.0, 2.0 * M_PI / (window - 1));
+    const size_t oldest = baseband_written - static_cast<size_t>(window) - static_cast<size_t>(count - 1) * lag;
+    
+    // Phases relative to the oldest window's start; windows oldest first
+    double phase = 0.0, prev = 0.0;
+    double sum_t = 0.0, sum_p = 0.0, sum_tt = 0.0, sum_tp = 0.0, sum_pp = 0.0;
+    for (int j = 0; j < count; ++j) {
+        const size_t offset = static_cast<size_t>(j) * lag;
+        std::complex<double> rot = std::polar(1.0, -omega * static_cast<double>(offset));
+        std::complex<double> hann(1.0, 0.0);
+        std::complex<double> acc(0.0, 0.0);
+        for (int i = 0; i < window; ++i) {
+            const double w = 0.5 * (1.0 - hann.real());
+            acc += std::complex<double>(baseband[(oldest + offset + static_cast<size_t>(i)) % n]) * (w * rot);
+            rot *= step;
+            hann *= hann_step;
+        }
+        if (std::abs(acc) <= 0.0) return 0.0f;
+        const double p = std::arg(acc);
+        if (j == 0) {
+            phase = p;
+        } else {
+            phase += std::remainder(p - prev, 2.0 * M_PI);
+        }
+        prev = p;
+        const double t = static_cast<double>(offset);
+        sum_t += t; sum_p += phase; sum_tt += t * t; sum_tp += t * phase; sum_pp += phase * phase;
+    }
+    
+    // Least-squares slope of phase against window start, in rad / sample
+    const double c = static_cast<double>(count);
+    const double stt = sum_tt - sum_t * sum_t / c;
+    const double stp = sum_tp - sum_t * sum_p / c;
+    const double spp = sum_pp - sum_p * sum_p / c;
+    if (stt <= 0.0) return 0.0f;
+    const double slope = stp / stt;
+    if (variance_hz2) {
+        // Overlapping windows share their noise, so the residuals understate
+        // it; about lag / window of the windows are independent
+        const double overlap = std::max(1.0, static_cast<double>(window) / lag);
+        const double residual = std::max(0.0, spp - slope * stp) / (c - 2.0);
+        const double hz_per_rad = fsz / (2.0 * M_PI);
+        *variance_hz2 = static_cast<float>(overlap * residual / stt * hz_per_rad * hz_per_rad);
+    }
+    return static_cast<float>(approx_hz + slope * fsz / (2.0 * M_PI));
+}
+
+void ZoomFFT::dtft_bins(int first_bin, int count, int window, std::complex<float>* out) const {
+    std::fill(out, out + std::max(0, count), std::complex<float>(0.0f, 0.0f));
+    const int nw = std::min({window, baseband_size(), config.fft_size});
+    if (count <= 0 || nw <= 0) return;
+    
+    // Same window as transform(); one rotator per bin, in double so the
+    // phase stays exact over the window
+    constexpr int MAX_BINS = 16;
+    count = std::min(count, MAX_BINS);
+    std::complex<double> rot[MAX_BINS], step[MAX_BINS], acc[MAX_BINS];
+    for (int b = 0; b < count; ++b) {
+        rot[b] = std::complex<double>(1.0, 0.0);
+        step[b] = std::polar(1.0, -2.0 * M_PI * static_cast<double>(first_bin + b) / config.fft_size);
+        acc[b] = std::complex<double>(0.0, 0.0);
+    }
+    const size_t n = baseband.size();
+    const size_t start = baseband_written - static_cast<size_t>(nw);
+    const float two_pi = 2.0f * M_PI;
+    for (int i = 0; i < nw; ++i) {
+        const float wv = (config.use_hann && nw > 1) ? 0.5f * (1.0f - std::cos(two_pi * i / (nw - 1))) : 1.0f;
+        const std::complex<double> x(baseband[(start + static_cast<size_t>(i)) % n] * wv);
+        for (int b = 0; b < count; ++b) {
+            acc[b] += x * rot[b];
+            rot[b] *= step[b];
+        }
+    }
+    for (int b = 0; b < count; ++b) out[b] = std::complex<float>(acc[b]);
 }
 
 float ZoomFFT::get_bin_frequency(int bin_index, float center_freq_hz) const {
@@ -209,8 +394,8 @@ float ZoomFFT::get_bin_frequency(int bin_index, float center_freq_hz) const {
     }
     
     // Calculate cents offset for this bin
-    const float cents_span = 240.0f;  // ±120 cents
-    const float cents_min = -120.0f;
+    const float cents_span = 2.0f * config.span_cents;
+    const float cents_min = -config.span_cents;
     float cents = cents_min + cents_span * (static_cast<float>(bin_index) / (config.num_bins - 1));
     
     // Convert to frequency
@@ -230,45 +415,113 @@ MultiRegionProcessor::MultiRegionProcessor(const ZoomFFTConfig& cfg)
 void MultiRegionProcessor::setup_for_note(float fundamental_hz) {
     for (int i = 0; i < NUM_HARMONICS; ++i) {
         harmonic_frequencies[i] = fundamental_hz * (i + 1);
-        
-        // Adaptive decimation based on frequency
+    }
+    // One front end for all regions, as far down as the highest analysed
+    // harmonic allows: by 4 at 48 kHz, proportionally more above
+    const int max_factor = 4 * std::max(1, base_config.sample_rate / 48000);
+    const int factor = max_front_decimation(base_config.sample_rate, std::min(harmonic_frequencies.back(), 5000.0f),
+                                            max_factor, base_config.span_cents);
+    front.configure(base_config.sample_rate, factor);
+
+    for (int i = 0; i < NUM_HARMONICS; ++i) {
+        // Adaptive decimation based on frequency, the rest of it after the front end
         ZoomFFTConfig harmonic_config = base_config;
-        harmonic_config.decimation = select_decimation(harmonic_frequencies[i]);
+        harmonic_config.sample_rate = base_config.sample_rate / factor;
+        harmonic_config.decimation = std::max(1, select_decimation(harmonic_frequencies[i], factor) / factor);
         
         // Recreate ZoomFFT with new config if decimation changed
-        if (harmonic_config.decimation != regions[i]->get_config().decimation) {
+        if (harmonic_config.decimation != regions[i]->get_config().decimation ||
+            harmonic_config.sample_rate != regions[i]->get_config().sample_rate) {
             regions[i] = std::make_unique<ZoomFFT>(harmonic_config);
         }
     }
 }
 
-int MultiRegionProcessor::select_decimation(float frequency_hz) const {
+int MultiRegionProcessor::select_decimation(float frequency_hz, int front_factor) const {
     // Cap analysis band to <= 5000 Hz per requirements
-    const float f_center = std::min(frequency_hz, 5000.0f);
-    // Zoom FFT inspects a ±120 cents window around the center.
-    // Max baseband offset = (2^(120/1200) - 1) * f_center ≈ 0.07177 * f_center
-    // So required baseband Nyquist >= 0.07177 * f_center → Fs_decimated >= 0.14354 * f_center
-    // Therefore: decimation <= Fs / (0.14354 * f_center)
-    const float cents_span_ratio = std::pow(2.0f, 120.0f / 1200.0f) - 1.0f; // ≈ 0.07177
-    const float required_fs_decimated = 2.0f * cents_span_ratio * std::max(1.0f, f_center); // ≈ 0.14354 * f
-    const float max_dec_by_bandwidth = static_cast<float>(base_config.sample_rate) / std::max(1.0f, required_fs_decimated);
+    return max_zoom_decimation(base_config.sample_rate, std::min(frequency_hz, 5000.0f), base_config.span_cents,
+                               front_factor);
+}
+
+namespace {
+// Joe filter: passband edge at 0.027 of its input rate. Content folding onto
+// the span must sit at least 2.1x that edge out (8th order: ~50 dB down).
+constexpr float FILTER_PASSBAND = 0.027f;
+constexpr float ALIAS_MARGIN = 2.1f * FILTER_PASSBAND;
+constexpr int MAX_STAGE_DECIMATION = 32;  // validated filter cap
+
+float span_width_hz(float frequency_hz, float span_cents) {
+    return std::max(1e-3f, (std::pow(2.0f, span_cents / 1200.0f) - 1.0f) * std::max(1.0f, frequency_hz));
+}
+
+// One filter stage at `fs`: the decimated band must hold ±span_hz, and
+// content at baseband offset fs_decimated - span_hz folds onto its edge
+int one_stage_limit(float fs, float span_hz) {
+    const float max_dec_by_bandwidth = fs / (2.0f * span_hz);
+    const float max_dec_by_alias = fs / (ALIAS_MARGIN * fs + span_hz);
+    const int d = static_cast<int>(std::floor(std::min(max_dec_by_bandwidth, max_dec_by_alias) + 1e-6f));
+    return std::clamp(d, 1, MAX_STAGE_DECIMATION);
+}
 
-    int d = static_cast<int>(std::floor(max_dec_by_bandwidth + 1e-6f));
-    if (d < 1) d = 1;
-    if (d > 32) d = 32; // validated filter cap
-    return d;
+// Largest first stage ahead of a second one: its output rate must put the
+// second filter's passband edge beyond the span, and what it lets through
+// must fold beyond the second filter's alias margin
+int first_stage_limit(float fs, float span_hz) {
+    const float by_passband = FILTER_PASSBAND * fs / span_hz;
+    const float by_alias = (1.0f - ALIAS_MARGIN) / ALIAS_MARGIN;
+    return std::clamp(static_cast<int>(std::floor(std::min(by_passband, by_alias) + 1e-6f)), 1, MAX_STAGE_DECIMATION);
+}
+} // namespace
+
+int max_zoom_decimation(int sample_rate, float frequency_hz, float span_cents, int front_factor) {
+    // Zoom FFT inspects a ±span_cents window around the center: at ±120 the
+    // largest baseband offset is (2^(120/1200) - 1) * f ≈ 0.07177 * f
+    const int front = std::max(1, front_factor);
+    const float fs = static_cast<float>(std::max(1, sample_rate)) / static_cast<float>(front);
+    const float span_hz = span_width_hz(frequency_hz, span_cents);
+    int d = one_stage_limit(fs, span_hz);
+    // A narrow span fits in the passband of a second filter stage at the
+    // first one's output rate, whose alias margin is that much narrower
+    const int first = first_stage_limit(fs, span_hz);
+    if (first > 1) d = std::max(d, first * one_stage_limit(fs / static_cast<float>(first), span_hz));
+    return d * front;
+}
+
+int zoom_first_stage(int sample_rate, int decimation, float frequency_hz, float span_cents) {
+    const float fs = static_cast<float>(std::max(1, sample_rate));
+    const float span_hz = span_width_hz(frequency_hz, span_cents);
+    if (decimation <= one_stage_limit(fs, span_hz)) return std::max(1, decimation);
+    for (int first = std::min(decimation - 1, first_stage_limit(fs, span_hz)); first > 1; --first) {
+        if (decimation % first == 0) return first;
+    }
+    return decimation;  // no usable split: one stage, as asked
+}
+
+int max_front_decimation(int sample_rate, float frequency_hz, int max_factor, float span_cents) {
+    const float f_center = std::max(1.0f, frequency_hz);
+    const float span_hz = span_width_hz(f_center, span_cents);
+    int f = PreDecimator::factor_for(sample_rate, f_center + span_hz, max_factor);
+    // The lanes' passband edge is at FILTER_PASSBAND of their input rate
+    while (f > 1 && span_hz > FILTER_PASSBAND * static_cast<float>(sample_rate) / static_cast<float>(f)) f /= 2;
+    return f;
 }
 
 std::vector<MultiRegionProcessor::RegionResult> 
 MultiRegionProcessor::process_all_regions(const float* input, int input_length) {
     std::vector<RegionResult> results;
     results.reserve(NUM_HARMONICS);
+
+    // Each block is pre-decimated once, from a fresh start as every region's compute() is
+    if (front.output_rate() == 0) front.configure(base_config.sample_rate, 1);
+    front.reset();
+    front_out.resize(static_cast<size_t>(front.max_output(std::max(0, input_length))));
+    const int reduced = front.process(input, input_length, front_out.data());
     
     for (int i = 0; i < NUM_HARMONICS; ++i) {
         RegionResult result;
         result.harmonic_number = i + 1;
         result.center_freq_hz = harmonic_frequencies[i];
-        result.magnitudes = regions[i]->process(input, input_length, result.center_freq_hz);
+        result.magnitudes = regions[i]->process(front_out.data(), reduced, result.center_freq_hz);
         results.push_back(std::move(result));
     }
     
@@ -0,0 +1,85 @@
+#include "zoom_scheduler.hpp"
+#include "zoom_fft.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tuner {
+
+namespace {
+
+// Hz -> cents at `f` for small offsets: 1200 / ln 2
+constexpr float CENTS_PER_RELATIVE_HZ = 1731.234f;
+
+int next_pow2(int n) {
+    int p = 1;
+    while (p < n && p < (1 << 30)) p <<= 1;
+    return p;
+}
+
+// Fill in what a schedule achieves at `center_hz`
+void describe(ZoomSchedule& s, float center_hz, unsigned int sample_rate) {
+    const float fs = static_cast<float>(std::max(1u, sample_rate));
+    const float f = std::max(1.0f, center_hz);
+    const float fs_dec = fs / static_cast<float>(std::max(1, s.decimation));
+    s.resolution_cents = CENTS_PER_RELATIVE_HZ / (std::max(1e-3f, s.window_seconds) * f);
+    s.bin_cents = CENTS_PER_RELATIVE_HZ * fs_dec / (static_cast<float>(std::max(1, s.fft_size)) * f);
+    // Complex mixer + 4 complex biquads per input sample, radix-2 FFT
+    const float input_samples = std::min(s.window_seconds * fs, static_cast<float>(s.fft_size) * s.decimation);
+    const float n = static_cast<float>(std::max(2, s.fft_size));
+    s.mflops = (input_samples * 46.0f + 5.0f * n * std::log2(n)) * 1e-6f;
+}
+
+} // namespace
+
+ZoomSchedule schedule_zoom(float center_hz, unsigned int sample_rate, const ZoomSchedulerConfig& config) {
+    ZoomSchedule s;
+    if (!(center_hz > 0.0f) || !std::isfinite(center_hz) || sample_rate == 0) {
+        describe(s, 440.0f, sample_rate ? sample_rate : 48000u);
+        return s;
+    }
+    const float fs = static_cast<float>(sample_rate);
+    // The same front end the pipeline will put ahead of the lanes
+    const int fs_in = static_cast<int>(sample_rate);
+    const int front = config.pre_decimation <= 1 ? 1 :
+        max_front_decimation(fs_in, center_hz, config.pre_decimation * std::max(1, fs_in / 48000), config.span_cents);
+    s.decimation = max_zoom_decimation(fs_in, center_hz, config.span_cents, front);
+
+    const float resolution = std::max(0.01f, config.resolution_cents);
+    s.window_seconds = std::clamp(CENTS_PER_RELATIVE_HZ / (resolution * center_hz),
+                                  config.min_window_seconds, std::max(config.min_window_seconds, config.max_window_seconds));
+
+    const float fs_dec = fs / static_cast<float>(s.decimation);
+    const int window_decimated = static_cast<int>(std::ceil(s.window_seconds * fs_dec));
+    const float bin_hz = std::max(0.001f, config.bin_cents) * center_hz / CENTS_PER_RELATIVE_HZ;
+    const int for_spacing = static_cast<int>(std::min(1e9f, std::ceil(fs_dec / bin_hz)));
+    s.fft_size = std::clamp(next_pow2(std::max(window_decimated, for_spacing)),
+                            next_pow2(std::max(2, config.min_fft_size)), next_pow2(std::max(2, config.max_fft_size)));
+    // A capped FFT holds less than the window: analyse only what fits
+    s.window_seconds = std::min(s.window_seconds, static_cast<float>(s.fft_size) / fs_dec);
+
+    describe(s, center_hz, sample_rate);
+    return s;
+}
+
+ZoomSchedule schedule_zoom(const AppSettings& settings, float center_hz, unsigned int sample_rate, int key) {
+    ZoomSchedulerConfig config;
+    config.resolution_cents = settings.zoom_resolution_cents;
+    config.bin_cents = settings.zoom_bin_cents;
+    config.max_window_seconds = settings.zoom_max_window_seconds;
+    config.span_cents = settings.zoom_span_cents;
+    ZoomSchedule s = schedule_zoom(center_hz, sample_rate, config);
+
+    for (const ZoomRegisterOverride& ov : settings.zoom_overrides) {
+        if (key < ov.first_key || key > ov.last_key) continue;
+        if (ov.fft_size > 0) s.fft_size = next_pow2(ov.fft_size);
+        if (ov.decimation > 0) s.decimation = ov.decimation;
+        if (ov.window_seconds > 0.0f) s.window_seconds = ov.window_seconds;
+        s.overridden = true;
+        describe(s, center_hz, sample_rate);
+        break;
+    }
+    return s;
+}
+
+} // namespace tuner
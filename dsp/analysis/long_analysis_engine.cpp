@@ -12,10 +12,11 @@ LongAnalysisEngine::~LongAnalysisEngine() {
     if (worker_.joinable()) worker_.join();
 }
 
-void LongAnalysisEngine::configure(int fft_size, int decimation, int num_bins) {
+void LongAnalysisEngine::configure(int fft_size, int decimation, int num_bins, float span_cents) {
     fft_size_ = std::max(128, fft_size);
     decimation_ = std::max(1, decimation);
     num_bins_ = std::max(16, num_bins);
+    span_cents_ = span_cents > 0.0f ? span_cents : 120.0f;
 }
 
 void LongAnalysisEngine::set_center_frequency(float hz) { center_freq_hz_ = hz; }
@@ -23,11 +24,20 @@ void LongAnalysisEngine::set_num_segments(int segments) { num_segments_ = std::m
 void LongAnalysisEngine::set_num_harmonics(int harmonics) { num_harmonics_ = std::max(1, std::min(8, harmonics)); }
 
 void LongAnalysisEngine::start_capture(float durationSec, int sampleRate) {
+    if (remote_capture_) {
+        if (durationSec <= 0.0f) return;
+        remote_capture_({durationSec, center_freq_hz_, fft_size_, decimation_, num_bins_, span_cents_, num_segments_, num_harmonics_});
+        capture_active_.store(true);
+        return;
+    }
     if (sampleRate <= 0 || durationSec <= 0.0f) return;
+    const int target = (int)std::round(durationSec * (float)sampleRate);
+    auto ring = std::make_shared<MirroredRingBuffer>();
+    if (!ring->allocate((size_t)std::max(1, target))) return;
     std::lock_guard<std::mutex> lock(cap_mutex_);
-    capture_buffer_.clear();
+    capture_ring_ = std::move(ring);
     capture_sample_rate_ = sampleRate;
-    target_samples_ = (int)std::round(durationSec * (float)sampleRate);
+    target_samples_ = target;
     buffer_ready_.store(false);
     capture_active_.store(true);
 }
@@ -36,11 +46,11 @@ void LongAnalysisEngine::feed_audio(const float* input, int num_samples, int sam
     if (!input || num_samples <= 0) return;
     if (!capture_active_.load()) return;
     std::lock_guard<std::mutex> lock(cap_mutex_);
+    if (!capture_ring_) return;
     if (capture_sample_rate_ == 0) capture_sample_rate_ = sample_rate;
-    capture_buffer_.insert(capture_buffer_.end(), input, input + num_samples);
-    if (target_samples_ > 0 && (int)capture_buffer_.size() >= target_samples_) {
-        buffer_to_process_ = capture_buffer_;
-        capture_buffer_.clear();
+    capture_ring_->push(input, (size_t)num_samples);
+    if (target_samples_ > 0 && capture_ring_->write_position() >= (uint64_t)target_samples_) {
+        ring_to_process_ = capture_ring_;
         capture_active_.store(false);
         buffer_ready_.store(true);
     }
@@ -48,37 +58,40 @@ void LongAnalysisEngine::feed_audio(const float* input, int num_samples, int sam
 
 void LongAnalysisEngine::poll_process() {
     if (!buffer_ready_.load() || processing_.load()) return;
-    std::vector<float> copy;
-    int sr = 0;
+    std::shared_ptr<const MirroredRingBuffer> ring;
+    int sr = 0, count = 0;
     {
         std::lock_guard<std::mutex> lock(cap_mutex_);
-        copy.swap(buffer_to_process_);
+        ring.swap(ring_to_process_);
         sr = capture_sample_rate_;
+        count = target_samples_;
         buffer_ready_.store(false);
     }
     if (worker_.joinable()) worker_.join();
-    launch_worker(std::move(copy), sr);
+    launch_worker(std::move(ring), count, sr);
 }
 
-void LongAnalysisEngine::launch_worker(std::vector<float> buffer_copy, int sample_rate) {
+void LongAnalysisEngine::launch_worker(std::shared_ptr<const MirroredRingBuffer> capture, int num_samples, int sample_rate) {
     processing_.store(true);
-    worker_ = std::thread(&LongAnalysisEngine::worker_proc, this, std::move(buffer_copy), sample_rate);
+    worker_ = std::thread(&LongAnalysisEngine::worker_proc, this, std::move(capture), num_samples, sample_rate);
 }
 
-void LongAnalysisEngine::worker_proc(std::vector<float> buffer, int sample_rate) {
-    // Compute one full FFT on captured buffer using FFT utils
+void LongAnalysisEngine::worker_proc(std::shared_ptr<const MirroredRingBuffer> capture, int num_samples, int sample_rate) {
+    // Compute one full FFT on the newest num_samples of the capture using FFT utils
     // DC removal and Hann window
-    const int N = (int)buffer.size();
+    const int N = capture ? std::min(num_samples, (int)capture->size()) : 0;
+    const float* buffer = capture ? capture->latest((size_t)N) : nullptr;
     if (N <= 0 || sample_rate <= 0) {
         spectrum_h1_.assign(num_bins_, 0.0f);
         harmonic_mags_.assign(num_harmonics_, 0.0f);
         harmonic_results_.clear();
         B_estimate_ = 0.0f;
+        results_version_.fetch_add(1);
         processing_.store(false);
         return;
     }
     // Remove mean to mitigate DC picking
-    double mean = 0.0; for (float v : buffer) mean += v; mean /= std::max(1, N);
+    double mean = 0.0; for (int i = 0; i < N; ++i) mean += buffer[i]; mean /= std::max(1, N);
     std::vector<std::complex<float>> data;
     data.reserve(N);
     const float two_pi = 6.283185307179586f;
@@ -179,11 +192,14 @@ void LongAnalysisEngine::worker_proc(std::vector<float> buffer, int sample_rate)
 
     // --- PFD-style refinement (Rauhala et al. 2007) ---
     // Build candidate peaks by subbands of width 5*f1 and take top 10 local maxima per subband
+    // Local maxima more than 34 dB under the strongest partial are noise; left
+    // in, they fill the subbands and pull the trend once B overshoots
+    const float peak_floor = 0.02f * std::max(vmax0, *std::max_element(harmonic_mags_.begin(), harmonic_mags_.end()));
     auto collect_local_maxima = [&](int a, int b){
         std::vector<std::pair<int,float>> loc;
         a = std::max(1, a); b = std::min(half - 2, b);
         for (int k = a + 1; k < b; ++k) {
-            if (mags[k] > mags[k - 1] && mags[k] > mags[k + 1]) {
+            if (mags[k] > peak_floor && mags[k] > mags[k - 1] && mags[k] > mags[k + 1]) {
                 loc.emplace_back(k, mags[k]);
             }
         }
@@ -238,25 +254,33 @@ void LongAnalysisEngine::worker_proc(std::vector<float> buffer, int sample_rate)
         if (pos > neg) return +1; if (neg > pos) return -1; return 0;
     };
 
-    // Iterate B
+    // Iterate B: step it in decades against the trend of D_k, halving the step
+    // at each reversal. D_k = predicted - measured grows with k when B is too
+    // high. A step that leaves fewer than two partials in reach is undone and
+    // halved rather than ending the search there.
     float Bhat = std::max(1e-6f, B_estimate_ > 0.0f ? B_estimate_ : 1e-4f);
-    float step = 1.0f; // decades
-    int last_sign = 0;
     std::vector<float> Dtmp;
-    for (int it = 0; it < 40; ++it) {
-        compute_Dk(Bhat, f1_est, Dtmp);
-        int s = trend_sign(Dtmp);
-        if (s == 0) break;
-        if (last_sign != 0 && s != last_sign) step *= 0.5f;
-        last_sign = s;
-        float factor = std::pow(10.0f, (s > 0 ? +step : -step));
-        Bhat *= factor;
-        Bhat = std::max(0.0f, Bhat);
-        if (step < 1e-4f) break;
-    }
+    auto fit_B = [&](float step) {
+        int last_sign = 0;
+        for (int it = 0; it < 40 && step >= 1e-4f; ++it) {
+            compute_Dk(Bhat, f1_est, Dtmp);
+            int s = trend_sign(Dtmp);
+            if (s == 0) {
+                if (last_sign == 0) break;
+                Bhat *= std::pow(10.0f, last_sign > 0 ? step : -step);
+                step *= 0.5f;
+                Bhat *= std::pow(10.0f, last_sign > 0 ? -step : step);
+                continue;
+            }
+            if (last_sign != 0 && s != last_sign) step *= 0.5f;
+            last_sign = s;
+            Bhat *= std::pow(10.0f, (s > 0 ? -step : +step));
+        }
+    };
+    fit_B(1.0f);
 
     // Optional: refine f1 using convexity (mean of first half of Dk)
-    float mu = 0.005f; last_sign = 0;
+    float mu = 0.005f; int last_sign = 0;
     for (int it = 0; it < 100; ++it) {
         compute_Dk(Bhat, f1_est, Dtmp);
         if (Dtmp.empty()) break;
@@ -266,22 +290,12 @@ void LongAnalysisEngine::worker_proc(std::vector<float> buffer, int sample_rate)
         if (s == 0) break;
         if (last_sign != 0 && s != last_sign) mu *= 0.5f;
         last_sign = s;
-        f1_est *= (1.0f + (s > 0 ? +mu : -mu));
+        // Predictions above the measured partials mean f1 is too high
+        f1_est *= (1.0f + (s > 0 ? -mu : +mu));
         if (mu < 1e-5f) break;
     }
-    // Re-run B iteration with refined f1
-    step = 1.0f; last_sign = 0;
-    for (int it = 0; it < 40; ++it) {
-        compute_Dk(Bhat, f1_est, Dtmp);
-        int s = trend_sign(Dtmp);
-        if (s == 0) break;
-        if (last_sign != 0 && s != last_sign) step *= 0.5f;
-        last_sign = s;
-        float factor = std::pow(10.0f, (s > 0 ? +step : -step));
-        Bhat *= factor;
-        Bhat = std::max(0.0f, Bhat);
-        if (step < 1e-4f) break;
-    }
+    // Re-run B iteration with refined f1; B is already close, so start small
+    fit_B(0.1f);
     B_estimate_ = Bhat;
 
     // Refinement pass: re-pick peaks around predicted inharmonic targets using B
@@ -368,7 +382,7 @@ void LongAnalysisEngine::worker_proc(std::vector<float> buffer, int sample_rate)
 
     // Downsample display spectrum around fundamental using bins mapping similar to ZoomFFT
     spectrum_h1_.assign(num_bins_, 0.0f);
-    const float centsMin = -120.0f, centsSpan = 240.0f;
+    const float centsMin = -span_cents_, centsSpan = 2.0f * span_cents_;
     for (int b = 0; b < num_bins_; ++b) {
         float cents = centsMin + centsSpan * ((float)b / (float)(num_bins_ - 1));
         float targetHz = f0 * std::pow(2.0f, cents / 1200.0f);
@@ -381,9 +395,31 @@ void LongAnalysisEngine::worker_proc(std::vector<float> buffer, int sample_rate)
             spectrum_h1_[b] = v0 * (1.0f - frac) + v1 * frac;
         }
     }
+    results_version_.fetch_add(1);
     processing_.store(false);
 }
 
+void LongAnalysisEngine::snapshot(LongAnalysisSnapshot& out) const {
+    out.version = results_version_.load();
+    out.B = B_estimate_;
+    out.num_bins = std::min((int)spectrum_h1_.size(), LongAnalysisSnapshot::MAX_BINS);
+    std::copy(spectrum_h1_.begin(), spectrum_h1_.begin() + out.num_bins, out.spectrum);
+    out.num_harmonics = std::min((int)harmonic_mags_.size(), LongAnalysisSnapshot::MAX_HARMONICS);
+    std::copy(harmonic_mags_.begin(), harmonic_mags_.begin() + out.num_harmonics, out.harmonic_mags);
+    out.num_results = std::min((int)harmonic_results_.size(), LongAnalysisSnapshot::MAX_HARMONICS);
+    std::copy(harmonic_results_.begin(), harmonic_results_.begin() + out.num_results, out.results);
+}
+
+void LongAnalysisEngine::apply_snapshot(const LongAnalysisSnapshot& in) {
+    if (processing_.load()) return;
+    spectrum_h1_.assign(in.spectrum, in.spectrum + std::max(0, std::min(in.num_bins, LongAnalysisSnapshot::MAX_BINS)));
+    harmonic_mags_.assign(in.harmonic_mags, in.harmonic_mags + std::max(0, std::min(in.num_harmonics, LongAnalysisSnapshot::MAX_HARMONICS)));
+    harmonic_results_.assign(in.results, in.results + std::max(0, std::min(in.num_results, LongAnalysisSnapshot::MAX_HARMONICS)));
+    B_estimate_ = in.B;
+    capture_active_.store(false);
+    results_version_.fetch_add(1);
+}
+
 } // namespace gui
 
 
@@ -2,13 +2,30 @@
 
 #include <vector>
 #include <atomic>
+#include <cstdint>
+#include <functional>
 #include <thread>
 #include <mutex>
 #include <memory>
 #include "fft/fft_utils.hpp"
+#include "mirrored_ring.hpp"
 
 namespace gui {
 
+// Parameters of a capture, as handed to a remote engine
+struct LongCaptureRequest {
+    float seconds = 0.0f;
+    float center_hz = 0.0f;
+    int fft_size = 0;
+    int decimation = 0;
+    int num_bins = 0;
+    float span_cents = 0.0f;
+    int num_segments = 0;
+    int num_harmonics = 0;
+};
+
+struct LongAnalysisSnapshot;
+
 // LongAnalysisEngine captures a few seconds of audio and performs high-resolution
 // analysis using multiple ZoomFFT instances centered at the fundamental and its
 // harmonics. Results include a detailed spectrum for H1 and bar magnitudes for
@@ -18,7 +35,8 @@ public:
     LongAnalysisEngine();
     ~LongAnalysisEngine();
 
-    void configure(int fft_size, int decimation, int num_bins);
+    // `span_cents`: the H1 display spectrum covers ±span_cents around the fundamental
+    void configure(int fft_size, int decimation, int num_bins, float span_cents = 120.0f);
     void set_center_frequency(float hz);
     void set_num_segments(int segments);       // time averaging 1..8
     void set_num_harmonics(int harmonics);     // 1..8
@@ -47,16 +65,27 @@ public:
     float inharmonicity_B() const { return B_estimate_; }
 
     bool is_capturing() const { return capture_active_.load(); }
+
+    // Remote mode: captures run in another process. start_capture() passes the
+    // request to `start` and the engine reports capturing until
+    // apply_snapshot() delivers the result.
+    void set_remote_capture(std::function<void(const LongCaptureRequest&)> start) { remote_capture_ = std::move(start); }
+    // Fixed-size copy of the current results (for shared memory)
+    void snapshot(LongAnalysisSnapshot& out) const;
+    void apply_snapshot(const LongAnalysisSnapshot& in);
     bool is_processing() const { return processing_.load(); }
+    // Incremented each time a worker finishes; results are stable until the next capture is processed
+    uint64_t results_version() const { return results_version_.load(); }
 
 private:
-    void launch_worker(std::vector<float> buffer_copy, int sample_rate);
-    void worker_proc(std::vector<float> buffer, int sample_rate);
+    void launch_worker(std::shared_ptr<const tuner::MirroredRingBuffer> capture, int num_samples, int sample_rate);
+    void worker_proc(std::shared_ptr<const tuner::MirroredRingBuffer> capture, int num_samples, int sample_rate);
 
     // Config
     int fft_size_ = 16384;
     int decimation_ = 16;
     int num_bins_ = 1200;
+    float span_cents_ = 120.0f;
     float center_freq_hz_ = 440.0f;
     int num_segments_ = 4;      // time segments for averaging (1..8)
     int num_harmonics_ = 8;     // harmonics to analyze (1..8)
@@ -65,15 +94,20 @@ private:
     std::atomic<bool> capture_active_{false};
     int target_samples_ = 0;
     int capture_sample_rate_ = 0;
-    std::vector<float> capture_buffer_;
+    // Sized once per capture so feed_audio never allocates; a new capture gets
+    // a fresh ring while the worker may still be reading the previous one
+    std::shared_ptr<tuner::MirroredRingBuffer> capture_ring_;
     std::mutex cap_mutex_;
     std::atomic<bool> buffer_ready_{false};
-    std::vector<float> buffer_to_process_;
+    std::shared_ptr<const tuner::MirroredRingBuffer> ring_to_process_;
 
     // Processing
     std::atomic<bool> processing_{false};
+    std::atomic<uint64_t> results_version_{0};
     std::thread worker_;
 
+    std::function<void(const LongCaptureRequest&)> remote_capture_;
+
     // Outputs
     std::vector<float> spectrum_h1_;
     std::vector<float> harmonic_mags_;
@@ -81,6 +115,21 @@ private:
     float B_estimate_ = 0.0f;
 };
 
+// LongAnalysisEngine results without heap members; trivially copyable
+struct LongAnalysisSnapshot {
+    static constexpr int MAX_BINS = 1200;
+    static constexpr int MAX_HARMONICS = 8;
+
+    uint64_t version = 0;   // results_version() of the producing engine
+    float B = 0.0f;
+    int num_bins = 0;
+    float spectrum[MAX_BINS] = {};
+    int num_harmonics = 0;
+    float harmonic_mags[MAX_HARMONICS] = {};
+    int num_results = 0;
+    LongAnalysisEngine::HarmonicResult results[MAX_HARMONICS] = {};
+};
+
 } // namespace gui
 
 
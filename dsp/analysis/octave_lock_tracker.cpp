@@ -30,7 +30,8 @@ void OctaveLockTracker::reset() {
 
 void OctaveLockTracker::push_frame(float f0_hz, float f2_hz,
                                    float mag0, float mag2,
-                                   float snr0, float snr2) {
+                                   float snr0, float snr2,
+                                   float var0, float var2) {
     if (locked_) return;
     if (++frame_counter_ % std::max(1, cfg_.capture_period_frames) != 0) return;
     last_capture_valid_ = false;
@@ -40,6 +41,10 @@ void OctaveLockTracker::push_frame(float f0_hz, float f2_hz,
     if (!finite_pos(mag0) || !finite_pos(mag2)) { last_capture_reason_ = "invalid mag"; return; }
     if (!finite_pos(snr0) || !finite_pos(snr2)) { last_capture_reason_ = "invalid snr"; return; }
     if (snr0 < cfg_.snr_min_linear || snr2 < cfg_.snr_min_linear) { last_capture_reason_ = "snr too low"; return; }
+    // Partials whose frequency is still moving (strike transient, beating)
+    // show up as a large spread of the phase-advance estimate
+    if (cfg_.max_sigma_cents > 0.0f && var0 > 0.0f && var2 > 0.0f &&
+        std::sqrt(var0 + var2) > cfg_.max_sigma_cents) { last_capture_reason_ = "unstable"; return; }
     float mn = std::min(mag0, mag2), mx = std::max(mag0, mag2);
     if (mn < cfg_.strength_balance_min * mx) { last_capture_reason_ = "unbalanced"; return; }
 
@@ -7,7 +7,7 @@
 namespace gui {
 
 struct OctaveLockConfig {
-    int capture_period_frames = 40;     // take one sample every N frames
+    int capture_period_frames = 5;      // take one sample every N frames (analysis frames, 100/s by default)
     int max_captures = 10;              // keep last K captures
     float snr_min_linear = 1.5f;        // require peak/mean >= this for both partials (≈ 3.5 dB)
     float strength_balance_min = 0.0f;  // 0 disables balance gate
@@ -15,16 +15,20 @@ struct OctaveLockConfig {
     float band_high_ratio = 0.95f;      // drop very top 5%
     float mad_threshold_cents = 0.4f;   // freeze threshold on MAD
     float cents_plausible_abs = 15.0f;  // discard if |2:1 cents| exceeds this
+    float max_sigma_cents = 1.0f;       // discard if the phase estimates' 2:1 spread exceeds this (0 disables)
 };
 
 class OctaveLockTracker {
 public:
     explicit OctaveLockTracker(const OctaveLockConfig& cfg = OctaveLockConfig{}) : cfg_(cfg) {}
 
-    // Push per-frame measurements; only sampled every capture_period_frames
+    // Push per-frame measurements; only sampled every capture_period_frames.
+    // var0 / var2: variance in cents^2 of each partial's phase-advance
+    // frequency (LaneMeasurement::phase_variance); 0 = unknown, not gated.
     void push_frame(float f0_hz, float f2_hz,
                     float mag0, float mag2,
-                    float snr0_linear, float snr2_linear);
+                    float snr0_linear, float snr2_linear,
+                    float var0_cents2 = 0.0f, float var2_cents2 = 0.0f);
 
     bool has_estimate() const { return locked_ || !captures_.empty(); }
     bool locked() const { return locked_; }
@@ -5,25 +5,33 @@
 #include <cmath>
 #include <algorithm>
 #include <array>
-#include <deque>
 #include <memory>
 #include <unordered_map>
 #include <tuple>
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <string>
 #include "views/spectrum_view.hpp"
 #include "views/waterfall_view.hpp"
 #include "windows/settings_window.hpp"
 #include "app_settings.hpp"
 #include "app_settings_io.hpp"
+#include "latency_calibrator.hpp"
 #include "session_settings.hpp"
 #include "pages/landing_page.hpp"
 #include "pages/new_session_setup.hpp"
 #include "pages/mic_setup.hpp"
-#include "zoom_fft.hpp"
+#include "analysis_pipeline.hpp"
+#include "zoom_scheduler.hpp"
+#include "spsc_ring.hpp"
+#include "triple_buffer.hpp"
+#include "analysis_frame.hpp"
+#include "shm_ipc.hpp"
 #include "fft/fft_utils.hpp"
 #include "views/concentric_view.hpp"
+#include "views/keyboard_view.hpp"
 #include "analysis/long_analysis_engine.hpp"
 #include "views/long_analysis_view.hpp"
 #include "analysis/inharmonicity_window.hpp"
@@ -40,26 +48,20 @@
 
 using namespace tuner;
 
-// GUI uses core ZoomFFT; no DSP here
+// GUI uses the core AnalysisPipeline; no DSP here
+
+// Follow pitch: frames with the coarse pitch's partial off the span before the centre moves
+constexpr int RECENTER_FRAMES = 3;
 
 class TunerGUI {
 public:
-    TunerGUI() : center_frequency(440.0f) {
-        
-        // Setup audio
-        
-    audio_config.device_name = "hw:1,0";
-        audio_config.sample_rate = 48000;
-        audio_config.period_size = 64; // lower latency callbacks
-        
-        // Default zoom parameters are configured in cfg_core when processing
-
-        audio_input = createAudioInput(audio_config);
-        audio_input->set_process_callback([this](const float* input, int num_samples) {
-            this->process_audio(input, num_samples);
-        });
-    }
+    // The capture device is opened in init_gui(), from the saved settings
+    TunerGUI() : center_frequency(440.0f) {}
     
+    // Use a separate DSP engine (tuner_cli --shm NAME) instead of the local
+    // audio input. Call before run().
+    void attach_engine(const std::string& name) { engine_name = name; }
+
     bool init_gui() {
         // Initialize GLFW
         if (!glfwInit()) return false;
@@ -126,10 +128,19 @@ public:
 
         // Load settings (ignore errors)
         load_settings(settings_path, settings);
+        // Open the configured capture device with its calibrated period
+        // settings; an attached engine owns the device instead
+        if (engine_name.empty()) {
+            AudioConfig cfg = audio_config;
+            if (!settings.audio_device.empty()) cfg.device_name = settings.audio_device;
+            apply_audio_profile(settings, cfg);
+            reopen_audio(cfg);
+        }
         center_frequency = settings.center_frequency_hz;
         if (!(center_frequency > 0.0f) || !std::isfinite(center_frequency)) {
             center_frequency = 440.0f;
         }
+        pipeline.set_center_frequency(center_frequency);
         precise_fft_size = settings.precise_fft_size;
         precise_decimation = settings.precise_decimation;
         precise_window_seconds = settings.precise_window_seconds;
@@ -153,7 +164,26 @@ public:
     void run() {
         if (!init_gui()) return;
         
-        if (!audio_input->start()) {
+        if (!engine_name.empty()) {
+            // The engine owns the audio device; this process only draws
+            if (!engine_link.attach(engine_name)) {
+                std::cerr << "No tuner engine at shared memory '" << engine_name
+                          << "' (start it with tuner_cli --shm " << engine_name << ")\n";
+                return;
+            }
+            long_engine.set_remote_capture([this](const gui::LongCaptureRequest& req) {
+                tuner::EngineCommand cmd;
+                cmd.type = tuner::EngineCommandType::StartLongCapture;
+                cmd.seconds = req.seconds;
+                cmd.center_hz = req.center_hz;
+                cmd.fft_size = req.fft_size;
+                cmd.decimation = req.decimation;
+                cmd.span_cents = req.span_cents;
+                cmd.segments = req.num_segments;
+                cmd.harmonics = req.num_harmonics;
+                engine_link.send(cmd);
+            });
+        } else if (!audio_input->start()) {
             std::cerr << "Failed to start audio\n";
             return;
         }
@@ -174,6 +204,10 @@ public:
             
             
             render_gui();
+            pipeline.set_center_frequency(center_frequency);
+            update_zoom_config();
+            update_analysis_subscriptions();
+            if (engine_link.is_attached()) send_engine_controls();
             
             // Rendering
             ImGui::Render();
@@ -206,7 +240,10 @@ public:
         save_settings(settings_path, settings);
 
         // Cleanup
-        audio_input->stop();
+        calibration_cancel.store(true);
+        if (calibration_thread.joinable()) calibration_thread.join();
+        if (audio_input) audio_input->stop();
+        engine_link.detach();
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
@@ -215,6 +252,80 @@ public:
     }
     
 private:
+    // Replace the audio input with one opened from `cfg` (not started)
+    void reopen_audio(const AudioConfig& cfg) {
+        if (audio_input) audio_input->stop();
+        audio_config = cfg;
+        audio_input = createAudioInput(cfg);
+        audio_input->set_process_callback([this](const float* input, int num_samples) {
+            this->process_audio(input, num_samples);
+        });
+        zoom_config = tuner::AnalysisPipelineConfig{0, 0, 0.0f};  // rebuilt for the new device's rate
+    }
+
+    // Sweep period settings for cfg.device_name with the live DSP as load
+    void start_latency_calibration(const AudioConfig& cfg) {
+        if (calibration_thread.joinable()) return;
+        if (engine_link.is_attached()) {
+            std::lock_guard<std::mutex> lock(calibration_mutex);
+            calibration_status.message = "The attached engine owns the audio device; calibrate on the engine host";
+            return;
+        }
+        audio_input->stop();  // the sweep needs the device to itself
+        calibration_config = cfg;
+        {
+            std::lock_guard<std::mutex> lock(calibration_mutex);
+            calibration_status.running = true;
+            calibration_status.progress = 0.0f;
+            calibration_status.trials.clear();
+            calibration_status.message = "Calibrating " + cfg.device_name + "...";
+        }
+        calibration_cancel.store(false);
+        calibration_done.store(false);
+        calibration_thread = std::thread([this, cfg]() {
+            LatencyCalibrator calibrator(cfg);
+            CalibrationResult res = calibrator.run(
+                [this](const float* input, int num_samples) { this->process_audio(input, num_samples); },
+                [this](const CalibrationTrial& t, int index, int total) {
+                    std::lock_guard<std::mutex> lock(calibration_mutex);
+                    calibration_status.trials.push_back(t);
+                    calibration_status.progress = (float)(index + 1) / (float)std::max(1, total);
+                },
+                &calibration_cancel);
+            std::lock_guard<std::mutex> lock(calibration_mutex);
+            calibration_result = std::move(res);
+            calibration_done.store(true);
+        });
+    }
+
+    // UI thread: persist the calibration result and reopen the device
+    void poll_latency_calibration() {
+        if (!calibration_done.load()) return;
+        calibration_thread.join();
+        calibration_done.store(false);
+        AudioConfig cfg = calibration_config;
+        {
+            std::lock_guard<std::mutex> lock(calibration_mutex);
+            calibration_status.running = false;
+            if (calibration_result.found) {
+                const CalibrationTrial& best = calibration_result.best_trial;
+                store_audio_profile(settings, cfg.device_name, best);
+                settings.audio_device = cfg.device_name;
+                save_settings(settings_path, settings);
+                apply_audio_profile(settings, cfg);
+                char msg[160];
+                std::snprintf(msg, sizeof(msg), "Saved %u x %u (%.2f ms, load %.2f avg / %.2f peak)",
+                              best.negotiated.period_size, best.negotiated.num_periods, best.latency_ms,
+                              best.avg_load, best.peak_load);
+                calibration_status.message = msg;
+            } else {
+                calibration_status.message = "No stable configuration found; keeping current settings";
+            }
+        }
+        reopen_audio(cfg);
+        audio_input->start();
+    }
+
     enum class AppPage { Landing, NewSessionSetup, Main };
     AppPage current_page = AppPage::Landing;
     tuner::SessionSettings current_session;
@@ -225,32 +336,70 @@ private:
     AudioConfig audio_config;
     std::unique_ptr<IAudioInput> audio_input;
     int frontend_decimation = 1; // fixed at no decimation
-    std::deque<float> input_ring;
+    tuner::AnalysisPipeline pipeline; // zoom lanes + input history (audio thread)
     unsigned int last_actual_fs = 0;
-    unsigned int last_effective_fs = 0;
-    int last_window_samples = 0;
-    int last_nz = 0;
     // Precise mode controls (runtime adjustable)
     int precise_fft_size = 16384;
     int precise_decimation = 16;
     float precise_window_seconds = 0.35f; // cap precise input to ~350 ms for responsiveness
     int precise_fft_idx = 3;  // 0:2048, 1:4096, 2:8192, 3:16384
-    int last_required_samples = 0;
-    int last_use_fft_size = 0;
-    int last_use_decimation = 0;
+    // Zoom settings in effect (UI thread); the pipeline builds them here and
+    // process_audio swaps them in
+    tuner::ZoomSchedule zoom_schedule;
+    tuner::AnalysisPipelineConfig zoom_config{0, 0, 0.0f};  // nothing requested yet
     
     // Display data
     std::vector<float> current_spectrum;
     gui::WaterfallView waterfall_view;
     gui::ConcentricView concentric_view;
+    gui::KeyboardView keyboard_view;
     gui::LongAnalysisView long_view;
     
     float peak_frequency = 440.0f;
     float peak_magnitude = 0.0f;
-    float last_mag0 = 0.0f, last_mag2 = 0.0f;
-    float last_snr0_linear = 0.0f, last_snr2_linear = 0.0f;
     int frames_processed = 0;
     float last_rms = 0.0f;
+
+    // DSP -> UI hand-off. The audio thread publishes one AnalysisFrame per
+    // analysis hop; the UI acquires the newest and copies out what it draws.
+    tuner::TripleBuffer<tuner::AnalysisFrame> analysis_frames;
+    uint64_t last_frame_seq = 0;  // UI thread: frame currently shown
+    tuner::SpscRing<gui::NotesStateReading> lane_readings{256};
+    unsigned int shown_sample_rate = 0;  // of the frame currently shown
+    tuner::AnalysisNodeMask shown_nodes = 0;
+    std::array<float, tuner::ANALYSIS_NODE_COUNT> shown_node_us{};
+    std::array<float, tuner::ANALYSIS_NODE_COUNT> node_avg_us{};
+    int shown_hop_samples = 0;       // STFT hop and window of the frame shown
+    int shown_window_samples = 0;
+    bool shown_lock_f0 = false;      // lanes tracked from DTFT bins in the frame shown
+    int shown_strikes = 0;           // strikes key detection had confirmed by the frame shown
+    int off_span_frames = 0;         // follow_pitch: frames in a row with the coarse pitch's partial off the span
+    float shown_coarse_f0 = 0.0f;    // coarse pitch of the frame shown (0 = nothing periodic)
+    float shown_periodicity = 0.0f;
+    bool shown_zoom_gated = false;
+    bool shown_lock_center = false;
+    uint64_t shown_capture_ns = 0;
+    bool shown_idle = false;         // idle_gate: the frame shown only measured the level
+    float shown_idle_seconds = 0.0f; // and over the run, audio time idle and DSP time saved
+    float shown_idle_saved = 0.0f;
+    uint64_t shown_capture_position = 0;
+    float dsp_load_avg = 0.0f;       // pipeline time per second of audio
+    tuner::StrikePhase shown_strike_phase = tuner::StrikePhase::Waiting;
+    int shown_strike_count = 0;
+    float shown_strike_age = 0.0f;
+    float frame_rate_avg = 0.0f;     // DSP frames per second
+    bool show_analysis_graph = false;
+
+    // Attached to a separate engine process (--attach NAME): frames and long
+    // analysis results come from shared memory, controls go back as commands
+    std::string engine_name;
+    tuner::ShmClientChannel engine_link;
+    tuner::AnalysisFrame attached_frame;
+    gui::LongAnalysisSnapshot attached_long;
+    uint64_t attached_frame_version = 0;
+    uint64_t attached_long_version = 0;
+    float sent_center_hz = 0.0f;
+    tuner::AnalysisNodeMask sent_demand = 0;
     std::atomic<int> last_callback_frames{0};
     gui::SpectrumView spectrum_view; // owns its own options
     gui::SettingsPage settings_page;
@@ -271,6 +420,7 @@ private:
     bool show_concentric_settings = false;
     bool show_long_settings = false;
     bool show_inharmonicity = false;
+    bool show_keyboard_overview = false;
     int ui_mode = 0; // 0: Desktop, 1: Kiosk Landscape, 2: Kiosk Portrait
     // Waterfall speed control: update one row every N audio frames (1 = fastest)
     int waterfall_stride = 1;
@@ -279,6 +429,15 @@ private:
     bool show_settings_page = false;
     gui::CommandRegistry command_registry;
 
+    // Latency calibration (runs on its own thread while the device is closed)
+    gui::MicCalibrationStatus calibration_status;
+    std::mutex calibration_mutex;
+    std::thread calibration_thread;
+    std::atomic<bool> calibration_done{false};
+    std::atomic<bool> calibration_cancel{false};
+    AudioConfig calibration_config;
+    tuner::CalibrationResult calibration_result;
+
     // Long analysis state
     float long_capture_seconds = 3.0f; // seconds to capture
     int long_num_segments = 4; // 1..8
@@ -302,226 +461,345 @@ private:
     
     void process_audio(const float* input, int num_samples) {
         last_callback_frames.store(num_samples);
-        // Track actual sample rate and reflect front-end decimation
+        // Track actual sample rate (no frontend decimation)
         const unsigned int actual_fs = audio_input->get_config().sample_rate;
-        const unsigned int effective_fs = actual_fs; // no frontend decimation
-        // sample rate for core zoom fft is set when constructing cfg_core
         last_actual_fs = actual_fs;
-        last_effective_fs = effective_fs;
 
-        // Append front-end decimated samples to ring buffer
-        if (input && num_samples > 0) {
-            for (int i = 0; i < num_samples; ++i) {
-                input_ring.push_back(input[i]);
-            }
-        }
         // Feed long analysis engine (safe when idle)
         long_engine.feed_audio(input, num_samples, (int)last_actual_fs);
 
-        // Ensure ring buffer holds at most the window needed for a full Zoom FFT
-        // Maintain ring buffer up to the precise time-capped window requirement
-        const int precise_required_samples = precise_fft_size * std::max(1, precise_decimation);
-        const int precise_time_capped = std::min(precise_required_samples, static_cast<int>(last_effective_fs * precise_window_seconds));
-        while (static_cast<int>(input_ring.size()) > precise_time_capped) {
-            input_ring.pop_front();
-        }
+        // Analyse straight into the frame the UI will acquire: slots are
+        // preallocated and the frame has no heap members, so publishing
+        // neither locks nor allocates. Frames come once per analysis hop.
+        tuner::AnalysisFrame& frame = analysis_frames.write_buffer();
+        if (pipeline.process(input, num_samples, actual_fs, frame)) {
+            const bool lanes_ok = tuner::AnalysisPipeline::lanes_valid(frame);
+            const gui::NotesStateReading r = lane_reading(frame);
+            analysis_frames.publish();
 
-        // Build contiguous input window
-        std::vector<float> windowed_input;
-        windowed_input.reserve(input_ring.size());
-        for (float s : input_ring) windowed_input.push_back(s);
-        last_window_samples = static_cast<int>(windowed_input.size());
+            // Gated readings go through a queue so NotesState sees every one
+            // of them, not just those in frames the UI happened to pick up
+            if (lanes_ok) lane_readings.push(r); // dropped if the UI has stalled
+        }
 
-        // Precise-only processing path using core ZoomFFT
-        std::vector<float> magnitudes;
-        int use_fft_size = precise_fft_size;
-        int use_decimation = precise_decimation;
-        int required_input_samples = precise_time_capped;
+        // Kick off processing when capture is ready
+        long_engine.poll_process();
+    }
 
-        last_required_samples = required_input_samples;
-        last_use_fft_size = use_fft_size;
-        last_use_decimation = use_decimation;
+    static gui::NotesStateReading lane_reading(const tuner::AnalysisFrame& frame) {
+        gui::NotesStateReading r{};
+        r.f0_hz = frame.lane0.freq_hz; r.f2_hz = frame.lane2.freq_hz;
+        r.mag0 = frame.lane0.magnitude; r.mag2 = frame.lane2.magnitude;
+        r.snr0 = frame.lane0.snr; r.snr2 = frame.lane2.snr;
+        r.var0 = frame.lane0.phase_variance; r.var2 = frame.lane2.phase_variance;
+        return r;
+    }
 
-        // Build processing window (take latest required_input_samples from ring)
-        std::vector<float> proc_input;
-        if (required_input_samples > 0) {
-            int take = std::min(required_input_samples, static_cast<int>(input_ring.size()));
-            proc_input.reserve(take);
-            auto it = input_ring.end();
-            for (int i = 0; i < take; ++i) {
-                --it;
-                proc_input.push_back(*it);
-            }
-            std::reverse(proc_input.begin(), proc_input.end());
+    // UI thread: feed queued readings to NotesState and take the newest DSP
+    // frame. Returns early when no new frame has been published.
+    void consume_analysis_frame() {
+        if (engine_link.is_attached()) {
+            consume_engine_frame();
+            return;
         }
+        gui::NotesStateReading r;
+        while (lane_readings.pop(r)) notes_state.ingest_measurement(r);
+
+        if (!analysis_frames.acquire()) return;
+        show_frame(analysis_frames.read_buffer());
+    }
 
-        // Configure core ZoomFFT
-        tuner::ZoomFFTConfig cfg_core;
-        cfg_core.decimation = use_decimation;
-        cfg_core.fft_size = use_fft_size;
-        cfg_core.num_bins = 1200; // match previous default
-        cfg_core.sample_rate = static_cast<int>(last_effective_fs);
-        cfg_core.use_hann = true;
-        static std::unique_ptr<tuner::ZoomFFT> zoomfft;
-        static std::unique_ptr<tuner::ZoomFFT> zoomfft_f0; // around ~220 Hz when needed
-        static int last_fft_size_used = 0, last_decim_used = 0, last_sr_used = 0;
-        if (!zoomfft || last_fft_size_used != cfg_core.fft_size || last_decim_used != cfg_core.decimation || last_sr_used != cfg_core.sample_rate) {
-            zoomfft = std::make_unique<tuner::ZoomFFT>(cfg_core);
-            last_fft_size_used = cfg_core.fft_size;
-            last_decim_used = cfg_core.decimation;
-            last_sr_used = cfg_core.sample_rate;
+    // Attached mode: the engine publishes faster than the UI draws, so only
+    // the frames seen here reach NotesState (it averages over time anyway)
+    void consume_engine_frame() {
+        if (engine_link.long_version() != attached_long_version &&
+            engine_link.read_long(attached_long, &attached_long_version)) {
+            long_engine.apply_snapshot(attached_long);
         }
-        if (!zoomfft_f0 || last_fft_size_used != cfg_core.fft_size || last_decim_used != cfg_core.decimation || last_sr_used != cfg_core.sample_rate) {
-            zoomfft_f0 = std::make_unique<tuner::ZoomFFT>(cfg_core);
+        if (engine_link.frame_version() == attached_frame_version) return;
+        if (!engine_link.read_frame(attached_frame, &attached_frame_version)) return;
+        if (tuner::AnalysisPipeline::lanes_valid(attached_frame)) {
+            notes_state.ingest_measurement(lane_reading(attached_frame));
         }
+        show_frame(attached_frame);
+    }
 
-        // Expected decimated output length Nz
-        last_nz = std::min(use_fft_size, static_cast<int>(proc_input.size()) / std::max(1, use_decimation));
-        
-        // Compute RMS on latest raw chunk for sanity
-        if (input && num_samples > 0) {
-            double acc = 0.0;
-            int count = 0;
-            for (int i = 0; i < num_samples; i += std::max(1, frontend_decimation)) {
-                float v = input[i];
-                acc += static_cast<double>(v) * static_cast<double>(v);
-                ++count;
-            }
-            last_rms = count > 0 ? std::sqrt(acc / static_cast<double>(count)) : 0.0f;
-            // Feed Mic Setup live level meter
-            gui::mic_setup_push_level(last_rms);
+    // UI thread: send a changed note to the attached engine; a command that
+    // does not fit in the queue is retried next frame
+    void send_engine_controls() {
+        if (center_frequency != sent_center_hz) {
+            tuner::EngineCommand cmd;
+            cmd.type = tuner::EngineCommandType::SetNote;
+            cmd.center_hz = center_frequency;
+            if (engine_link.send(cmd)) sent_center_hz = center_frequency;
         }
+    }
 
-        // If not enough data even for fast path, fall back to current decimated chunk
-        float f0_meas = 0.0f, f2_meas = 0.0f;
-        if (last_nz <= 8) {
-            std::vector<float> chunk_decimated;
-            chunk_decimated.reserve(static_cast<size_t>(num_samples / std::max(1, frontend_decimation)) + 1);
-            for (int i = 0; i < num_samples; i += std::max(1, frontend_decimation)) {
-                chunk_decimated.push_back(input[i]);
-            }
-            magnitudes = zoomfft->process(chunk_decimated.data(), (int)chunk_decimated.size(), center_frequency);
-            // f2 near center (search only within ±40 cents of center)
-            if (!magnitudes.empty()) {
-                int n = (int)magnitudes.size();
-                int center_bin = (n - 1) / 2;
-                int half_range = std::max(1, (int)std::round(40.0f * (n - 1) / 240.0f));
-                int i0 = std::max(0, center_bin - half_range);
-                int i1 = std::min(n - 1, center_bin + half_range);
-                float max_mag = 0.0f; int peak_bin_local = center_bin;
-                for (int i = i0; i <= i1; ++i) if (magnitudes[i] > max_mag) { max_mag = magnitudes[i]; peak_bin_local = i; }
-                float cents_local = -120.0f + 240.0f * (static_cast<float>(peak_bin_local) / (n - 1));
-                f2_meas = center_frequency * std::pow(2.0f, cents_local / 1200.0f);
-                // Estimate SNR as peak / median for robustness
-                std::vector<float> tmp = magnitudes; std::nth_element(tmp.begin(), tmp.begin()+tmp.size()/2, tmp.end());
-                double median = tmp[tmp.size()/2]; if (median <= 1e-9) median = 1e-9;
-                double snr2 = max_mag / median;
-                last_snr2_linear = (float)snr2;
-                last_mag2 = max_mag;
-            }
-            // f0 via second pass centered at ~220 when focusing on A3
-            float f0_center = center_frequency * 0.5f;
-            auto mags_f0 = zoomfft_f0->process(chunk_decimated.data(), (int)chunk_decimated.size(), f0_center);
-            if (!mags_f0.empty()) {
-                int n0 = (int)mags_f0.size();
-                int center_bin0 = (n0 - 1) / 2;
-                int half_range0 = std::max(1, (int)std::round(40.0f * (n0 - 1) / 240.0f));
-                int j0 = std::max(0, center_bin0 - half_range0);
-                int j1 = std::min(n0 - 1, center_bin0 + half_range0);
-                float max_mag = 0.0f; int peak_bin_local = center_bin0;
-                for (int j = j0; j <= j1; ++j) if (mags_f0[j] > max_mag) { max_mag = mags_f0[j]; peak_bin_local = j; }
-                float cents_local = -120.0f + 240.0f * (static_cast<float>(peak_bin_local) / (n0 - 1));
-                f0_meas = f0_center * std::pow(2.0f, cents_local / 1200.0f);
-                std::vector<float> tmp0 = mags_f0; std::nth_element(tmp0.begin(), tmp0.begin()+tmp0.size()/2, tmp0.end());
-                double median0 = tmp0[tmp0.size()/2]; if (median0 <= 1e-9) median0 = 1e-9;
-                double snr0 = max_mag / median0;
-                last_snr0_linear = (float)snr0;
-                last_mag0 = max_mag;
-            }
+    // UI thread: zoom parameters for this frame, from the per-key schedule
+    // or the manual precise_* controls. Changes are built here and queued
+    // for the audio thread (or go to the attached engine); one that cannot be
+    // queued is retried next frame.
+    void update_zoom_config() {
+        tuner::AnalysisPipelineConfig want;  // defaults for what the UI does not set
+        if (settings.adaptive_zoom) {
+            const unsigned int fs = shown_sample_rate ? shown_sample_rate : audio_config.sample_rate;
+            zoom_schedule = tuner::schedule_zoom(settings, center_frequency, fs, notes_state.key_index() + 1);
+            want.fft_size = zoom_schedule.fft_size;
+            want.decimation = zoom_schedule.decimation;
+            want.window_seconds = zoom_schedule.window_seconds;
         } else {
-            magnitudes = zoomfft->process(proc_input.data(), (int)proc_input.size(), center_frequency);
-            // f2 from this pass
-            if (!magnitudes.empty()) {
-                int n = (int)magnitudes.size();
-                int center_bin = (n - 1) / 2;
-                int half_range = std::max(1, (int)std::round(40.0f * (n - 1) / 240.0f));
-                int i0 = std::max(0, center_bin - half_range);
-                int i1 = std::min(n - 1, center_bin + half_range);
-                float max_mag = 0.0f; int peak_bin_local = center_bin;
-                for (int i = i0; i <= i1; ++i) if (magnitudes[i] > max_mag) { max_mag = magnitudes[i]; peak_bin_local = i; }
-                float cents_local = -120.0f + 240.0f * (static_cast<float>(peak_bin_local) / (n - 1));
-                f2_meas = center_frequency * std::pow(2.0f, cents_local / 1200.0f);
-                std::vector<float> tmp = magnitudes; std::nth_element(tmp.begin(), tmp.begin()+tmp.size()/2, tmp.end());
-                double median = tmp[tmp.size()/2]; if (median <= 1e-9) median = 1e-9;
-                double snr2 = max_mag / median;
-                last_snr2_linear = (float)snr2;
-                last_mag2 = max_mag;
-            }
-            // Parallel f0 pass
-            float f0_center = center_frequency * 0.5f;
-            auto mags_f0 = zoomfft_f0->process(proc_input.data(), (int)proc_input.size(), f0_center);
-            if (!mags_f0.empty()) {
-                int n0 = (int)mags_f0.size();
-                int center_bin0 = (n0 - 1) / 2;
-                int half_range0 = std::max(1, (int)std::round(40.0f * (n0 - 1) / 240.0f));
-                int j0 = std::max(0, center_bin0 - half_range0);
-                int j1 = std::min(n0 - 1, center_bin0 + half_range0);
-                float max_mag = 0.0f; int peak_bin_local = center_bin0;
-                for (int j = j0; j <= j1; ++j) if (mags_f0[j] > max_mag) { max_mag = mags_f0[j]; peak_bin_local = j; }
-                float cents_local = -120.0f + 240.0f * (static_cast<float>(peak_bin_local) / (n0 - 1));
-                f0_meas = f0_center * std::pow(2.0f, cents_local / 1200.0f);
-                std::vector<float> tmp0 = mags_f0; std::nth_element(tmp0.begin(), tmp0.begin()+tmp0.size()/2, tmp0.end());
-                double median0 = tmp0[tmp0.size()/2]; if (median0 <= 1e-9) median0 = 1e-9;
-                double snr0 = max_mag / median0;
-                last_snr0_linear = (float)snr0;
-                last_mag0 = max_mag;
+            want.fft_size = precise_fft_size;
+            want.decimation = precise_decimation;
+            want.window_seconds = precise_window_seconds;
+        }
+        want.hop_seconds = 1.0f / std::clamp(settings.analysis_rate_hz, 1.0f, 1000.0f);
+        want.sliding_dft = settings.sliding_dft_spectrum;
+        want.span_cents = settings.zoom_span_cents;
+        want.key_detect_a4_hz = 440.0f * std::pow(2.0f, current_session.a4_offset_cents / 1200.0f);
+        want.idle_gate = settings.idle_on_silence;
+        want.idle_threshold_db = std::clamp(settings.idle_threshold_db, -120.0f, -1.0f);
+        want.strike_gate = settings.sustain_only;
+        want.coarse_gate = settings.pitch_gate;
+        if (want.fft_size == zoom_config.fft_size && want.decimation == zoom_config.decimation &&
+            want.window_seconds == zoom_config.window_seconds && want.hop_seconds == zoom_config.hop_seconds &&
+            want.sliding_dft == zoom_config.sliding_dft && want.span_cents == zoom_config.span_cents &&
+            want.key_detect_a4_hz == zoom_config.key_detect_a4_hz && want.idle_gate == zoom_config.idle_gate &&
+            want.idle_threshold_db == zoom_config.idle_threshold_db && want.strike_gate == zoom_config.strike_gate &&
+            want.coarse_gate == zoom_config.coarse_gate) {
+            return;
+        }
+        if (engine_link.is_attached()) {
+            tuner::EngineCommand cmd;
+            cmd.type = tuner::EngineCommandType::SetZoom;
+            cmd.fft_size = want.fft_size;
+            cmd.decimation = want.decimation;
+            cmd.seconds = want.window_seconds;
+            cmd.hop_seconds = want.hop_seconds;
+            cmd.sliding_dft = want.sliding_dft ? 1 : 0;
+            cmd.span_cents = want.span_cents;
+            cmd.a4_hz = want.key_detect_a4_hz;
+            cmd.idle_gate = want.idle_gate ? 1 : 0;
+            cmd.idle_threshold_db = want.idle_threshold_db;
+            cmd.strike_gate = want.strike_gate ? 1 : 0;
+            cmd.coarse_gate = want.coarse_gate ? 1 : 0;
+            if (engine_link.send(cmd)) zoom_config = want;
+        } else if (audio_input && pipeline.submit_config(want, audio_input->get_config().sample_rate)) {
+            zoom_config = want;
+        }
+    }
+
+    // UI thread: subscribe each view to the analysis nodes it draws from;
+    // hidden views drop out and their nodes stop running
+    void update_analysis_subscriptions() {
+        using tuner::AnalysisConsumer;
+        using tuner::AnalysisNode;
+        using tuner::node_bit;
+        // Kiosk layouts show one view at a time in the centre pane
+        const bool kiosk = ui_mode != 0;
+        const bool main_page = current_page == AppPage::Main && !(kiosk && show_settings_page);
+        const bool concentric_on = main_page && show_concentric;
+        const bool waterfall_on = main_page && show_waterfall && !(kiosk && show_concentric);
+        const bool spectrum_on = main_page && (kiosk ? !show_concentric && !show_waterfall : show_spectrum);
+        tuner::AnalysisGraph& graph = pipeline.graph();
+        graph.subscribe(AnalysisConsumer::SpectrumView,
+                        spectrum_on ? node_bit(AnalysisNode::Spectrum) | node_bit(AnalysisNode::FusedPeak) : 0);
+        graph.subscribe(AnalysisConsumer::WaterfallView, waterfall_on ? node_bit(AnalysisNode::WaterfallRow) : 0);
+        graph.subscribe(AnalysisConsumer::ConcentricView, concentric_on ? node_bit(AnalysisNode::FusedPeak) : 0);
+        graph.subscribe(AnalysisConsumer::KeyboardView,
+                        main_page && !kiosk && show_keyboard_overview ? node_bit(AnalysisNode::KeyBands) : 0);
+        // Notes counts strikes per key whether or not the keyboard is shown
+        graph.subscribe(AnalysisConsumer::NotesState, node_bit(AnalysisNode::LaneCenter) | node_bit(AnalysisNode::LaneF0) |
+                                                          node_bit(AnalysisNode::KeyBands));
+        graph.subscribe(AnalysisConsumer::AutoNote, settings.auto_detect_note ? node_bit(AnalysisNode::KeyDetect) : 0);
+        graph.subscribe(AnalysisConsumer::Recenter, settings.follow_pitch ? node_bit(AnalysisNode::CoarsePitch) : 0);
+
+        if (engine_link.is_attached() && graph.demand() != sent_demand) {
+            tuner::EngineCommand cmd;
+            cmd.type = tuner::EngineCommandType::SetDemand;
+            cmd.nodes = graph.demand();
+            if (engine_link.send(cmd)) sent_demand = cmd.nodes;
+        }
+    }
+
+    void show_frame(const tuner::AnalysisFrame& frame) {
+        if (frame.seq == last_frame_seq) return;
+        // Engine restarts reset seq; count those as a single step
+        const uint64_t advanced = frame.seq > last_frame_seq ? frame.seq - last_frame_seq : 1;
+        last_frame_seq = frame.seq;
+        shown_sample_rate = frame.sample_rate;
+        shown_nodes = frame.nodes_run;
+        shown_node_us = frame.node_us;
+        shown_hop_samples = frame.hop_samples;
+        shown_window_samples = frame.window_samples;
+        shown_lock_f0 = frame.lane0.locked;
+        shown_lock_center = frame.lane2.locked;
+        if (shown_capture_ns && frame.capture_time_ns > shown_capture_ns) {
+            const float rate = static_cast<float>(advanced) * 1e9f / static_cast<float>(frame.capture_time_ns - shown_capture_ns);
+            frame_rate_avg = frame_rate_avg > 0.0f ? frame_rate_avg + 0.1f * (rate - frame_rate_avg) : rate;
+        }
+        shown_capture_ns = frame.capture_time_ns;
+        shown_idle = frame.idle;
+        shown_idle_seconds = frame.idle_seconds;
+        shown_idle_saved = frame.idle_saved_seconds;
+        shown_capture_position = frame.capture_position;
+        shown_strike_phase = frame.strike_phase;
+        shown_strike_count = frame.strikes;
+        shown_strike_age = frame.strike_age_seconds;
+        if (frame.sample_rate && frame.hop_samples > 0) {
+            const float load = frame.dsp_us * 1e-6f * static_cast<float>(frame.sample_rate) / frame.hop_samples;
+            dsp_load_avg += 0.05f * (load - dsp_load_avg);
+        }
+
+        // Outputs of nodes that did not run keep their last value
+        if (frame.nodes_run & tuner::node_bit(tuner::AnalysisNode::Spectrum)) {
+            current_spectrum.assign(frame.spectrum.begin(), frame.spectrum.begin() + frame.num_bins);
+            // Rows on the old span would be drawn against the new grid
+            if (frame.span_cents != spectrum_view.span_cents) waterfall_view.clear();
+            spectrum_view.span_cents = frame.span_cents;
+        }
+        if (frame.nodes_run & tuner::node_bit(tuner::AnalysisNode::Peak)) {
+            peak_frequency = frame.peak_frequency_hz;
+            peak_magnitude = frame.peak_magnitude;
+        }
+        // The views follow the fused short/long-window estimate when it ran
+        if (frame.nodes_run & tuner::node_bit(tuner::AnalysisNode::FusedPeak)) {
+            peak_frequency = frame.fused_frequency_hz;
+        }
+        // Auto note: a new strike of another key moves the Notes selection
+        // (and so the centre) to it; a key picked by hand stays until then
+        if (frame.nodes_run & tuner::node_bit(tuner::AnalysisNode::KeyDetect)) {
+            if (frame.detected_strikes != shown_strikes && settings.auto_detect_note && frame.detected_key >= 0 &&
+                frame.detected_key != notes_state.key_index()) {
+                notes_state.set_key_index(frame.detected_key);
+                notes_state.update_from_session(current_session);
+                center_frequency = notes_state.center_frequency_hz();
             }
+            shown_strikes = frame.detected_strikes;
         }
-        
-        // Thread-safe update
-        current_spectrum = magnitudes;
-        
-        // Find peak
-        float max_mag = 0.0f;
-        int peak_bin = 0;
-        for (size_t i = 0; i < magnitudes.size(); ++i) {
-            if (magnitudes[i] > max_mag) {
-                max_mag = magnitudes[i];
-                peak_bin = static_cast<int>(i);
+        // Follow pitch: once the partial the coarse pitch found has stayed
+        // off the span for a few frames analysed at this centre, the centre
+        // moves there; a key picked by hand or detected moves it back
+        if (frame.nodes_run & tuner::node_bit(tuner::AnalysisNode::CoarsePitch)) {
+            shown_coarse_f0 = frame.coarse_f0_hz;
+            shown_periodicity = frame.coarse_periodicity;
+            shown_zoom_gated = frame.zoom_gated;
+            if (settings.follow_pitch && frame.center_frequency_hz == center_frequency) {
+                const bool outside = frame.coarse_center_hz > 0.0f &&
+                                     std::fabs(1200.0f * std::log2(frame.coarse_center_hz / center_frequency)) > frame.span_cents;
+                off_span_frames = outside ? off_span_frames + 1 : 0;
+                if (off_span_frames >= RECENTER_FRAMES) {
+                    off_span_frames = 0;
+                    notes_state.follow_center(frame.coarse_center_hz);
+                    center_frequency = notes_state.center_frequency_hz();
+                }
             }
         }
-        
-        // Convert bin to frequency (guard center_frequency)
-        float cf_guard = (center_frequency > 0.0f && std::isfinite(center_frequency)) ? center_frequency : 440.0f;
-        float cents = -120.0f + 240.0f * (static_cast<float>(peak_bin) / (1200 - 1));
-        peak_frequency = cf_guard * std::pow(2.0f, cents / 1200.0f);
-        peak_magnitude = max_mag;
-        frames_processed++;
-
-        // Feed NotesState (logic only) when lanes and SNR are valid
-        // Publish live values for troubleshooting
-        notes_state.set_live_measurements(f0_meas, f2_meas, last_snr0_linear, last_snr2_linear);
-        if (f0_meas > 0.0f && f2_meas > 0.0f && last_snr0_linear > 0.5f && last_snr2_linear > 0.5f) {
-            gui::NotesStateReading r{};
-            r.f0_hz = f0_meas; r.f2_hz = f2_meas;
-            r.mag0 = last_mag0; r.mag2 = last_mag2;
-            r.snr0 = last_snr0_linear; r.snr2 = last_snr2_linear;
-            notes_state.ingest_measurement(r);
+        if (frame.nodes_run & tuner::node_bit(tuner::AnalysisNode::KeyBands)) {
+            const float a4_hz = 440.0f * std::pow(2.0f, current_session.a4_offset_cents / 1200.0f);
+            keyboard_view.update(frame.key_level_db.data(), frame.key_hz.data(), frame.key_onsets.data(), a4_hz);
+            notes_state.record_onsets(frame.key_onsets.data());
         }
-        
-        // Update waterfall according to speed control
-        if (++waterfall_counter >= std::max(1, waterfall_stride)) {
+        last_rms = frame.input_rms;
+        frames_processed = static_cast<int>(frame.seq);
+        notes_state.set_live_measurements(frame.lane0.freq_hz, frame.lane2.freq_hz, frame.lane0.snr, frame.lane2.snr);
+        // Feed Mic Setup live level meter
+        gui::mic_setup_push_level(frame.input_rms);
+
+        // Waterfall speed control counts DSP frames, including ones skipped here
+        waterfall_counter += static_cast<int>(std::min<uint64_t>(advanced, 1u << 20));
+        const bool waterfall_wanted =
+            (pipeline.graph().demand() & tuner::node_bit(tuner::AnalysisNode::WaterfallRow)) &&
+            (frame.nodes_run & tuner::node_bit(tuner::AnalysisNode::Spectrum));
+        if (waterfall_wanted && waterfall_counter >= std::max(1, waterfall_stride)) {
             waterfall_counter = 0;
-            waterfall_view.update(magnitudes);
+            const auto t0 = std::chrono::steady_clock::now();
+            waterfall_view.update(current_spectrum);
+            shown_nodes |= tuner::node_bit(tuner::AnalysisNode::WaterfallRow);
+            shown_node_us[static_cast<int>(tuner::AnalysisNode::WaterfallRow)] =
+                std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        }
+        for (int i = 0; i < tuner::ANALYSIS_NODE_COUNT; ++i) {
+            if (shown_nodes & (1u << i)) node_avg_us[i] += 0.05f * (shown_node_us[i] - node_avg_us[i]);
         }
-        // Kick off processing when capture is ready
-        long_engine.poll_process();
+    }
+
+    // Debug: which analysis nodes ran for the frame on screen and their cost
+    void render_analysis_graph_window() {
+        if (!show_analysis_graph) return;
+        if (ImGui::Begin("Analysis Graph", &show_analysis_graph)) {
+            if (engine_link.is_attached()) ImGui::TextUnformatted("Nodes run in the attached engine");
+            const float fs_ms = shown_sample_rate ? 1000.0f / static_cast<float>(shown_sample_rate) : 0.0f;
+            const float hop_ms = shown_hop_samples * fs_ms;
+            const float window_ms = shown_window_samples * fs_ms;
+            ImGui::Text("Frames: %.1f /s, hop %.1f ms, window %.0f ms, overlap %.0f%%", frame_rate_avg, hop_ms, window_ms,
+                        window_ms > 0.0f ? 100.0f * std::max(0.0f, 1.0f - hop_ms / window_ms) : 0.0f);
+            ImGui::Text("Locked lanes: f0 %s, centre %s", shown_lock_f0 ? "yes" : "no", shown_lock_center ? "yes" : "no");
+            ImGui::Text("DSP load: %.1f%% of a core", 100.0f * dsp_load_avg);
+            if (shown_nodes & tuner::node_bit(tuner::AnalysisNode::CoarsePitch)) {
+                if (shown_coarse_f0 > 0.0f) {
+                    ImGui::Text("Coarse pitch: %.2f Hz, periodicity %.2f", shown_coarse_f0, shown_periodicity);
+                } else {
+                    ImGui::Text("Coarse pitch: none%s", shown_zoom_gated ? ", zoom paused" : "");
+                }
+            }
+            if (settings.sustain_only) {
+                static const char* const phases[] = {"waiting", "attack", "sustain"};
+                ImGui::Text("Strike: %s, %d so far, last %.2f s ago", phases[static_cast<int>(shown_strike_phase)],
+                            shown_strike_count, shown_strike_age);
+            }
+            if (settings.idle_on_silence) {
+                const float run_s = shown_sample_rate ? static_cast<float>(shown_capture_position) / shown_sample_rate : 0.0f;
+                ImGui::Text("Idle on silence: %s, idle %.0f%% of %.0f s, %.1f s of DSP saved",
+                            shown_idle ? "idle" : "active", run_s > 0.0f ? 100.0f * shown_idle_seconds / run_s : 0.0f,
+                            run_s, shown_idle_saved);
+            }
+            if (ImGui::BeginTable("nodes", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+                ImGui::TableSetupColumn("Node");
+                ImGui::TableSetupColumn("Ran");
+                ImGui::TableSetupColumn("Last us");
+                ImGui::TableSetupColumn("Avg us");
+                ImGui::TableHeadersRow();
+                float total = 0.0f;
+                for (int i = 0; i < tuner::ANALYSIS_NODE_COUNT; ++i) {
+                    const bool ran = shown_nodes & (1u << i);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(tuner::AnalysisGraph::node_name(static_cast<tuner::AnalysisNode>(i)));
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(ran ? "yes" : "-");
+                    ImGui::TableNextColumn();
+                    if (ran) ImGui::Text("%.1f", shown_node_us[i]); else ImGui::TextUnformatted("-");
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", node_avg_us[i]);
+                    if (ran) total += shown_node_us[i];
+                }
+                ImGui::EndTable();
+                ImGui::Text("Frame total: %.1f us", total);
+            }
+            ImGui::Separator();
+            const tuner::AnalysisGraph& graph = pipeline.graph();
+            for (int c = 0; c < static_cast<int>(tuner::AnalysisConsumer::Count); ++c) {
+                const auto consumer = static_cast<tuner::AnalysisConsumer>(c);
+                const tuner::AnalysisNodeMask nodes = graph.subscription(consumer);
+                if (!nodes) continue;
+                std::string list;
+                for (int i = 0; i < tuner::ANALYSIS_NODE_COUNT; ++i) {
+                    if (!(nodes & (1u << i))) continue;
+                    if (!list.empty()) list += ", ";
+                    list += tuner::AnalysisGraph::node_name(static_cast<tuner::AnalysisNode>(i));
+                }
+                ImGui::Text("%s: %s", tuner::AnalysisGraph::consumer_name(consumer), list.c_str());
+            }
+        }
+        ImGui::End();
     }
     
     void render_gui() {
         // Always derive center frequency from Notes controller/session (source of truth)
         notes_state.update_from_session(current_session);
         center_frequency = notes_state.center_frequency_hz();
+        consume_analysis_frame();
+        render_analysis_graph_window();
 
         // Main menu bar
         if (ImGui::BeginMainMenuBar()) {
@@ -558,6 +836,8 @@ private:
                 if (ImGui::MenuItem("Inharmonicity Calculations")) {
                     show_inharmonicity = true;
                 }
+                ImGui::MenuItem("Keyboard Overview", nullptr, &show_keyboard_overview);
+                ImGui::MenuItem("Analysis Graph (debug)", nullptr, &show_analysis_graph);
                 ImGui::EndMenu();
             }
             ImGui::EndMainMenuBar();
@@ -801,8 +1081,19 @@ private:
                 }
                 ImGui::End();
             }
+            if (show_keyboard_overview) {
+                if (ImGui::Begin("Keyboard", &show_keyboard_overview)) {
+                    ImDrawList* dl = ImGui::GetWindowDrawList();
+                    ImVec2 canvas_pos = ImGui::GetCursorScreenPos();
+                    ImVec2 m_av = ImGui::GetContentRegionAvail();
+                    const float width = std::max(312.0f, m_av.x);
+                    const float height = std::max(60.0f, m_av.y);
+                    keyboard_view.draw(dl, canvas_pos, width, height);
+                }
+                ImGui::End();
+            }
             if (show_long_analysis) { long_view.show_window = true; }
-            long_view.render(long_engine, spectrum_view, center_frequency, last_effective_fs, precise_fft_size, precise_decimation);
+            long_view.render(long_engine, spectrum_view, center_frequency, shown_sample_rate, precise_fft_size, precise_decimation);
             if (show_inharmonicity) {
                 bool open = true;
                 render_inharmonicity_window(notes_state, current_session, open);
@@ -820,7 +1111,9 @@ private:
                                          &waterfall_view,
                                          waterfall_stride,
                                          &concentric_view,
-                                         &notes_state);
+                                         &notes_state,
+                                         &settings,
+                                         &zoom_schedule);
                 }
                 ImGui::End();
             }
@@ -870,16 +1163,23 @@ private:
                 ImGui::End();
             }
             // Mic Setup modal window
+            poll_latency_calibration();
             if (show_mic_setup) {
-                std::string dev = audio_input->get_config().device_name;
+                AudioConfig cfg = audio_input ? audio_input->get_config() : audio_config;
                 bool open = true;
-                if (gui::render_mic_setup_window(dev, open)) {
-                    // Restart audio with selected device
-                    audio_input->stop();
-                    AudioConfig cfg = audio_input->get_config();
-                    cfg.device_name = dev;
-                    audio_input = createAudioInput(cfg);
-                    audio_input->set_process_callback([this](const float* input, int num_samples){ this->process_audio(input, num_samples); });
+                bool applied = false;
+                {
+                    std::lock_guard<std::mutex> lock(calibration_mutex);
+                    applied = gui::render_mic_setup_window(cfg, open, &calibration_status);
+                }
+                if (calibration_status.requested) {
+                    calibration_status.requested = false;
+                    start_latency_calibration(cfg);
+                } else if (applied && !engine_link.is_attached()) {
+                    // Restart audio with selected device and channel options
+                    apply_audio_profile(settings, cfg);
+                    settings.audio_device = cfg.device_name;
+                    reopen_audio(cfg);
                     audio_input->start();
                 }
                 if (!open) show_mic_setup = false;
@@ -956,7 +1256,10 @@ private:
                                      spectrum_view,
                                      &waterfall_view,
                                      waterfall_stride,
-                                     &concentric_view);
+                                     &concentric_view,
+                                     &notes_state,
+                                     &settings,
+                                     &zoom_schedule);
             } else {
                 // When notes controller is visible in kiosk mode, use it for center frequency
                 if (show_notes_controller) {
@@ -1028,7 +1331,12 @@ private:
             // Left status cell: brief audio diagnostics
             {
                 auto ls = audio_input ? audio_input->get_latency_stats() : IAudioInput::LatencyStats{};
-                ImGui::Text("Audio: %d fr | RMS %.3f | xruns %d", (int)last_callback_frames.load(), last_rms, ls.xruns);
+                if (engine_link.is_attached()) {
+                    ImGui::Text("Engine %s: %s | RMS %.3f", engine_name.c_str(),
+                                engine_link.engine_alive() ? "live" : "not responding", last_rms);
+                } else {
+                    ImGui::Text("Audio: %d fr | RMS %.3f | xruns %d", (int)last_callback_frames.load(), last_rms, ls.xruns);
+                }
             }
             ImGui::NextColumn();
             ImGui::Text("[Play]");
@@ -1193,8 +1501,17 @@ private:
     }
 };
 
-int main() {
+int main(int argc, char** argv) {
     TunerGUI tuner;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--attach" && i + 1 < argc) {
+            tuner.attach_engine(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--attach NAME]\n";
+            return 1;
+        }
+    }
     tuner.run();
     return 0;
 }
\ No newline at end of file
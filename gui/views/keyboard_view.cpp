@@ -0,0 +1,93 @@
+#include "keyboard_view.hpp"
+#include <cmath>
+
+namespace gui {
+
+bool KeyboardView::is_black(int key) {
+    // Key 0 is A0; (key + 9) % 12 counts from C
+    const int n = (key + 9) % 12;
+    return n == 1 || n == 3 || n == 6 || n == 8 || n == 10;
+}
+
+void KeyboardView::update(const float* level_db, const float* hz, const int* onsets, float a4_hz) {
+    for (int k = 0; k < NUM_KEYS; ++k) {
+        level_db_[k] = level_db[k];
+        const float f = a4_hz * std::pow(2.0f, (k - 48) / 12.0f);
+        cents_[k] = hz[k] > 0.0f ? 1200.0f * std::log2(hz[k] / f) : 0.0f;
+        // The first update after clear() only sets the baseline
+        if (have_onsets_ && onsets[k] > onsets_seen_[k]) flash_[k] = flash_seconds;
+        onsets_seen_[k] = onsets[k];
+    }
+    have_onsets_ = true;
+}
+
+void KeyboardView::clear() {
+    level_db_.fill(-120.0f);
+    cents_.fill(0.0f);
+    flash_.fill(0.0f);
+    have_onsets_ = false;
+}
+
+void KeyboardView::draw(ImDrawList* dl, const ImVec2& canvas_pos, float width, float height) {
+    if (!dl || width <= 0 || height <= 0) return;
+
+    const ImVec2 p0 = canvas_pos;
+    const ImVec2 p1 = ImVec2(canvas_pos.x + width, canvas_pos.y + height);
+    dl->AddRectFilled(p0, p1, IM_COL32(20,20,22,255));
+    dl->AddRect(p0, p1, IM_COL32(60,60,60,255));
+
+    const float dt = ImGui::GetIO().DeltaTime;
+    for (float& f : flash_) f = f > dt ? f - dt : 0.0f;
+
+    // 52 white keys across the width; black keys sit over the gaps
+    const float white_w = width / 52.0f;
+    const float black_w = white_w * 0.6f;
+    const float black_h = height * 0.62f;
+    const float span = max_db > min_db ? max_db - min_db : 1.0f;
+    auto fill = [&](int k, bool black) {
+        const float t = clamp01((level_db_[k] - min_db) / span);
+        const float base = black ? 40.0f : 200.0f;
+        // Unlit keys keep their colour; lit ones turn orange with level
+        return IM_COL32((int)(base + t * (255.0f - base)),
+                        (int)(base + t * (140.0f - base)),
+                        (int)(base + t * (0.0f - base)), 255);
+    };
+    auto overlay = [&](int k, float x0, float y0, float x1, float y1) {
+        if (flash_[k] > 0.0f) {
+            const int a = (int)(255.0f * clamp01(flash_[k] / (flash_seconds > 0.0f ? flash_seconds : 1.0f)));
+            dl->AddRect(ImVec2(x0 + 1.0f, y0 + 1.0f), ImVec2(x1 - 1.0f, y1 - 1.0f), IM_COL32(0,200,255,a), 0.0f, 0, 2.0f);
+        }
+        // Coarse pitch: ±50 cents across the key
+        if (show_cents && level_db_[k] > min_db && cents_[k] != 0.0f) {
+            const float c = cents_[k] < -50.0f ? -50.0f : (cents_[k] > 50.0f ? 50.0f : cents_[k]);
+            const float x = 0.5f * (x0 + x1) + c / 100.0f * (x1 - x0);
+            dl->AddLine(ImVec2(x, y1 - (y1 - y0) * 0.25f), ImVec2(x, y1 - 2.0f), IM_COL32(20,20,20,230), 2.0f);
+        }
+    };
+
+    int white = 0;
+    for (int k = 0; k < NUM_KEYS; ++k) {
+        if (is_black(k)) continue;
+        const float x0 = canvas_pos.x + white * white_w;
+        const float x1 = x0 + white_w;
+        dl->AddRectFilled(ImVec2(x0, p0.y), ImVec2(x1, p1.y), fill(k, false));
+        dl->AddRect(ImVec2(x0, p0.y), ImVec2(x1, p1.y), IM_COL32(60,60,60,255));
+        overlay(k, x0, p0.y, x1, p1.y);
+        ++white;
+    }
+    white = 0;
+    for (int k = 0; k < NUM_KEYS; ++k) {
+        if (!is_black(k)) {
+            ++white;
+            continue;
+        }
+        // Centred on the boundary after the white keys so far
+        const float xc = canvas_pos.x + white * white_w;
+        const float x0 = xc - 0.5f * black_w;
+        const float x1 = xc + 0.5f * black_w;
+        dl->AddRectFilled(ImVec2(x0, p0.y), ImVec2(x1, p0.y + black_h), fill(k, true));
+        overlay(k, x0, p0.y, x1, p0.y + black_h);
+    }
+}
+
+} // namespace gui
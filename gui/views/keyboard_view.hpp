@@ -0,0 +1,40 @@
+// Keyboard overview for ImGui: every key's level from the key bank
+#pragma once
+
+#include <imgui.h>
+#include <array>
+
+namespace gui {
+
+class KeyboardView {
+public:
+    static constexpr int NUM_KEYS = 88;
+
+    // Options
+    float min_db = -80.0f;        // level drawn as an unlit key
+    float max_db = -10.0f;        // level drawn fully lit
+    float flash_seconds = 0.6f;   // how long a key's outline glows after an onset
+    bool show_cents = true;       // tick per lit key: coarse pitch against equal temperament
+
+    // Per key A0 .. C8: level (dBFS), coarse frequency (0 = none) and onset
+    // counts as in AnalysisFrame; `a4_hz` places the equal-tempered keys
+    void update(const float* level_db, const float* hz, const int* onsets, float a4_hz);
+
+    // Forget levels (onset counts are taken as the new baseline)
+    void clear();
+
+    // Draw the keyboard within the given canvas
+    void draw(ImDrawList* dl, const ImVec2& canvas_pos, float width, float height);
+
+private:
+    std::array<float, NUM_KEYS> level_db_{};
+    std::array<float, NUM_KEYS> cents_{};     // 0 when the key has no frequency
+    std::array<int, NUM_KEYS> onsets_seen_{};
+    std::array<float, NUM_KEYS> flash_{};     // seconds of glow left
+    bool have_onsets_ = false;
+
+    static bool is_black(int key);
+    static inline float clamp01(float v) { return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v); }
+};
+
+} // namespace gui
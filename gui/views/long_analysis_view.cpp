@@ -62,7 +62,7 @@ void LongAnalysisView::render(LongAnalysisEngine& engine,
     bool capturing = engine.is_capturing();
     if (!capturing) {
         if (ImGui::Button("Start Capture")) {
-            engine.configure(precise_fft_size, precise_decimation, 1200);
+            engine.configure(precise_fft_size, precise_decimation, 1200, spectrum_view.span_cents);
             engine.set_center_frequency(center_frequency_hz);
             engine.set_num_segments(num_segments);
             engine.set_num_harmonics(num_harmonics);
@@ -86,10 +86,13 @@ void SpectrumView::draw(ImDrawList* dl,
     // Overlays
     if (show_frequency_lines) {
         auto x_for_cents = [&](float cents) {
-            float norm = (cents + 120.0f) / 240.0f;
+            float norm = (cents + span_cents) / (2.0f * span_cents);
             float xf = fisheye_transform(norm, bell_curve_width);
             return canvas_pos.x + xf * width;
         };
+        // Grid from the widest multiple of `step` inside the span
+        const int step = grid_step_cents();
+        const int edge = static_cast<int>(span_cents) / step * step;
         // Target frequency highlight (window around 0 cents)
         if (show_target_line) {
             float xL = x_for_cents(-0.5f);
@@ -103,7 +106,7 @@ void SpectrumView::draw(ImDrawList* dl,
         // 10-cent lines across range
         if (show_10_cent_lines) {
             ImU32 col10 = IM_COL32((int)(color_10_cent.x*255),(int)(color_10_cent.y*255),(int)(color_10_cent.z*255),(int)(color_10_cent.w*255));
-            for (int c = -120; c <= 120; c += 10) {
+            for (int c = -edge; c <= edge; c += step) {
                 if (c == 0) continue;
                 float x = x_for_cents((float)c);
                 dl->AddLine(ImVec2(x, canvas_pos.y), ImVec2(x, canvas_pos.y + height), col10, 1.0f);
@@ -112,8 +115,8 @@ void SpectrumView::draw(ImDrawList* dl,
         // 20-cent lines across range
         if (show_20_cent_lines) {
             ImU32 col20 = IM_COL32((int)(color_20_cent.x*255),(int)(color_20_cent.y*255),(int)(color_20_cent.z*255),(int)(color_20_cent.w*255));
-            for (int c = -120; c <= 120; c += 20) {
-                if (c == 0) continue;
+            for (int c = -edge; c <= edge; c += step) {
+                if (c == 0 || c % (2 * step) != 0) continue;
                 float x = x_for_cents((float)c);
                 dl->AddLine(ImVec2(x, canvas_pos.y), ImVec2(x, canvas_pos.y + height), col20, 1.3f);
             }
@@ -156,8 +159,10 @@ void SpectrumView::draw(ImDrawList* dl,
                 // text centered
                 dl->AddText(font, font_px, ImVec2(x - ts.x * 0.5f, base_y - ts.y - 8), colLbl, buf);
             };
-            for (int c = -120; c <= 120; c += 10) {
-                if (c == 0) continue;
+            // Every grid line, or every other one when the span is wide
+            const int label_step = span_cents > 150.0f ? 2 * step : step;
+            for (int c = -edge; c <= edge; c += step) {
+                if (c == 0 || c % label_step != 0) continue;
                 draw_label(c);
             }
             if (show_1_cent_lines) { draw_label(-1); draw_label(1); }
@@ -166,8 +171,8 @@ void SpectrumView::draw(ImDrawList* dl,
 
     if (show_peak_line && peak_magnitude > 0.0f) {
         float cents = 1200.0f * std::log2(peak_frequency_hz / center_frequency_hz);
-        if (cents > -120.0f && cents < 120.0f) {
-            float norm = (cents + 120.0f) / 240.0f;
+        if (cents > -span_cents && cents < span_cents) {
+            float norm = (cents + span_cents) / (2.0f * span_cents);
             float xf = fisheye_transform(norm, bell_curve_width);
             float xp = canvas_pos.x + xf * width;
             dl->AddLine(ImVec2(xp, canvas_pos.y), ImVec2(xp, canvas_pos.y + height), IM_COL32(204,0,0,230), 3.0f);
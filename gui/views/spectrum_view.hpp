@@ -13,6 +13,7 @@ public:
     bool show_peak_line = true;
     float bell_curve_width = 0.35f; // fisheye distortion
     int color_scheme_idx = 2;       // 0..N-1 (default Viridis)
+    float span_cents = 120.0f;      // the spectrum covers ±span_cents (from the analysis frame)
 
     // New overlay controls
     bool show_target_line = true;         // 0 cents
@@ -50,6 +51,8 @@ public:
     struct ColorStop { float position; float r, g, b; };
     struct ColorScheme { const char* name; std::vector<ColorStop> stops; };
     const std::vector<ColorScheme>& schemes() const { return color_schemes; }
+    // Spacing of the "10-cent" grid lines: 10 cents up to ±150, coarser for wide spans
+    int grid_step_cents() const { return span_cents > 150.0f ? 50 : 10; }
 
 private:
     std::vector<ColorScheme> color_schemes;
@@ -144,15 +144,18 @@ void WaterfallView::draw(ImDrawList* dl,
         // Overlay grid/lines similar to Spectrum
         // Map cents to x using SpectrumView bell/fisheye and draw vertical lines
         auto x_for_cents = [&](float cents){
-            float norm = (cents + 120.0f) / 240.0f;
+            const float span = spectrum_view.span_cents;
+            float norm = (cents + span) / (2.0f * span);
             float xf = fisheye_transform(norm, spectrum_view.bell_curve_width);
             return canvas_pos.x + xf * width;
         };
+        const int step = spectrum_view.grid_step_cents();
+        const int edge = static_cast<int>(spectrum_view.span_cents) / step * step;
         // 10/20-cent lines
         if (current_cols_ > 0) {
             if (show_10_cent_lines) {
                 const ImU32 col10 = IM_COL32((int)(color_10_cent.x*255),(int)(color_10_cent.y*255),(int)(color_10_cent.z*255),(int)(color_10_cent.w*255));
-                for (int c = -120; c <= 120; c += 10) {
+                for (int c = -edge; c <= edge; c += step) {
                     if (c == 0) continue;
                     float x = x_for_cents((float)c);
                     dl->AddLine(ImVec2(x, p0.y), ImVec2(x, p1.y), col10, 1.0f);
@@ -160,8 +163,8 @@ void WaterfallView::draw(ImDrawList* dl,
             }
             if (show_20_cent_lines) {
                 const ImU32 col20 = IM_COL32((int)(color_20_cent.x*255),(int)(color_20_cent.y*255),(int)(color_20_cent.z*255),(int)(color_20_cent.w*255));
-                for (int c = -120; c <= 120; c += 20) {
-                    if (c == 0) continue;
+                for (int c = -edge; c <= edge; c += step) {
+                    if (c == 0 || c % (2 * step) != 0) continue;
                     float x = x_for_cents((float)c);
                     dl->AddLine(ImVec2(x, p0.y), ImVec2(x, p1.y), col20, 1.2f);
                 }
@@ -251,12 +254,15 @@ void WaterfallView::draw(ImDrawList* dl,
         }
         // Overlay lines for CPU path as well
         auto x_for_cents = [&](float cents){
-            float norm = (cents + 120.0f) / 240.0f;
+            const float span = spectrum_view.span_cents;
+            float norm = (cents + span) / (2.0f * span);
             float xf = fisheye_transform(norm, spectrum_view.bell_curve_width);
             return canvas_pos.x + xf * width;
         };
-        if (show_10_cent_lines) { const ImU32 col10 = IM_COL32((int)(color_10_cent.x*255),(int)(color_10_cent.y*255),(int)(color_10_cent.z*255),(int)(color_10_cent.w*255)); for (int c = -120; c <= 120; c += 10) { if (c == 0) continue; float x = x_for_cents((float)c); dl->AddLine(ImVec2(x, p0.y), ImVec2(x, p1.y), col10, 1.0f); } }
-        if (show_20_cent_lines) { const ImU32 col20 = IM_COL32((int)(color_20_cent.x*255),(int)(color_20_cent.y*255),(int)(color_20_cent.z*255),(int)(color_20_cent.w*255)); for (int c = -120; c <= 120; c += 20) { if (c == 0) continue; float x = x_for_cents((float)c); dl->AddLine(ImVec2(x, p0.y), ImVec2(x, p1.y), col20, 1.2f); } }
+        const int step = spectrum_view.grid_step_cents();
+        const int edge = static_cast<int>(spectrum_view.span_cents) / step * step;
+        if (show_10_cent_lines) { const ImU32 col10 = IM_COL32((int)(color_10_cent.x*255),(int)(color_10_cent.y*255),(int)(color_10_cent.z*255),(int)(color_10_cent.w*255)); for (int c = -edge; c <= edge; c += step) { if (c == 0) continue; float x = x_for_cents((float)c); dl->AddLine(ImVec2(x, p0.y), ImVec2(x, p1.y), col10, 1.0f); } }
+        if (show_20_cent_lines) { const ImU32 col20 = IM_COL32((int)(color_20_cent.x*255),(int)(color_20_cent.y*255),(int)(color_20_cent.z*255),(int)(color_20_cent.w*255)); for (int c = -edge; c <= edge; c += step) { if (c == 0 || c % (2 * step) != 0) continue; float x = x_for_cents((float)c); dl->AddLine(ImVec2(x, p0.y), ImVec2(x, p1.y), col20, 1.2f); } }
         if (show_target_line) { float x_center = x_for_cents(0.0f); dl->AddLine(ImVec2(x_center, p0.y), ImVec2(x_center, p1.y), IM_COL32((int)(color_target.x*255),(int)(color_target.y*255),(int)(color_target.z*255),(int)(color_target.w*255)), 2.0f); }
         if (show_1_cent_lines) { float x1=x_for_cents(1.0f), x_1=x_for_cents(-1.0f); ImU32 c1=IM_COL32((int)(color_1_cent.x*255),(int)(color_1_cent.y*255),(int)(color_1_cent.z*255),(int)(color_1_cent.w*255)); dl->AddLine(ImVec2(x1,p0.y),ImVec2(x1,p1.y),c1,1.0f); dl->AddLine(ImVec2(x_1,p0.y),ImVec2(x_1,p1.y),c1,1.0f);} 
         if (show_2_cent_lines) { float x2=x_for_cents(2.0f), x_2=x_for_cents(-2.0f); ImU32 c2=IM_COL32((int)(color_2_cent.x*255),(int)(color_2_cent.y*255),(int)(color_2_cent.z*255),(int)(color_2_cent.w*255)); dl->AddLine(ImVec2(x2,p0.y),ImVec2(x2,p1.y),c2,1.1f); dl->AddLine(ImVec2(x_2,p0.y),ImVec2(x_2,p1.y),c2,1.1f);} 
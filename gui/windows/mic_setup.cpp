@@ -1,6 +1,7 @@
 #include "pages/mic_setup.hpp"
 #include <imgui.h>
 #include <alsa/asoundlib.h>
+#include <algorithm>
 #include <cstring>
 
 namespace gui {
@@ -29,9 +30,29 @@ std::vector<MicDeviceInfo> list_capture_devices() {
     return out;
 }
 
-bool render_mic_setup_window(std::string& selected_device, bool& open) {
+bool render_mic_setup_window(tuner::AudioConfig& config, bool& open, MicCalibrationStatus* calibration) {
+    const std::string& selected_device = config.device_name;
     bool applied = false;
-    if (!open) return false;
+    // Channel options edited in the window, re-read from the config each
+    // time it opens and whenever the config itself changes (e.g. ALSA
+    // negotiated another channel count on restart)
+    static bool shown = false;
+    static int channels = 0;
+    static int mode_idx = 0;
+    static int select_ch = 0;
+    static tuner::AudioConfig synced;
+    if (!open) {
+        shown = false;
+        return false;
+    }
+    if (!shown || config.channels != synced.channels || config.channel_mode != synced.channel_mode ||
+        config.channel_select != synced.channel_select) {
+        synced = config;
+        channels = std::max(1, (int)config.channels);
+        mode_idx = (int)config.channel_mode;
+        select_ch = config.channel_select;
+        shown = true;
+    }
     if (ImGui::Begin("Microphone Setup", &open)) {
         static std::vector<MicDeviceInfo> devices;
         static int selected_idx = -1;
@@ -68,15 +89,64 @@ bool render_mic_setup_window(std::string& selected_device, bool& open) {
             ImGui::TextWrapped("%s", devices[selected_idx].desc.c_str());
         }
         ImGui::Separator();
+        // Channel options: capture N channels and reduce to mono before analysis
+        ImGui::SliderInt("Channels", &channels, 1, 8);
+        const char* modes[] = { "Select channel", "Average", "Strongest per band (max energy)" };
+        ImGui::Combo("Channel mode", &mode_idx, modes, IM_ARRAYSIZE(modes));
+        if (mode_idx == (int)tuner::ChannelMode::Select) {
+            ImGui::SliderInt("Channel", &select_ch, 0, channels - 1);
+        }
+        ImGui::Separator();
         if (ImGui::Button("Apply & Restart Audio")) {
             if (selected_idx >= 0 && selected_idx < (int)devices.size()) {
-                selected_device = devices[selected_idx].name;
+                config.device_name = devices[selected_idx].name;
+                config.channels = (unsigned int)channels;
+                config.channel_mode = (tuner::ChannelMode)mode_idx;
+                config.channel_select = std::min(select_ch, channels - 1);
                 applied = true;
             }
         }
         ImGui::SameLine();
         if (ImGui::Button("Close")) open = false;
 
+        if (calibration) {
+            ImGui::Separator();
+            ImGui::Text("Latency: %u frames x %u periods (%.2f ms)", config.period_size, config.num_periods,
+                        config.sample_rate ? 1000.0f * config.period_size / config.sample_rate : 0.0f);
+            if (calibration->running) {
+                ImGui::ProgressBar(calibration->progress, ImVec2(-FLT_MIN, 0));
+            } else if (ImGui::Button("Auto-tune Latency")) {
+                // Calibrate the device selected in the list with the current channel options
+                if (selected_idx >= 0 && selected_idx < (int)devices.size()) {
+                    config.device_name = devices[selected_idx].name;
+                }
+                config.channels = (unsigned int)channels;
+                config.channel_mode = (tuner::ChannelMode)mode_idx;
+                config.channel_select = std::min(select_ch, channels - 1);
+                calibration->requested = true;
+            }
+            if (!calibration->message.empty()) ImGui::TextWrapped("%s", calibration->message.c_str());
+            if (!calibration->trials.empty() &&
+                ImGui::BeginTable("##calib", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame)) {
+                ImGui::TableSetupColumn("Period");
+                ImGui::TableSetupColumn("Periods");
+                ImGui::TableSetupColumn("xruns");
+                ImGui::TableSetupColumn("Load avg/peak");
+                ImGui::TableSetupColumn("Result");
+                ImGui::TableHeadersRow();
+                for (const auto& t : calibration->trials) {
+                    ImGui::TableNextRow();
+                    // A trial that failed to open has no negotiated config, only the request
+                    ImGui::TableNextColumn(); ImGui::Text("%u", t.started ? t.negotiated.period_size : t.period_size);
+                    ImGui::TableNextColumn(); ImGui::Text("%u", t.started ? t.negotiated.num_periods : t.num_periods);
+                    ImGui::TableNextColumn(); ImGui::Text("%d", t.xruns);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f / %.2f", t.avg_load, t.peak_load);
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(!t.started ? "open failed" : (t.stable ? "stable" : "unstable"));
+                }
+                ImGui::EndTable();
+            }
+        }
+
         ImGui::Separator();
         // Simple level meter
         ImGui::TextUnformatted("Input level:");
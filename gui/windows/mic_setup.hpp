@@ -2,6 +2,8 @@
 
 #include <string>
 #include <vector>
+#include "audio_input.hpp"
+#include "latency_calibrator.hpp"
 
 namespace gui {
 
@@ -13,8 +15,21 @@ struct MicDeviceInfo {
 // Enumerate ALSA capture-capable devices (plughw/hw and default if present)
 std::vector<MicDeviceInfo> list_capture_devices();
 
-// Render setup window; returns true if user clicked Apply
-bool render_mic_setup_window(std::string& selected_device, bool& open);
+// Latency calibration shown in the setup window. The owner runs the
+// calibrator and fills in the progress; the window only sets `requested`.
+struct MicCalibrationStatus {
+    bool requested = false;
+    bool running = false;
+    float progress = 0.0f;                      // 0..1 over the candidate sweep
+    std::string message;
+    std::vector<tuner::CalibrationTrial> trials;
+};
+
+// Render setup window; edits device and channel options in `config` and
+// returns true if user clicked Apply. Passing `calibration` adds the
+// latency auto-tune section for the selected device.
+bool render_mic_setup_window(tuner::AudioConfig& config, bool& open,
+                             MicCalibrationStatus* calibration = nullptr);
 
 // Push latest audio RMS level (0..1 nominal) for the live meter
 void mic_setup_push_level(float rms);
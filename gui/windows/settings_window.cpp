@@ -5,6 +5,38 @@
 
 namespace gui {
 
+// Per-register overrides of the adaptive zoom schedule
+static void render_zoom_overrides(tuner::AppSettings& st, int current_key) {
+    if (!ImGui::TreeNode("Register overrides")) return;
+    int remove = -1;
+    for (size_t i = 0; i < st.zoom_overrides.size(); ++i) {
+        tuner::ZoomRegisterOverride& ov = st.zoom_overrides[i];
+        ImGui::PushID((int)i);
+        ImGui::SetNextItemWidth(120.0f);
+        ImGui::DragIntRange2("Keys", &ov.first_key, &ov.last_key, 0.2f, 1, 88);
+        ImGui::SameLine(); ImGui::SetNextItemWidth(80.0f);
+        ImGui::InputInt("FFT", &ov.fft_size, 0);
+        ImGui::SameLine(); ImGui::SetNextItemWidth(60.0f);
+        ImGui::InputInt("D", &ov.decimation, 0);
+        ImGui::SameLine(); ImGui::SetNextItemWidth(70.0f);
+        ImGui::InputFloat("Window", &ov.window_seconds, 0.0f, 0.0f, "%.2f");
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Remove")) remove = (int)i;
+        ov.fft_size = std::max(0, ov.fft_size);
+        ov.decimation = std::max(0, ov.decimation);
+        ov.window_seconds = std::max(0.0f, ov.window_seconds);
+        ImGui::PopID();
+    }
+    if (remove >= 0) st.zoom_overrides.erase(st.zoom_overrides.begin() + remove);
+    if (current_key >= 1 && ImGui::Button("Add override for current key")) {
+        tuner::ZoomRegisterOverride ov;
+        ov.first_key = ov.last_key = current_key;
+        st.zoom_overrides.push_back(ov);
+    }
+    ImGui::TextDisabled("0 keeps the scheduled value; the first matching range wins.");
+    ImGui::TreePop();
+}
+
 void SettingsPage::render(float& center_frequency_hz,
                           int& precise_fft_size,
                           int& precise_decimation,
@@ -14,13 +46,56 @@ void SettingsPage::render(float& center_frequency_hz,
                           WaterfallView* waterfall_view,
                           int& waterfall_stride,
                           ConcentricView* concentric_view,
-                          gui::NotesState* notes_state) {
+                          gui::NotesState* notes_state,
+                          tuner::AppSettings* app_settings,
+                          const tuner::ZoomSchedule* zoom_schedule) {
     if (ImGui::BeginTabBar("SettingsTabs")) {
         if (ImGui::BeginTabItem("General")) {
-            ImGui::Text("FFT Size: 16384 (fixed)");
-            precise_fft_size = 16384;
-            ImGui::SliderInt("Precise D", &precise_decimation, 4, 64);
-            ImGui::SliderFloat("Precise Window (s)", &precise_window_seconds, 0.10f, 2.00f, "%.2f s");
+            if (app_settings) ImGui::Checkbox("Adaptive zoom per key", &app_settings->adaptive_zoom);
+            if (app_settings && app_settings->adaptive_zoom) {
+                ImGui::SliderFloat("Target resolution", &app_settings->zoom_resolution_cents, 2.0f, 30.0f, "%.1f cents");
+                ImGui::SliderFloat("Target bin spacing", &app_settings->zoom_bin_cents, 0.25f, 8.0f, "%.2f cents");
+                ImGui::SliderFloat("Max window", &app_settings->zoom_max_window_seconds, 0.20f, 4.00f, "%.2f s");
+                if (zoom_schedule) {
+                    ImGui::Text("Now: D %d, FFT %d, window %.2f s%s", zoom_schedule->decimation, zoom_schedule->fft_size,
+                                zoom_schedule->window_seconds, zoom_schedule->overridden ? " (override)" : "");
+                    ImGui::Text("      %.1f cents resolution, %.2f cents/bin, %.1f MFLOP per lane",
+                                zoom_schedule->resolution_cents, zoom_schedule->bin_cents, zoom_schedule->mflops);
+                }
+                render_zoom_overrides(*app_settings, notes_state ? notes_state->key_index() + 1 : 0);
+            } else {
+                ImGui::Text("FFT Size: 16384 (fixed)");
+                precise_fft_size = 16384;
+                ImGui::SliderInt("Precise D", &precise_decimation, 4, 64);
+                ImGui::SliderFloat("Precise Window (s)", &precise_window_seconds, 0.10f, 2.00f, "%.2f s");
+            }
+            if (app_settings) {
+                static const float spans[] = {25.0f, 50.0f, 120.0f, 600.0f};
+                char preview[32];
+                std::snprintf(preview, sizeof(preview), "±%.0f cents", app_settings->zoom_span_cents);
+                if (ImGui::BeginCombo("Zoom span", preview)) {
+                    for (float span : spans) {
+                        char label[32];
+                        std::snprintf(label, sizeof(label), "±%.0f cents", span);
+                        const bool selected = span == app_settings->zoom_span_cents;
+                        if (ImGui::Selectable(label, selected)) app_settings->zoom_span_cents = span;
+                        if (selected) ImGui::SetItemDefaultFocus();
+                    }
+                    ImGui::EndCombo();
+                }
+                ImGui::SliderFloat("Analysis rate", &app_settings->analysis_rate_hz, 20.0f, 200.0f, "%.0f spectra/s");
+                ImGui::Checkbox("Sliding DFT spectrum", &app_settings->sliding_dft_spectrum);
+            }
+            if (app_settings) {
+                ImGui::Checkbox("Auto-detect struck key", &app_settings->auto_detect_note);
+                ImGui::Checkbox("Measure sustain only", &app_settings->sustain_only);
+                ImGui::Checkbox("Pause zoom without a pitch", &app_settings->pitch_gate);
+                ImGui::Checkbox("Follow the pitch off the span", &app_settings->follow_pitch);
+                ImGui::Checkbox("Idle on silence", &app_settings->idle_on_silence);
+                if (app_settings->idle_on_silence) {
+                    ImGui::SliderFloat("Wake level", &app_settings->idle_threshold_db, -90.0f, -30.0f, "%.0f dBFS");
+                }
+            }
             ImGui::TextDisabled("Note/Center frequency is controlled in the Notes window.");
             ImGui::EndTabItem();
         }
@@ -122,7 +197,8 @@ void SettingsPage::render(float& center_frequency_hz,
             float max_err = cfg.cents_plausible_abs;
             float low_band = cfg.band_low_ratio;
             float high_band = cfg.band_high_ratio;
-            ImGui::SliderInt("Period (frames)", &period, 5, 120);
+            float max_sigma = cfg.max_sigma_cents;
+            ImGui::SliderInt("Period (frames)", &period, 1, 60);
             ImGui::SliderInt("Max captures", &max_caps, 3, 50);
             ImGui::SliderFloat("SNR min (peak/median)", &snr_min, 0.5f, 10.0f, "%.2f");
             ImGui::SliderFloat("Balance min (weaker/stronger)", &balance_min, 0.0f, 0.5f, "%.2f");
@@ -130,6 +206,7 @@ void SettingsPage::render(float& center_frequency_hz,
             ImGui::SliderFloat("Max |deviation| (cents)", &max_err, 5.0f, 50.0f, "%.1f");
             ImGui::SliderFloat("Strength band low", &low_band, 0.5f, 0.95f, "%.2f");
             ImGui::SliderFloat("Strength band high", &high_band, 0.80f, 1.0f, "%.2f");
+            ImGui::SliderFloat("Max phase spread (cents, 0=off)", &max_sigma, 0.0f, 5.0f, "%.2f");
             if (notes_state && ImGui::Button("Apply")) {
                 cfg.capture_period_frames = period;
                 cfg.max_captures = max_caps;
@@ -139,6 +216,7 @@ void SettingsPage::render(float& center_frequency_hz,
                 cfg.cents_plausible_abs = max_err;
                 cfg.band_low_ratio = low_band;
                 cfg.band_high_ratio = high_band;
+                cfg.max_sigma_cents = max_sigma;
                 notes_state->tracker().set_config(cfg);
             }
             ImGui::EndTabItem();
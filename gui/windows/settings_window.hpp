@@ -5,6 +5,7 @@
 #include "views/concentric_view.hpp"
 #include "views/waterfall_view.hpp"
 #include "pages/notes_state.hpp"
+#include "zoom_scheduler.hpp"
 
 namespace gui {
 
@@ -20,7 +21,9 @@ public:
                 WaterfallView* waterfall_view,
                 int& waterfall_stride,
                 ConcentricView* concentric_view = nullptr,
-                gui::NotesState* notes_state = nullptr);
+                gui::NotesState* notes_state = nullptr,
+                tuner::AppSettings* app_settings = nullptr,
+                const tuner::ZoomSchedule* zoom_schedule = nullptr);
 };
 
 } // namespace gui
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "analysis_graph.hpp"
+#include "strike_tracker.hpp"
+
+namespace tuner {
+
+// Measurement of one partial lane (a narrow search window around an expected
+// partial frequency). Zero frequency means no measurement this frame.
+struct LaneMeasurement {
+    float freq_hz = 0.0f;
+    float magnitude = 0.0f;
+    float snr = 0.0f;        // peak / median of the lane's zoom spectrum (linear)
+    // Phase-advance (instantaneous) frequency of the same peak over short
+    // windows one hop apart, and its variance in cents^2; 0 = none
+    float phase_hz = 0.0f;
+    float phase_variance = 0.0f;
+    bool locked = false;     // measured from a few DTFT bins around the last peak, not the zoom FFT
+};
+
+// One DSP result as handed from the audio thread to the UI. Fixed size, no
+// heap members, so it can be published through a TripleBuffer without
+// allocating.
+struct AnalysisFrame {
+    static constexpr int MAX_BINS = 1200;
+
+    uint64_t seq = 0;                 // 1 for the first frame; 0 = nothing published yet
+    uint64_t capture_time_ns = 0;     // steady_clock time the newest analysed sample arrived
+    uint64_t capture_position = 0;    // absolute sample index of the end of the window
+
+    // Analysis context
+    float center_frequency_hz = 0.0f;
+    unsigned int sample_rate = 0;
+    int window_samples = 0;
+    int fft_size = 0;
+    int decimation = 0;
+    int decimated_samples = 0;        // Nz
+    int hop_samples = 0;              // input samples since the previous frame (STFT hop)
+
+    // Analysis nodes that ran for this frame and what each cost; fields of
+    // nodes that did not run are zero (num_bins = 0 without Spectrum)
+    AnalysisNodeMask nodes_run = 0;
+    std::array<float, ANALYSIS_NODE_COUNT> node_us{};
+
+    // Zoom spectrum around center_frequency_hz (±span_cents over num_bins)
+    float span_cents = 120.0f;
+    int num_bins = 0;
+    std::array<float, MAX_BINS> spectrum{};
+    float peak_frequency_hz = 0.0f;
+    float peak_magnitude = 0.0f;
+    // The peak's instantaneous frequency from the phase advance between
+    // short windows (AnalysisPipelineConfig::phase_window_seconds), and its
+    // variance in cents^2; 0 = none
+    float phase_peak_hz = 0.0f;
+    float phase_peak_variance = 0.0f;
+
+    // Resolution pyramid: the peak over a short window of the same baseband
+    // (reacts within tens of ms), and the estimate the views show, weighting
+    // both peaks by SNR and resolution. Right after a strike the long window
+    // still holds the old sound and disagrees, so the short one dominates.
+    int fast_window_samples = 0;
+    float fast_peak_hz = 0.0f;
+    float fast_peak_magnitude = 0.0f;
+    float fused_frequency_hz = 0.0f;
+    float fused_precise_weight = 0.0f;  // share of the long window in the fused estimate (0..1)
+
+    // Partial lanes: fundamental (half the centre) and the centre partial
+    LaneMeasurement lane0;
+    LaneMeasurement lane2;
+
+    float input_rms = 0.0f;           // RMS of the input since the previous frame
+
+    // Key detection (KeyDetect): the key struck last, 0-based (A0 = 0 ..
+    // C8 = 87; -1 before any), how many strikes have been confirmed (a
+    // change means a new strike, even of the same key) and the comb score of
+    // the last pass
+    int detected_key = -1;
+    int detected_strikes = 0;
+    float detection_score = 0.0f;
+
+    // Key bands (KeyBands), per key A0 .. C8: the level of the strongest
+    // channel on the key (dBFS of a sine; -120 = nothing there), its coarse
+    // frequency (0 = none) and the onsets counted since the bank started
+    std::array<float, 88> key_level_db{};
+    std::array<float, 88> key_hz{};
+    std::array<int, 88> key_onsets{};
+
+    // Coarse pitch (CoarsePitch): the fundamental YIN found in the history
+    // (0 = nothing periodic), how periodic the signal is (0..1), and the
+    // partial of that fundamental nearest the centre, where the zoom
+    // belongs (0 = none). zoom_gated: the zoom nodes were skipped because
+    // nothing periodic has sounded for a while (coarse_gate).
+    float coarse_f0_hz = 0.0f;
+    float coarse_periodicity = 0.0f;
+    float coarse_center_hz = 0.0f;
+    bool zoom_gated = false;
+
+    // Silence idle (idle_gate). idle: nothing but input_rms was measured.
+    // dsp_us: the pipeline's time since the previous frame. Over the run:
+    // the audio time spent idle and the DSP time that saved, against the
+    // active cost per second of audio.
+    bool idle = false;
+    float dsp_us = 0.0f;
+    float idle_seconds = 0.0f;
+    float idle_saved_seconds = 0.0f;
+
+    // Strike phase (Strike): waiting, in a strike's attack or in its
+    // sustain, which is all the zoom measures under strike_gate; strikes
+    // whose attack reached the sustain, and the input time since the last
+    // attack started
+    StrikePhase strike_phase = StrikePhase::Waiting;
+    int strikes = 0;
+    float strike_age_seconds = 0.0f;
+};
+
+} // namespace tuner
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace tuner {
+
+// Steps of one analysis pass. Each runs only if a subscriber needs it or a
+// step that runs depends on it.
+enum class AnalysisNode : uint8_t {
+    ZoomCenter = 0,  // heterodyne, decimate and FFT around the centre partial
+    ZoomF0,          // the same around centre / 2
+    ZoomFast,        // short-window transform of the centre lane's baseband
+    LaneCenter,      // peak and SNR within ±lane_search_cents of the centre
+    LaneF0,          // peak and SNR around centre / 2
+    Spectrum,        // dense bin sampling over the full zoom span
+    Peak,            // full-span peak
+    FusedPeak,       // short- and long-window peaks combined by confidence
+    KeyDetect,       // keyboard-wide detection of the struck key (NoteDetector)
+    KeyBands,        // level, coarse pitch and onsets of all 88 keys (KeyChannelizer)
+    CoarsePitch,     // YIN fundamental over the history: validates the centre, gates the zoom
+    Strike,          // strike phase from the input level: the zoom measures the sustain only
+    WaterfallRow,    // UI thread: colourise and push a waterfall row
+    Count
+};
+
+constexpr int ANALYSIS_NODE_COUNT = static_cast<int>(AnalysisNode::Count);
+
+using AnalysisNodeMask = uint32_t;
+
+constexpr AnalysisNodeMask node_bit(AnalysisNode node) {
+    return AnalysisNodeMask{1} << static_cast<int>(node);
+}
+
+// Views and other users of analysis results
+enum class AnalysisConsumer : uint8_t {
+    SpectrumView = 0,
+    WaterfallView,
+    ConcentricView,
+    KeyboardView,  // keyboard overview of every key's level
+    NotesState,
+    OctaveLock,
+    FrameOutput,   // tuner_cli JSON lines
+    RemoteClient,  // GUI attached to a tuner_cli engine
+    AutoNote,      // retargets the lanes to the detected key
+    Recenter,      // moves the centre to the partial CoarsePitch found
+    Count
+};
+
+// Subscriptions of consumers to analysis nodes. Subscribing may happen on
+// any thread; the audio thread reads demand() once per pass.
+class AnalysisGraph {
+public:
+    // Replace what `consumer` needs (0 unsubscribes)
+    void subscribe(AnalysisConsumer consumer, AnalysisNodeMask nodes);
+    AnalysisNodeMask subscription(AnalysisConsumer consumer) const;
+
+    // Nodes to run: all subscriptions plus their dependencies. With no
+    // subscribers nothing runs; a pipeline's user subscribes to what it reads.
+    AnalysisNodeMask demand() const;
+
+    static AnalysisNodeMask with_dependencies(AnalysisNodeMask nodes);
+    static const char* node_name(AnalysisNode node);
+    static const char* consumer_name(AnalysisConsumer consumer);
+
+private:
+    std::array<std::atomic<AnalysisNodeMask>, static_cast<int>(AnalysisConsumer::Count)> subscriptions{};
+};
+
+} // namespace tuner
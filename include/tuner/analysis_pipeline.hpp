@@ -0,0 +1,246 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "analysis_frame.hpp"
+#include "analysis_graph.hpp"
+#include "mirrored_ring.hpp"
+#include "key_channelizer.hpp"
+#include "note_detector.hpp"
+#include "pitch_locator.hpp"
+#include "pre_decimator.hpp"
+#include "sliding_dft.hpp"
+#include "spsc_ring.hpp"
+#include "strike_tracker.hpp"
+#include "zoom_fft.hpp"
+
+namespace tuner {
+
+struct AnalysisPipelineConfig {
+    int fft_size = 4096;
+    int decimation = 16;              // from the input rate; rounded down to a multiple of the front end's factor
+    float window_seconds = 0.35f;     // cap on the analysed history (responsiveness)
+    int num_bins = 1200;              // zoom bins over ±span_cents
+    float lane_search_cents = 40.0f;  // peak search half-width around each lane centre
+    float hop_seconds = 0.01f;        // time between frames (STFT hop); 0 = a frame per push()
+    float fast_window_seconds = 0.05f;  // short pyramid level over the centre lane's baseband (0 = off)
+    PeakEstimator peak_estimator = PeakEstimator::WindowCorrected;  // sub-bin refinement of every peak
+    float phase_window_seconds = 0.05f; // phase-advance frequency at the peak and lanes: DFT window (0 = off)
+    int phase_windows = 8;            // windows, one hop apart, in the phase-slope fit (>= 3)
+    int lock_bins = 5;                // locked lanes: DTFT bins around the last peak instead of the zoom FFT (0 = off)
+    int lock_refresh_frames = 50;     // full zoom at least this often while locked (noise floor, new peaks)
+    bool sliding_dft = false;         // centre bins from a sliding DFT bank updated per decimated sample, not the zoom FFT
+    int pre_decimation = 4;           // shared lowpass-and-decimate ahead of the lanes at 48 kHz, more above (1 = off)
+    float span_cents = 120.0f;        // zoom span: bins, peaks and lanes cover ±span_cents around their centre
+    float key_detect_a4_hz = 440.0f;  // KeyDetect, KeyBands: reference pitch of the 88 keys
+    bool coarse_gate = false;         // skip the zoom while CoarsePitch finds nothing periodic
+    bool idle_gate = false;           // idle on silence: only the input level is measured until it rises
+    float idle_threshold_db = -60.0f; // idle_gate: input RMS (dBFS) that wakes the pipeline ..
+    float idle_hysteresis_db = 6.0f;  // .. which idles once below threshold - hysteresis ..
+    float idle_hold_seconds = 1.0f;   // .. for this long
+    float idle_hop_seconds = 0.1f;    // time between (level-only) frames while idle
+    bool strike_gate = false;         // run the zoom only in a strike's sustain, over the sustain alone
+};
+
+// Realtime zoom analysis shared by the GUI and the headless CLI. A shared
+// PreDecimator brings the input down to ~12 kHz at any device rate and the
+// pipeline keeps that as its history. It streams the history through the
+// centre-partial and fundamental (centre / 2) ZoomFFT lanes, covering
+// ±span_cents each, and every hop_seconds transforms the newest window of
+// their baseband into one AnalysisFrame. Only the nodes that graph()
+// subscribers need are run; each node's own header says what it measures.
+//
+// A lane whose peak has held steady with a clear SNR locks and evaluates
+// only lock_bins DTFT bins around it, with a full zoom every
+// lock_refresh_frames. The gates decide when the lanes are fed at all:
+// coarse_gate while CoarsePitch finds something periodic, strike_gate in a
+// strike's sustain, idle_gate above the input level threshold. A lane that
+// is fed again restarts from the history. While idle only the front end
+// runs, a level-only frame comes every idle_hop_seconds, and frames report
+// the audio time spent idle and the DSP time that saved. The pipeline never
+// moves the centre itself.
+//
+// push(), analyse(), process() and set_config() belong to the audio thread;
+// the centre frequency may be changed from any thread and is picked up on
+// the next call. Everything a config allocates is built by submit_config()
+// on the caller's thread, so push() only swaps it in.
+class AnalysisPipeline {
+public:
+    explicit AnalysisPipeline(const AnalysisPipelineConfig& config = AnalysisPipelineConfig{});
+    ~AnalysisPipeline();
+
+    AnalysisPipeline(const AnalysisPipeline&) = delete;
+    AnalysisPipeline& operator=(const AnalysisPipeline&) = delete;
+
+    // Apply `config` now; the next push() builds what it changed (allocating)
+    void set_config(const AnalysisPipelineConfig& config);
+    // Control thread: build what `config` needs at `sample_rate` and queue it
+    // for the next push(), which swaps it in without allocating; false if the
+    // queue is full. Also frees what earlier swaps replaced.
+    bool submit_config(const AnalysisPipelineConfig& config, unsigned int sample_rate);
+    const AnalysisPipelineConfig& config() const { return cfg; }
+
+    void set_center_frequency(float hz) { center_hz.store(hz, std::memory_order_relaxed); }
+    float center_frequency() const { return center_hz.load(std::memory_order_relaxed); }
+
+    // Append `num_samples` at `sample_rate` to the history and the lanes;
+    // true when a hop has elapsed and analyse() should produce a frame
+    bool push(const float* input, int num_samples, unsigned int sample_rate);
+
+    // Analyse the newest window into `frame` (every field is overwritten;
+    // seq advances by one per call)
+    void analyse(AnalysisFrame& frame);
+
+    // push(), then analyse() if a frame is due; true if `frame` was written
+    bool process(const float* input, int num_samples, unsigned int sample_rate, AnalysisFrame& frame);
+
+    // Both lanes measured with SNR above `min_snr`: good enough to feed the
+    // octave-lock tracker
+    static bool lanes_valid(const AnalysisFrame& frame, float min_snr = 0.5f);
+
+    uint64_t frames_processed() const { return frames; }
+
+    AnalysisGraph& graph() { return nodes; }
+    const AnalysisGraph& graph() const { return nodes; }
+
+private:
+    // The front end at one factor and the lanes behind it
+    struct FrontEnd {
+        PreDecimator decimator;
+        std::unique_ptr<ZoomFFT> zoom;
+        std::unique_ptr<ZoomFFT> zoom_f0;
+        std::unique_ptr<ZoomFFT> zoom_fast;
+        SlidingDftBank sdft;
+    };
+    // What a config allocates at one device rate: built by prepare() off the
+    // audio thread, swapped in by install(), and freed by the control thread
+    // once it comes back with what it replaced
+    struct Prepared {
+        AnalysisPipelineConfig cfg;
+        unsigned int sample_rate = 0;
+        std::vector<FrontEnd> fronts;   // factors 1, 2, 4, .. up to the largest front_factor() picks
+        MirroredRingBuffer input;
+        MirroredRingBuffer history;
+        std::vector<float> lane_scratch;
+        std::vector<float> median_scratch;
+        std::vector<float> fast_spectrum;
+        std::vector<float> center_bins;
+        PitchLocator locator;
+        std::unique_ptr<NoteDetector> detector;     // only for a new key_detect_a4_hz
+        std::unique_ptr<KeyChannelizer> key_bank;
+    };
+
+    AnalysisPipelineConfig cfg;
+    std::atomic<float> center_hz{440.0f};
+    std::vector<FrontEnd> fronts;
+    PreDecimator* front = nullptr;      // the front end in use; the history holds its output
+    std::vector<float> front_out;
+    MirroredRingBuffer input_history;   // the input itself: the history is decimated afresh from it at a new factor
+    MirroredRingBuffer history;
+    ZoomFFT* zoom = nullptr;            // centre partial
+    ZoomFFT* zoom_f0 = nullptr;         // fundamental lane
+    ZoomFFT* zoom_fast = nullptr;       // short window over zoom's baseband
+    SlidingDftBank* sdft = nullptr;     // centre bins per decimated sample (sliding_dft)
+    bool stale = true;                  // set_config() changed what the fronts were built for
+    SpscRing<Prepared*> incoming{4};    // control thread -> push()
+    SpscRing<Prepared*> retired{8};     // push() -> control thread, to be freed
+    float submitted_a4_hz = 0.0f;       // control thread: reference pitch of the detectors last built
+    NoteDetector detector;              // KeyDetect, fed only while demanded
+    bool detector_fed = false;
+    KeyChannelizer key_bank;            // KeyBands, fed only while demanded
+    bool key_bank_fed = false;
+    PitchLocator locator;               // CoarsePitch, over the history
+    int aperiodic_frames = 0;           // CoarsePitch frames in a row with nothing periodic
+    bool zoom_gated = false;            // coarse_gate: the zoom is idle
+    bool idling = false;                // idle_gate: silence, no node runs
+    bool woke = false;                  // idle_gate: the last push() woke the pipeline
+    int quiet_samples = 0;              // input samples in a row below the idle level
+    double idle_seconds = 0.0;          // audio time spent idle
+    double idle_saved_seconds = 0.0;    // DSP time that saved against the active cost
+    float search_cost_us = 0.0f;        // recent active frames, no lane locked: pipeline time (average) ..
+    float search_cost_seconds = 0.0f;   // .. over audio time (average)
+    float locked_cost_us = 0.0f;        // the same for frames with a lane locked
+    float locked_cost_seconds = 0.0f;
+    float idle_locked_seconds = 0.0f;   // idle audio still charged at the locked cost
+    float pending_dsp_us = 0.0f;        // push() time since the last frame
+    float wake_us = 0.0f;               // restarting the lanes on waking, charged against the saving
+    StrikeTracker strike;               // Strike, on the level of each hop
+    uint64_t sustain_position = 0;      // input position where the current sustain began
+    unsigned int zoom_rate = 0;
+    uint64_t frames = 0;
+
+    // Streaming state between frames
+    float stream_center = 0.0f;         // centre the lanes' baseband was mixed for
+    bool stream_center_lane = false;    // lanes currently being fed
+    bool stream_f0_lane = false;
+    AnalysisNodeMask pending_demand = 0;
+    float pending_us[4] = {0.0f, 0.0f, 0.0f, 0.0f}; // lane streaming, key detection and key bank cost since the last frame
+    int since_frame = 0;                // input samples since the last frame (beyond whole hops)
+    uint64_t input_position = 0;        // input samples pushed
+    uint64_t last_position = 0;         // input position of the last frame
+    double rms_acc = 0.0;               // sum of squares since the last frame
+    int rms_count = 0;
+
+    // Locked tracking per lane (0 = centre, 1 = f0)
+    struct LaneLock {
+        bool locked = false;
+        int stable_frames = 0;          // consecutive full measurements agreeing on the peak
+        int frames_since_full = 0;
+        float hz = 0.0f;                // last peak
+        float noise_floor = 0.0f;       // span median from the last full measurement
+    };
+    LaneLock lane_locks[2];
+    std::complex<float> lock_scratch[16];
+
+    AnalysisGraph nodes;
+    std::vector<float> lane_scratch;
+    std::vector<float> median_scratch;
+    std::vector<float> fast_spectrum;
+    std::vector<float> center_bins;     // sliding DFT bins for the lane when the spectrum is not sampled
+
+    static std::unique_ptr<Prepared> prepare(const AnalysisPipelineConfig& config, unsigned int sample_rate);
+    // Swap `p` in; `p` then holds what it replaced
+    void install(Prepared& p);
+    // cfg = config, and restart what depends on it
+    void apply_config(const AnalysisPipelineConfig& config);
+    // Lanes behind the front end at `factor`, with the history decimated
+    // afresh for `center_hz` from the input
+    void select_front(int factor, float center_hz);
+    // Build what `sample_rate` or set_config() still lacks (allocating) and
+    // select the front end for `center_hz`
+    void ready_front(unsigned int sample_rate, float center_hz);
+    // History kept for CoarsePitch and for restarting a lane at `center_hz`, at the front end's rate
+    size_t history_samples(unsigned int sample_rate, float center_hz) const;
+    // strike_gate: in a strike's sustain, and the input samples of it so far
+    bool in_sustain() const { return strike.phase() == StrikePhase::Monitoring; }
+    uint64_t sustain_samples() const { return input_position - sustain_position; }
+    // Front-end factor for the lanes at `center_hz`: pre_decimation, scaled
+    // with the rate, as far as the centre lane's span still fits
+    int front_factor(unsigned int sample_rate, float center_hz) const;
+    // cfg.decimation rounded down to a multiple of the front end's factor
+    int decimation() const;
+    int required_samples(unsigned int sample_rate) const;  // input samples
+    int window_decimated(unsigned int sample_rate) const;  // analysed window, in decimated samples
+    // Lead-in (at the front end's rate) for the lanes' filters to settle around `center_hz`
+    size_t settle_samples(unsigned int sample_rate, float center_hz) const;
+    // Restart `lane` at `hz` and refill its baseband from the history (at the front end's rate)
+    void prime_lane(ZoomFFT& lane, float hz);
+    int fast_window_decimated(unsigned int sample_rate) const;
+    float span_median(const float* mags, int n);
+    // `spectrum`: the frame's full-span bins if they were sampled, else null;
+    // `dense`: they are exact DTFT samples (sliding DFT), refined on the grid
+    LaneMeasurement measure_lane(const ZoomFFT& lane_zoom, const float* spectrum, float lane_center_hz,
+                                 bool dense = false);
+    // measure_lane() or, while `lane_index` is locked, its DTFT bins; updates the lock
+    LaneMeasurement track_lane(int lane_index, ZoomFFT& lane_zoom, int nz, bool locked, const float* spectrum,
+                               float lane_center_hz, bool dense = false);
+    bool measure_locked(LaneLock& lock, const ZoomFFT& lane_zoom, int nz, float lane_center_hz, LaneMeasurement& out);
+    // Phase-advance frequency near `hz` in `lane`'s baseband; 0 if off or
+    // too little baseband. `variance_cents2` gets its variance.
+    float phase_frequency(const ZoomFFT& lane, float hz, float& variance_cents2) const;
+};
+
+} // namespace tuner
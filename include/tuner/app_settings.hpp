@@ -1,15 +1,54 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace tuner {
 
+// Best stable capture configuration found by the latency calibrator for one
+// device (see latency_calibrator.hpp)
+struct AudioDeviceProfile {
+    std::string device;
+    unsigned int sample_rate = 48000;
+    unsigned int period_size = 64;
+    unsigned int num_periods = 2;
+    float avg_load = 0.0f;   // mean callback time / period duration at calibration
+    float peak_load = 0.0f;  // worst callback time / period duration
+};
+
+// Fixed zoom parameters for a range of piano keys, replacing the adaptive
+// schedule (see zoom_scheduler.hpp). Zero fields keep the scheduled value.
+struct ZoomRegisterOverride {
+    int first_key = 1;   // 1..88, inclusive
+    int last_key = 88;
+    int fft_size = 0;
+    int decimation = 0;
+    float window_seconds = 0.0f;
+};
+
 struct AppSettings {
     float center_frequency_hz = 440.0f;
     int precise_fft_size = 16384; // fixed for now
     int precise_decimation = 16;
     float precise_window_seconds = 0.35f;
 
+    // Adaptive zoom: FFT size, decimation and window chosen per key instead
+    // of the precise_* values above
+    bool adaptive_zoom = true;
+    float zoom_resolution_cents = 10.0f;   // target window resolution (1/T) at the analysed partial
+    float zoom_bin_cents = 4.0f;           // target FFT bin spacing
+    float zoom_max_window_seconds = 1.0f;  // bass latency (and cost) cap
+    float zoom_span_cents = 120.0f;        // zoom span (±cents); narrower spans decimate further
+    std::vector<ZoomRegisterOverride> zoom_overrides;
+    float analysis_rate_hz = 100.0f;       // spectra per second; the STFT hop is 1 / rate
+    bool sliding_dft_spectrum = false;     // centre spectrum from a sliding DFT bank, not the zoom FFT
+    bool auto_detect_note = false;         // move to each key struck, detected across the keyboard
+    bool idle_on_silence = false;          // measure only the input level while the room is quiet
+    float idle_threshold_db = -60.0f;      // input RMS (dBFS) that wakes the analysis
+    bool sustain_only = false;             // measure each strike's sustain, skipping the hammer attack
+    bool pitch_gate = false;               // skip the zoom while the coarse pitch finds nothing periodic
+    bool follow_pitch = false;             // move the centre to the partial the coarse pitch finds off the span
+
     // Spectrum view
     bool show_frequency_lines = true;
     bool show_peak_line = true;
@@ -25,6 +64,10 @@ struct AppSettings {
 
     // General settings: last opened session path for Resume action
     std::string last_session_path;
+
+    // Capture device and calibrated per-device period configuration
+    std::string audio_device = "hw:1,0";
+    std::vector<AudioDeviceProfile> audio_profiles;
 };
 
 } // namespace tuner
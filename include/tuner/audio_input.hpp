@@ -5,14 +5,35 @@
 #include <memory>
 #include <string>
 
+#include "channel_mix.hpp"
+#include "sample_format.hpp"
+
 namespace tuner {
 
+// Pacing for non-device sources (WAV files, synthetic signals)
+enum class PlaybackMode {
+    Realtime,          // deliver one period per period duration
+    AsFastAsPossible,  // deliver back-to-back on the backend thread
+    SingleStep         // deliver one period per explicit step() call
+};
+
 struct AudioConfig {
     std::string device_name = "default";
     unsigned int sample_rate = 48000;
     unsigned int period_size = 64;
     unsigned int num_periods = 2;
     bool use_realtime_priority = true;
+    // Preferred capture format; the backend falls back through the other
+    // formats in preference order and stores the negotiated one here.
+    SampleFormat sample_format = SampleFormat::Float32LE;
+    // Capture channel count (negotiated value is stored back) and how the
+    // channels are reduced to the mono stream passed to the process callback
+    unsigned int channels = 1;
+    ChannelMode channel_mode = ChannelMode::Select;
+    int channel_select = 0;
+    // Non-device sources ("file:", "synth:"): pacing and looping
+    PlaybackMode playback_mode = PlaybackMode::Realtime;
+    bool loop_playback = false;
 };
 
 class IAudioInput {
@@ -35,11 +56,23 @@ public:
         int xruns;
     };
     virtual LatencyStats get_latency_stats() const = 0;
+
+    // Deliver one period synchronously on the caller's thread. Only sources
+    // started in PlaybackMode::SingleStep support this; returns false when
+    // stepping is unsupported or the source is exhausted.
+    virtual bool step() { return false; }
 };
 
-// Factory that returns the active platform backend
+// Factory that returns the backend selected by config.device_name:
+// "file:<path.wav>" streams a WAV file, "synth:<spec>" renders synthetic piano
+// notes (see parse_piano_synth_spec), anything else opens an ALSA device
 std::unique_ptr<IAudioInput> createAudioInput(const AudioConfig& config);
 
+// Individual backends
+std::unique_ptr<IAudioInput> createAlsaAudioInput(const AudioConfig& config);
+std::unique_ptr<IAudioInput> createFileAudioInput(const AudioConfig& config);
+std::unique_ptr<IAudioInput> createSynthAudioInput(const AudioConfig& config);
+
 } // namespace tuner
 
 
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "audio_input.hpp"
+
+namespace tuner {
+
+// IAudioInput that streams an in-memory mono buffer through the process
+// callback in period-sized chunks. Used by the WAV file and synthetic
+// backends; pacing follows AudioConfig::playback_mode.
+class BufferAudioInput : public IAudioInput {
+public:
+    // config.sample_rate is replaced by `sample_rate` (the source's native rate)
+    BufferAudioInput(const AudioConfig& cfg, std::vector<float> samples, int sample_rate);
+    ~BufferAudioInput() override;
+
+    bool start() override;
+    void stop() override;
+    bool is_running() const override { return running.load(); }
+
+    void set_process_callback(ProcessCallback callback) override { process_callback = callback; }
+    const AudioConfig& get_config() const override { return config; }
+    LatencyStats get_latency_stats() const override;
+
+    bool step() override;
+
+    // True once the whole buffer has been delivered (never with loop_playback)
+    bool finished() const { return done.load(); }
+    std::size_t frames_delivered() const { return delivered.load(); }
+    std::size_t total_frames() const { return samples.size(); }
+
+private:
+    AudioConfig config;
+    std::vector<float> samples;
+    std::size_t position = 0;
+    std::atomic<bool> running{false};
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> delivered{0};
+    std::thread worker;
+    ProcessCallback process_callback;
+
+    // Callback timing, same meaning as the ALSA backend's stats
+    std::atomic<float> min_latency_ms{1000.0f};
+    std::atomic<float> max_latency_ms{0.0f};
+    std::atomic<float> total_latency_ms{0.0f};
+    std::atomic<int> latency_count{0};
+    std::atomic<int> xrun_count{0};  // realtime mode: periods delivered late
+
+    bool deliver_period();
+    void thread_func();
+};
+
+} // namespace tuner
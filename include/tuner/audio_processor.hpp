@@ -7,6 +7,8 @@
 #include <memory>
 #include <string>
 
+#include "spsc_ring.hpp"
+
 namespace tuner {
 
 struct AudioConfig {
@@ -72,53 +74,9 @@ private:
     snd_pcm_format_t sample_format = SND_PCM_FORMAT_FLOAT_LE;
 };
 
-// Lock-free ring buffer for passing results between threads
+// Former single-element ring; SpscRing provides the same push()/pop() plus
+// bulk transfers. Use LatestSnapshot for "latest value" reads.
 template<typename T>
-class RingBuffer {
-public:
-    explicit RingBuffer(size_t size) 
-        : buffer(size), write_index(0), read_index(0) {}
-    
-    bool push(const T& item) {
-        size_t write_idx = write_index.load(std::memory_order_relaxed);
-        size_t next_idx = (write_idx + 1) % buffer.size();
-        
-        if (next_idx == read_index.load(std::memory_order_acquire)) {
-            return false;  // Buffer full
-        }
-        
-        buffer[write_idx] = item;
-        write_index.store(next_idx, std::memory_order_release);
-        return true;
-    }
-    
-    bool pop(T& item) {
-        size_t read_idx = read_index.load(std::memory_order_relaxed);
-        
-        if (read_idx == write_index.load(std::memory_order_acquire)) {
-            return false;  // Buffer empty
-        }
-        
-        item = buffer[read_idx];
-        read_index.store((read_idx + 1) % buffer.size(), std::memory_order_release);
-        return true;
-    }
-    
-    bool get_latest(T& item) {
-        size_t write_idx = write_index.load(std::memory_order_acquire);
-        if (write_idx == 0) {
-            return pop(item);  // Use pop if at beginning
-        }
-        
-        size_t latest_idx = (write_idx - 1 + buffer.size()) % buffer.size();
-        item = buffer[latest_idx];
-        return true;
-    }
-    
-private:
-    std::vector<T> buffer;
-    std::atomic<size_t> write_index;
-    std::atomic<size_t> read_index;
-};
+using RingBuffer = SpscRing<T>;
 
 } // namespace tuner
\ No newline at end of file
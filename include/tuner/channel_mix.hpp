@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+namespace tuner {
+
+// How multi-channel captures are reduced to the mono stream the DSP consumes
+enum class ChannelMode {
+    Select,     // use one channel (AudioConfig::channel_select)
+    Average,    // mean of all channels
+    MaxEnergy   // per band: the channel with the highest smoothed energy below
+                // and above ChannelCombiner::CROSSOVER_HZ (bass / treble mics)
+};
+
+const char* channel_mode_name(ChannelMode mode);
+
+// Split `frames` interleaved frames into per-channel planes.
+// Vectorized for 2 and 4 channels; other counts use a scalar loop.
+void deinterleave(const float* interleaved, int frames, int channels, float* const* planes);
+
+// Reduces interleaved multi-channel blocks to mono according to ChannelMode.
+// All buffers are sized in configure(); process() does not allocate as long as
+// blocks stay within max_frames.
+// MaxEnergy splits every channel with a complementary crossover (2nd-order
+// Butterworth lowpass, high = input - low) and picks a channel per band, so
+// a mic over the bass strings can feed the low registers while one over the
+// treble feeds the rest. When both bands pick the same channel the output is
+// that channel unchanged.
+class ChannelCombiner {
+public:
+    static constexpr float CROSSOVER_HZ = 260.0f;   // around middle C
+
+
+    void configure(int channels, ChannelMode mode, int select_channel, int sample_rate, int max_frames);
+
+    // Combine one interleaved block into `mono` (frames samples)
+    void process(const float* interleaved, int frames, float* mono);
+
+    int channels() const { return num_channels; }
+    ChannelMode mode() const { return channel_mode; }
+    // Channel currently feeding the output (Select), the band above the
+    // crossover (MaxEnergy), -1 for Average
+    int active_channel() const { return active; }
+    // Channel feeding the band below the crossover (MaxEnergy), else active_channel()
+    int active_bass_channel() const { return channel_mode == ChannelMode::MaxEnergy ? active_low : active; }
+    // Smoothed per-channel mean-square energy (MaxEnergy: sum of both bands)
+    const std::vector<float>& channel_energy() const { return energy; }
+
+private:
+    int num_channels = 1;
+    ChannelMode channel_mode = ChannelMode::Select;
+    int active = 0;
+    int active_low = 0;
+    float energy_alpha = 0.05f;        // EMA coefficient per block
+    float switch_ratio = 1.26f;        // ~1 dB hysteresis before switching channel
+    std::vector<std::vector<float>> planes;
+    std::vector<float*> plane_ptrs;
+    std::vector<float> energy;
+    // MaxEnergy crossover: lowpass coefficients, per-channel state and low band
+    float lp_b0 = 0.0f, lp_b1 = 0.0f, lp_b2 = 0.0f, lp_a1 = 0.0f, lp_a2 = 0.0f;
+    std::vector<float> lp_state;        // z1, z2 per channel
+    std::vector<std::vector<float>> low_planes;
+    std::vector<float> low_energy;
+    std::vector<float> high_energy;
+
+    // Index of the strongest entry of `e`, or `current` unless it is clearly stronger
+    int pick_channel(const std::vector<float>& e, int current) const;
+};
+
+} // namespace tuner
@@ -5,10 +5,13 @@
 
 namespace tuner::fft {
 
+// Build the bit-reversal and twiddle tables for size `n` ahead of time, so
+// that compute_fft_inplace() of that size never allocates (e.g. before it
+// runs on the audio thread). Safe to call from any thread.
+void prepare_fft(int n);
+
 // In-place iterative radix-2 FFT using cached bit-reversal and twiddles.
 // Size must be a power of two.
 void compute_fft_inplace(std::vector<std::complex<float>>& data);
 
 } // namespace tuner::fft
-
-
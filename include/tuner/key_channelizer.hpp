@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "mirrored_ring.hpp"
+#include "pre_decimator.hpp"
+
+namespace tuner {
+
+struct KeyChannelizerConfig {
+    int channels = 128;            // per tier; the channel spacing is the tier's rate / channels
+    int taps_per_channel = 4;      // prototype lowpass length, in channels
+    float a4_hz = 440.0f;          // key frequencies
+    float onset_rise_db = 9.0f;    // a key's level must rise this far over its recent low to count as an onset
+    float onset_min_db = -50.0f;   // and reach at least this (dBFS)
+    int max_partials = 16;         // partials of a lower key that can explain an onset
+    float partial_tolerance_cents = 35.0f;  // beyond a key's band, where the B prior may put them
+};
+
+// What the bank measures for one key
+struct KeyBand {
+    float level_db = -120.0f;      // amplitude of the strongest peak in the key's band, dBFS of a sine; -120 = none
+    float hz = 0.0f;               // that channel's frequency from its phase advance; 0 = nothing in the band
+    int onsets = 0;                // onsets since reset()
+};
+
+// Energy and coarse pitch of all 88 keys at once, from uniform polyphase
+// filter banks (FFT channelizers). Piano keys are spaced logarithmically
+// and the channels of one bank uniformly, so the input is split into
+// tiers two octaves apart: ~12 kHz, ~3 kHz, ~750 Hz and ~190 Hz, each the
+// previous one through a PreDecimator. Each tier runs the same bank of
+// `channels` channels, two times oversampled (a frame every channels / 2
+// samples): the newest channels * taps_per_channel samples are weighted by
+// a windowed-sinc prototype, folded to `channels` points and transformed.
+//
+// A key is read from the lowest-rate tier whose passband holds its band
+// (±50 cents around it), where the channels are finest: from about one
+// channel per key at the bottom of a tier to three at its top. Channels
+// overlap, so each is given the frequency of its phase advance between
+// frames, and a key takes the strongest channel that is a peak among its
+// neighbours and whose frequency falls in its band: a tone counts for one
+// key, not for the keys it leaks into. A key's band holds the partials of
+// lower keys too, so a struck key also lights up the keys its upper
+// partials fall on.
+//
+// An onset is a rise of onset_rise_db that stands for a while, so that a
+// hammer's thump, which lifts every band for a moment, does not count.
+// Lower tiers react later, by about 0.4 of their prototype's length: a
+// rise shows ~20 ms after the strike at the top of the keyboard, 0.1 s and
+// 0.3 s in the middle tiers and ~1 s below ~75 Hz, where neighbouring
+// fundamentals are 2-4 Hz apart.
+//
+// Those upper partials rise with the struck key, on higher keys whose
+// tiers react sooner. So a rise is held until every lower key one of whose
+// first max_partials partials, k f1 sqrt(1 + B k^2) with B from
+// typical_inharmonicity(), falls in the key's band could have shown the
+// same strike: on its own key, or on that of one of its partials 2-4 that
+// is not among this key's partials. If one of them rose at about the same
+// time, the rise was a partial and is dropped. Onsets thereby come ~0.3 s
+// after the strike at the top of the keyboard, 0.5-0.8 s in the middle and
+// 1.1-1.6 s in the bass. A key struck together with a note whose partial
+// it holds (an octave above, say) is not counted; a partial whose rise
+// its beats hold off well past the strike still can be.
+//
+// AnalysisPipeline's KeyBands node runs it over the raw input.
+class KeyChannelizer {
+public:
+    static constexpr int NUM_KEYS = 88;
+
+    explicit KeyChannelizer(const KeyChannelizerConfig& config = KeyChannelizerConfig{});
+
+    void set_config(const KeyChannelizerConfig& config);
+    const KeyChannelizerConfig& config() const { return cfg; }
+
+    // Forget the history, levels and onset counts
+    void reset();
+
+    // Append `num_samples` at `sample_rate`
+    void push(const float* input, int num_samples, unsigned int sample_rate);
+
+    const std::array<KeyBand, NUM_KEYS>& keys() const { return bands; }
+
+private:
+    static constexpr int NUM_TIERS = 4;
+
+    struct Tier {
+        PreDecimator decimator;           // from the tier above (the device rate for the first)
+        std::vector<float> out;
+        MirroredRingBuffer history;
+        int since_frame = 0;              // tier samples since the last frame
+        float rate = 0.0f;
+        bool primed = false;              // a frame ran since reset(): phases to advance from
+        std::vector<float> last_phase;    // per channel, the frame before
+        int first_key = 0, end_key = 0;   // keys read from this tier
+        int confirm_frames = 1;           // an onset's rise must stand this long
+        float latency = 0.0f;             // seconds from a strike to its rise confirmed: half the prototype, then confirm_frames
+        float lag = 0.0f;                 // seconds from a strike until its rise shows
+        float spread = 0.0f;              // how far that may be off: half the prototype
+        float hop_seconds = 0.0f;
+    };
+
+    // Per key: its band, the channels of its tier that can fall in it, onset state
+    struct KeyState {
+        float lo_hz = 0.0f, hi_hz = 0.0f;
+        int lo = 0, hi = 0;
+        float smooth = 0.0f;              // power, smoothed over a few frames
+        float low_db = -120.0f;           // recent low of the smoothed level, rising slowly
+        int hold = 0;                     // frames left in which the level still rises from the last onset
+        int above = 0;                    // frames in a row the level has stood risen
+        int tier = 0;
+        double rising_since = -1.0;       // when the current rise began; < 0 outside one
+        double struck_at = -1e9;          // strike time estimated from the last rise, seconds of input
+        double decide_at = 0.0;           // when a pending rise is counted unless a lower key explains it
+        bool pending = false;
+        float wait = 0.0f;                // seconds until every lower key that can explain a rise has shown its strike
+        std::bitset<NUM_KEYS> evidence;   // keys whose rise with this one marks it a lower key's partial
+    };
+
+    KeyChannelizerConfig cfg;
+    unsigned int rate = 0;
+    std::array<Tier, NUM_TIERS> tiers;
+    std::array<KeyState, NUM_KEYS> key_state{};
+    std::array<KeyBand, NUM_KEYS> bands{};
+    uint64_t clock = 0;                   // input samples since reset()
+    std::vector<float> prototype;         // channels * taps_per_channel taps
+    std::vector<std::complex<float>> folded;
+    std::vector<float> channel_mag;       // this frame, channels 0 .. channels / 2
+    std::vector<float> channel_hz;        // from the phase advance; 0 before a frame to advance from
+    float gain = 1.0f;                    // 2 / sum of the prototype: a sine's amplitude at a channel centre
+
+    void configure(unsigned int sample_rate);
+    void run_frame(Tier& tier);
+    void resolve_onsets();
+};
+
+} // namespace tuner
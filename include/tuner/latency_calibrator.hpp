@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "app_settings.hpp"
+#include "audio_input.hpp"
+
+namespace tuner {
+
+struct CalibrationOptions {
+    // Candidates are tried smallest period first, then fewest periods. Capture
+    // latency is set by the period; extra periods only add slack for late reads.
+    std::vector<unsigned int> period_sizes{32, 64, 128, 256, 512, 1024};
+    std::vector<unsigned int> period_counts{2, 3, 4};
+    float trial_seconds = 4.0f;   // measured duration per candidate
+    float warmup_seconds = 0.5f;  // ignored at the start of each trial (first-call allocations, device settling)
+    int max_xruns = 0;            // xruns allowed during the measured part of a trial
+    float max_avg_load = 0.6f;    // mean callback time / period duration
+    // Worst callback must finish within this fraction of the slack the buffer
+    // gives it: (num_periods - 1) periods
+    float max_peak_headroom = 0.8f;
+    bool stop_at_first_stable = true;
+};
+
+struct CalibrationTrial {
+    unsigned int period_size = 0;   // requested
+    unsigned int num_periods = 0;
+    AudioConfig negotiated;         // what the backend actually opened
+    bool started = false;
+    bool stable = false;
+    int xruns = 0;
+    int callbacks = 0;
+    float avg_load = 0.0f;
+    float peak_load = 0.0f;
+    float latency_ms = 0.0f;        // negotiated period duration
+};
+
+struct CalibrationResult {
+    bool found = false;
+    AudioConfig best;               // negotiated config of the lowest-latency stable trial
+    CalibrationTrial best_trial;
+    std::vector<CalibrationTrial> trials;
+};
+
+// Sweeps period size and count on one device while the real DSP callback runs,
+// and picks the smallest period that runs without xruns and keeps callback
+// load within the configured headroom. Blocks for the duration of the sweep;
+// run it off the UI thread.
+class LatencyCalibrator {
+public:
+    using Factory = std::function<std::unique_ptr<IAudioInput>(const AudioConfig&)>;
+    using ProgressCallback = std::function<void(const CalibrationTrial& trial, int index, int total)>;
+
+    explicit LatencyCalibrator(const AudioConfig& base, CalibrationOptions options = {},
+                               Factory factory = createAudioInput);
+
+    // `process` is the callback the application normally installs; `cancel`
+    // may be set from another thread to abort between trials.
+    CalibrationResult run(const IAudioInput::ProcessCallback& process,
+                          const ProgressCallback& progress = {},
+                          const std::atomic<bool>* cancel = nullptr);
+
+private:
+    AudioConfig base_config;
+    CalibrationOptions options;
+    Factory factory;
+
+    CalibrationTrial run_trial(unsigned int period_size, unsigned int num_periods,
+                               const IAudioInput::ProcessCallback& process,
+                               const std::atomic<bool>* cancel);
+};
+
+// Store the result for `device` in settings (replacing an older entry)
+void store_audio_profile(AppSettings& settings, const std::string& device, const CalibrationTrial& trial);
+
+// Apply the stored profile for config.device_name, if any. Returns true if found.
+bool apply_audio_profile(const AppSettings& settings, AudioConfig& config);
+
+} // namespace tuner
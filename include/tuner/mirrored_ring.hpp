@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace tuner {
+
+// Sample history whose storage is mapped twice back to back (memfd + mmap),
+// so the most recent N samples are always one contiguous `const float*` with
+// no copying. Where the double mapping is unavailable it falls back to a 2x
+// linear buffer in which every sample is written twice.
+//
+// One writer. Readers on the same thread can use latest() directly. A reader
+// on another thread snapshots write_position(), reads window_at(), and then
+// checks still_valid() to detect whether the writer overwrote the window in
+// the meantime.
+class MirroredRingBuffer {
+public:
+    MirroredRingBuffer() = default;
+    explicit MirroredRingBuffer(size_t min_capacity) { allocate(min_capacity); }
+    ~MirroredRingBuffer();
+
+    MirroredRingBuffer(const MirroredRingBuffer&) = delete;
+    MirroredRingBuffer& operator=(const MirroredRingBuffer&) = delete;
+    MirroredRingBuffer(MirroredRingBuffer&& other) noexcept;
+    MirroredRingBuffer& operator=(MirroredRingBuffer&& other) noexcept;
+
+    // (Re)allocate for at least `min_capacity` samples and clear. The mirrored
+    // mapping rounds the capacity up to whole pages. Returns false if no
+    // storage could be obtained.
+    bool allocate(size_t min_capacity);
+    void release();
+    void clear();
+
+    // Append samples; only the newest capacity() samples are kept
+    void push(const float* data, size_t count);
+
+    // Newest `count` samples, oldest first; `count` is clamped to size()
+    const float* latest(size_t count) const { return window_at(write_position(), count > size() ? size() : count); }
+
+    // Window of `count` samples ending at absolute position `end` (a value
+    // previously returned by write_position())
+    const float* window_at(uint64_t end, size_t count) const;
+    // True if the window ending at `end` has not been overwritten since.
+    // `in_flight` is the largest push the writer may have started but not yet
+    // published (its period size), since those samples are not counted yet.
+    bool still_valid(uint64_t end, size_t count, size_t in_flight = 0) const;
+
+    uint64_t write_position() const { return written.load(std::memory_order_acquire); }
+    size_t size() const;
+    size_t capacity() const { return cap; }
+    bool is_mirrored() const { return mirrored; }
+
+private:
+    float* base = nullptr;
+    size_t cap = 0;            // samples
+    size_t map_bytes = 0;      // bytes of one mapping (mirrored) or of the whole fallback buffer
+    bool mirrored = false;
+    std::atomic<uint64_t> written{0};
+
+    bool map_mirrored(size_t min_capacity);
+};
+
+} // namespace tuner
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+#include "mirrored_ring.hpp"
+#include "pre_decimator.hpp"
+
+namespace tuner {
+
+struct NoteDetectorConfig {
+    int fft_size = 4096;                  // full-band real FFT at ~12 kHz (0.34 s)
+    float hop_seconds = 0.1f;             // time between detection passes
+    float a4_hz = 440.0f;                 // key frequencies for the comb
+    int max_partials = 16;                // per key, below ~4.5 kHz
+    float partial_tolerance_cents = 35.0f;  // around each partial the B prior predicts
+    float min_score = 3.0f;               // weakest best key that still counts
+    int confirm_passes = 2;               // same best key this many passes in a row to switch
+};
+
+// Best key of one pass, and the key the detector has settled on
+struct NoteDetection {
+    int key = -1;              // confirmed key, 0-based (A0 = 0 .. C8 = 87); -1 before any
+    int candidate = -1;        // best key of the last pass; -1 if below min_score
+    float score = 0.0f;        // its comb score
+    int strikes = 0;           // keys confirmed since reset(), a re-strike of the same key included
+    int passes = 0;            // detection passes run since reset()
+};
+
+// Keyboard-wide detection of the key just struck, for retargeting the zoom
+// lanes. The input is lowpassed and decimated to ~12 kHz; every hop_seconds
+// a Hann-windowed real FFT of the newest fft_size samples gives each bin's
+// log level over the local noise floor, and how far it rose since the
+// window before. The rise is scored against all 88 keys with an inharmonic
+// comb: partial k of a key is looked for within ±partial_tolerance_cents of
+// k f1 sqrt(1 + B k^2), B from typical_inharmonicity(), weighted 1/k. Notes
+// still ringing from earlier strikes do not rise, so they do not compete.
+// The 1/k weights rank the struck key above its octaves: the octave below
+// matches only every other partial, and the octave above misses the odd
+// ones, which outweigh the even ones.
+//
+// A key is confirmed once it is the best for confirm_passes passes in a row,
+// and stays confirmed while it rings and through silence, until another key
+// is struck and confirmed.
+//
+// AnalysisPipeline's KeyDetect node runs it over the raw input and reports
+// the key struck last; AutoNote consumers retarget the lanes to it.
+class NoteDetector {
+public:
+    explicit NoteDetector(const NoteDetectorConfig& config = NoteDetectorConfig{});
+
+    void set_config(const NoteDetectorConfig& config);
+    const NoteDetectorConfig& config() const { return cfg; }
+
+    // Forget the history and the confirmed key
+    void reset();
+
+    // Append `num_samples` at `sample_rate`; true if a detection pass ran
+    bool push(const float* input, int num_samples, unsigned int sample_rate);
+
+    const NoteDetection& detection() const { return result; }
+
+    // Comb scores of the last pass, per key (88 entries; empty before one)
+    const std::vector<float>& key_scores() const { return scores; }
+
+    static constexpr int NUM_KEYS = 88;
+
+private:
+    NoteDetectorConfig cfg;
+    NoteDetection result;
+    PreDecimator front;
+    std::vector<float> front_out;
+    MirroredRingBuffer history;
+    unsigned int rate = 0;
+    int since_pass = 0;                   // decimated samples since the last pass
+    int streak = 0;                       // passes the candidate has been best in a row
+
+    // Per pass
+    std::vector<float> window;            // Hann
+    std::vector<std::complex<float>> packed;  // even samples real, odd imaginary: half-size complex FFT
+    std::vector<std::complex<float>> twiddle; // e^(-2 pi i k / fft_size), k < fft_size / 2
+    std::vector<float> level;             // log level over the local floor per bin
+    std::vector<float> block_floor;       // log floor per block of bins
+    std::vector<float> rise;              // log magnitude gained over `lag` passes back, at most `level`
+    std::vector<float> past;              // the last `lag` passes' log magnitudes, oldest at past_next
+    int lag = 1;
+    int past_next = 0;
+    std::vector<float> scratch;
+    std::vector<float> scores;
+
+    // Comb: for key i, partials [key_first[i], key_first[i + 1]) of these
+    struct Partial {
+        int lo = 0, hi = 0;               // bin range searched
+        float weight = 0.0f;              // 1 / k
+    };
+    std::vector<Partial> partials;
+    std::vector<int> key_first;
+    int band_lo = 1, band_hi = 1;         // bins the floor and the comb cover
+
+    void configure(unsigned int sample_rate);
+    void run_pass();
+};
+
+} // namespace tuner
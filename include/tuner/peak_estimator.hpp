@@ -0,0 +1,27 @@
+#pragma once
+
+#include <complex>
+
+namespace tuner {
+
+// How a spectral peak is located between FFT bins
+enum class PeakEstimator : int {
+    Grid = 0,         // the sampled display bins (0.2 cents at 1200 bins); no refinement
+    QuadraticLog,     // parabola through the log magnitudes of three bins (Gaussian fit)
+    Jacobsen,         // complex three-bin estimator, scaled for the window and zero padding
+    WindowCorrected   // inverts the exact window kernel: no bias in the noise-free case
+};
+
+const char* peak_estimator_name(PeakEstimator method);
+// Parse "grid", "qlog", "jacobsen" or "window"; false if unknown
+bool parse_peak_estimator(const char* name, PeakEstimator& out);
+
+// Offset in bins (about -0.5..0.5) of the true peak from bin `k`, given the
+// complex bins k-1, k, k+1 of an FFT of `fft_size` points over
+// `window_length` samples (Hann or rectangular, zero-padded to fft_size).
+// `k` is the signed bin (negative frequencies below zero), which fixes the
+// window's linear phase the complex estimators remove. Grid returns 0.
+float peak_offset(PeakEstimator method, const std::complex<float> bins[3], int k, int window_length, int fft_size,
+                  bool hann);
+
+} // namespace tuner
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tuner {
+
+// One struck note. Partial k sits at k * f1 * sqrt(1 + B k^2); each partial is
+// rendered by `unison_strings` slightly detuned strings so that it beats.
+struct PianoNoteSpec {
+    float f1 = 440.0f;                 // string fundamental (Hz) in the stiff-string model
+    float B = 4.0e-4f;                 // inharmonicity coefficient
+    int num_partials = 16;             // partials above 0.45*Fs are dropped
+    int unison_strings = 3;            // 1..3
+    float unison_detune_cents = 0.6f;  // spread between the outermost strings
+    float amplitude = 0.5f;            // peak amplitude of partial 1 (all strings summed)
+    float rolloff = 1.0f;              // partial k starts at amplitude / k^rolloff
+    float decay_s = 4.0f;              // 1/e decay time of partial 1
+    float decay_slope = 0.35f;         // partial k decays (1 + slope*(k-1)) times faster
+    float onset_s = 0.0f;              // strike time within the rendered buffer
+    float hammer_noise = 0.2f;         // hammer thump level relative to amplitude (0 = off)
+    float hammer_noise_ms = 12.0f;     // thump decay time
+};
+
+struct PianoSynthConfig {
+    int sample_rate = 48000;
+    float duration_s = 3.0f;
+    float snr_db = 60.0f;              // white noise vs. signal RMS; <= -200 or >= 200 disables noise
+    uint32_t seed = 1;                 // partial phases, hammer thump and noise are seeded; the unison detune is fixed
+    std::vector<PianoNoteSpec> notes;
+};
+
+// Ground truth for one rendered note
+struct PianoNoteTruth {
+    float f1 = 0.0f;
+    float B = 0.0f;
+    float onset_s = 0.0f;
+    std::vector<float> partial_hz;     // index k-1 -> partial k (centre of the unison spread)
+};
+
+struct PianoGroundTruth {
+    int sample_rate = 0;
+    float noise_rms = 0.0f;
+    float signal_rms = 0.0f;
+    std::vector<PianoNoteTruth> notes;
+};
+
+// k * f1 * sqrt(1 + B k^2)
+double piano_partial_frequency(double f1, double B, int k);
+
+// Typical inharmonicity for a key (MIDI note number), interpolated from
+// published measurements of mid-size grands; used as a default when a
+// synthetic note does not set B explicitly.
+float typical_inharmonicity(int midi_note);
+
+// Render the configured notes into a mono buffer. Deterministic for a given
+// config (including seed). `truth` receives the exact partial frequencies.
+std::vector<float> synthesize_piano(const PianoSynthConfig& config, PianoGroundTruth* truth = nullptr);
+
+// Parse a device spec of the form "synth:key=value,key=value;key=value..." used
+// by the synthetic audio backend. ';' starts another note. Per-note keys: note
+// (MIDI number or name like A4/C#5/Bb3), f1, B, partials, strings, detune, amp,
+// rolloff, decay, onset, hammer. Global keys: snr, dur, seed, rate. A segment
+// with only global keys adds no note; a spec with no note at all plays the
+// default A4. A note given by name without B gets typical_inharmonicity().
+// Returns false on an unknown key or malformed value and describes it in
+// `error`; `out.sample_rate` is kept unless `rate` is given.
+bool parse_piano_synth_spec(const std::string& spec, PianoSynthConfig& out, std::string* error = nullptr);
+
+} // namespace tuner
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+namespace tuner {
+
+struct PitchLocatorConfig {
+    float threshold = 0.2f;        // normalised difference below which a lag counts as a period
+};
+
+// Coarse fundamental of the newest samples; f0_hz = 0 when nothing periodic was found
+struct PitchEstimate {
+    float f0_hz = 0.0f;
+    float periodicity = 0.0f;      // 1 - normalised difference at the best lag (1 = exactly periodic)
+};
+
+// How the lag products are computed
+enum class LagMethod {
+    Auto,    // whichever is cheaper for the lag range
+    Direct,  // a vectorised sum of squared differences per lag
+    Fft,     // all lags at once from a cross-correlation by FFT
+};
+
+// Coarse f0 by YIN: over a window as long as the longest period looked for,
+// the difference d(tau) between the signal and itself tau samples later,
+// divided by its mean over the shorter lags. The first lag whose normalised
+// difference falls below `threshold` is taken at the bottom of its dip and
+// refined with a parabola. That is the shortest period, so partials above
+// the fundamental, whose periods divide it, do not win over it. Periods of
+// only a few samples fall between whole lags, so when max_hz allows them
+// the samples are first interpolated to up to 8 times the rate.
+//
+// The lag products are summed directly, several samples per instruction,
+// or for long lag ranges from the energies of the two windows and their
+// cross-correlation, which an FFT gives for every lag at once; whichever is
+// cheaper. With fft_utils' transform the direct sums win up to about 3500
+// lags, which covers the whole piano at the pipeline's ~12 kHz.
+//
+// AnalysisPipeline's CoarsePitch node runs it over the history, from an
+// eighth of the centre to four times it, and reports the partial of the
+// fundamental nearest the centre; Recenter consumers move the centre there.
+class PitchLocator {
+public:
+    explicit PitchLocator(const PitchLocatorConfig& config = PitchLocatorConfig{});
+
+    void set_config(const PitchLocatorConfig& config) { cfg = config; }
+    const PitchLocatorConfig& config() const { return cfg; }
+
+    // Fundamental between min_hz and max_hz in the newest of the `count`
+    // samples at `x` (oldest first); reads at most twice the longest period
+    PitchEstimate locate(const float* x, int count, float sample_rate, float min_hz, float max_hz);
+    // Scratch for locate() calls of up to `max_count` samples at up to
+    // `sample_rate` and min_hz down to `min_hz`, which then never allocate
+    void reserve(int max_count, float sample_rate, float min_hz);
+
+    // Force a method (benchmarks); Auto by default
+    void set_method(LagMethod method) { forced = method; }
+    // Method the last locate() used
+    LagMethod last_method() const { return used; }
+
+private:
+    PitchLocatorConfig cfg;
+    LagMethod forced = LagMethod::Auto;
+    LagMethod used = LagMethod::Direct;
+    std::vector<float> difference;              // d(tau), then normalised
+    std::vector<double> energy;                 // running sum of squares
+    std::vector<std::complex<float>> spectrum;  // cross-correlation by FFT
+    std::vector<float> upsampled;               // short periods: the span at a multiple of the rate
+    std::vector<float> interpolator;            // windowed sinc per output phase
+    int upsample = 0;                           // factor the interpolator was built for
+
+    void build_interpolator(int factor);
+};
+
+} // namespace tuner
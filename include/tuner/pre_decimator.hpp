@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+namespace tuner {
+
+// Real lowpass-and-decimate ahead of the zoom lanes. Nothing the tuner
+// analyses is above ~5 kHz, so one such stage per block lets every lane mix
+// and filter at input_rate / factor instead of the device rate.
+//
+// Linear-phase Kaiser FIR (80 dB): flat to 0.4 of the output rate, and
+// everything that would fold below that is in the stopband. Only every
+// factor-th output is computed, so it costs about 25 multiply-adds per input
+// sample at any factor.
+class PreDecimator {
+public:
+    // `factor`: 1 (pass-through) or a power of two up to 16. process() calls
+    // of up to `max_block` samples then never allocate.
+    void configure(int sample_rate, int factor, int max_block = 0);
+    void reset();
+
+    // Filter `input` and keep every factor()-th sample. Writes at most
+    // max_output(num_samples) samples to `out`; returns how many.
+    int process(const float* input, int num_samples, float* out);
+    int max_output(int num_samples) const { return num_samples / r + 1; }
+
+    int factor() const { return r; }
+    int output_rate() const { return rate / r; }
+
+    // Highest frequency passed flat at `factor` (all of them at 1)
+    static float passband_hz(int sample_rate, int factor);
+    // Largest power of two up to `max_factor` whose passband reaches `hz`
+    static int factor_for(int sample_rate, float hz, int max_factor);
+
+private:
+    int r = 1;
+    int rate = 0;
+    std::vector<float> taps;   // reversed and zero-padded: an output is a dot product over the newest taps.size() inputs
+    std::vector<float> line;   // the last taps.size() - 1 inputs, then the block being filtered
+    int skip = 0;              // inputs before the next kept one
+};
+
+} // namespace tuner
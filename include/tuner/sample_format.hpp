@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace tuner {
+
+// Capture sample formats we know how to negotiate and convert to float.
+// Listed in order of preference (highest resolution first after float).
+enum class SampleFormat {
+    Float32LE,
+    S32LE,
+    S24LE,    // 24-bit in the low three bytes of a 32-bit container
+    S24_3LE,  // packed 24-bit (3 bytes per sample)
+    S16LE
+};
+
+// Bytes occupied by one sample (one channel) in the given format
+int bytes_per_sample(SampleFormat fmt);
+
+// Short human readable name, e.g. "S24_3LE"
+const char* sample_format_name(SampleFormat fmt);
+
+// Name of the vector kernel set compiled in ("AVX2", "SSSE3", "SSE2", "NEON" or
+// "scalar"); every integer format has a kernel in each of them
+const char* sample_format_simd_backend();
+
+// Convert `count` samples (all channels, interleaved) from raw device bytes to
+// float in [-1, 1). Uses the widest vector kernel available at compile time.
+void convert_to_float(SampleFormat fmt, const void* src, float* dst, std::size_t count);
+
+// Plain scalar reference conversion (used for tails and for verification)
+void convert_to_float_scalar(SampleFormat fmt, const void* src, float* dst, std::size_t count);
+
+} // namespace tuner
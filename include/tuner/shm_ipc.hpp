@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "analysis_frame.hpp"
+#include "spsc_ring.hpp"
+#include "analysis/long_analysis_engine.hpp"
+
+namespace tuner {
+
+// Control messages from a GUI to a separate DSP engine process
+enum class EngineCommandType : uint32_t {
+    None = 0,
+    SetNote,           // center_hz: zoom centre
+    SetZoom,           // fft_size, decimation, seconds = analysed history cap, hop_seconds, span_cents, a4_hz
+    StartLongCapture,  // seconds, center_hz, fft_size, decimation, segments, harmonics
+    Stop,              // ask the engine to exit
+    SetDemand          // nodes: analysis nodes the GUI's visible views need
+};
+
+struct EngineCommand {
+    EngineCommandType type = EngineCommandType::None;
+    float center_hz = 0.0f;
+    float seconds = 0.0f;
+    int32_t fft_size = 0;
+    int32_t decimation = 0;
+    int32_t segments = 0;
+    int32_t harmonics = 0;
+    uint32_t nodes = 0;
+    float hop_seconds = 0.0f;
+    int32_t sliding_dft = -1;  // SetZoom: 1 / 0 switches the centre spectrum source, -1 keeps it
+    float span_cents = 0.0f;   // SetZoom, StartLongCapture: zoom span (±cents); 0 keeps it
+    float a4_hz = 0.0f;        // SetZoom: reference pitch for key detection; 0 keeps it
+    int32_t idle_gate = -1;    // SetZoom: 1 / 0 switches idling on silence, -1 keeps it
+    float idle_threshold_db = 0.0f;  // SetZoom: level that wakes it (dBFS); 0 keeps it
+    int32_t strike_gate = -1;  // SetZoom: 1 / 0 switches measuring the sustain only, -1 keeps it
+    int32_t coarse_gate = -1;  // SetZoom: 1 / 0 switches skipping the zoom without a pitch, -1 keeps it
+};
+
+// Fixed-capacity SPSC queue stored inline (no pointers), so it can live in a
+// shared mapping used by two processes
+template <typename T, size_t N>
+class InlineSpscQueue {
+    static_assert((N & (N - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "InlineSpscQueue<T> crosses process boundaries");
+
+public:
+    bool push(const T& item) {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) return false;
+        slots[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        const uint64_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        item = slots[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail{0};
+    T slots[N];
+};
+
+struct ShmFrameSegment;
+struct ShmCommandSegment;
+
+// DSP engine side of the shared-memory link. Creates two POSIX shm objects:
+// "<name>.frames" (analysis frames and long-analysis results; clients map it
+// read-only) and "<name>.cmd" (command queue written by the client). Frames
+// are written in place into a seqlock slot, so the spectrum is never copied
+// on the engine side. One controlling client at a time.
+class ShmEngineChannel {
+public:
+    ShmEngineChannel() = default;
+    ~ShmEngineChannel();
+    ShmEngineChannel(const ShmEngineChannel&) = delete;
+    ShmEngineChannel& operator=(const ShmEngineChannel&) = delete;
+
+    // `name` without leading '/'; replaces stale objects of the same name
+    bool create(const std::string& name);
+    void close();
+    bool is_open() const { return frames != nullptr; }
+
+    // Audio thread: fill the returned frame, then end_frame()
+    AnalysisFrame& begin_frame();
+    void end_frame();
+
+    void publish_long(const gui::LongAnalysisSnapshot& snapshot);
+    bool poll_command(EngineCommand& cmd);
+    // Mark the engine alive without publishing (e.g. while the input is idle)
+    void heartbeat();
+
+private:
+    std::string base_name;
+    ShmFrameSegment* frames = nullptr;
+    ShmCommandSegment* commands = nullptr;
+};
+
+// Client (GUI) side: frames mapped read-only, commands read-write
+class ShmClientChannel {
+public:
+    ShmClientChannel() = default;
+    ~ShmClientChannel();
+    ShmClientChannel(const ShmClientChannel&) = delete;
+    ShmClientChannel& operator=(const ShmClientChannel&) = delete;
+
+    // Fails if the engine has not created the segments (yet) or the layout differs
+    bool attach(const std::string& name);
+    void detach();
+    bool is_attached() const { return frames != nullptr; }
+
+    // Publish count of the newest frame; cheap, use it to skip unchanged frames
+    uint64_t frame_version() const;
+    bool read_frame(AnalysisFrame& out, uint64_t* version = nullptr) const;
+
+    uint64_t long_version() const;
+    bool read_long(gui::LongAnalysisSnapshot& out, uint64_t* version = nullptr) const;
+
+    bool send(const EngineCommand& cmd);
+
+    // True if the engine published or sent a heartbeat within `max_age_ms`
+    bool engine_alive(int max_age_ms = 500) const;
+
+private:
+    const ShmFrameSegment* frames = nullptr;
+    ShmCommandSegment* commands = nullptr;
+};
+
+} // namespace tuner
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tuner {
+
+class ZoomFFT;
+
+// Modulated sliding DFT (mSDFT) bank over a ZoomFFT's streamed baseband:
+// Hann-windowed DTFT bins on the ±span_cents grid of ZoomFFT::sample_bins,
+// updated for every decimated sample at O(bins) instead of one FFT per frame.
+//
+// Each bin accumulates its input multiplied by a rotating twiddle, so the
+// window slides by adding the newest sample and removing the oldest, with no
+// pole on the unit circle. The Hann window comes from the two neighbours
+// 1/N either side, whose twiddles differ from the bin's by a rotator shared
+// by all bins. Accumulators and twiddles are double, and a few bins per
+// update are recomputed exactly from the baseband, so every bin is resynced
+// once per resync_windows windows and rounding cannot build up however long
+// it runs; staggering keeps the cost per update flat.
+//
+// The window is the periodic Hann over N - 1 samples, i.e. transform()'s
+// symmetric Hann over the newest N with its zero-weight newest sample left
+// out, so the magnitudes equal transform()'s spectrum evaluated exactly at
+// the grid frequencies rather than interpolated between FFT bins.
+//
+// AnalysisPipeline uses it for the centre lane with sliding_dft, in place
+// of the centre zoom FFT; peaks on its dense grid are refined with a
+// log-parabola.
+class SlidingDftBank {
+public:
+    // `window`: N, in decimated samples (at most the stream's fft_size)
+    void configure(int num_bins, int window, int resync_windows = 8);
+    // Start over at the next update; call it whenever the stream restarts
+    void reset() { valid = false; }
+
+    // Consume what `stream` pushed since the last call. Starts over from its
+    // baseband if it moved to another centre or ran further ahead than its
+    // ring holds.
+    void update(const ZoomFFT& stream);
+
+    // Magnitudes over the newest window for bins 0..count-1; zero before the
+    // stream holds a whole window and outside the decimated band
+    void magnitudes(float* out, int count) const;
+
+    int num_bins() const { return bins; }
+    int window() const { return length + 1; }
+    uint64_t resync_count() const { return resyncs; }
+
+private:
+    int bins = 0;
+    int length = 0;               // M = N - 1 samples in the sliding sum
+    size_t resync_interval = 0;
+    float grid_center = 0.0f;     // grid built for this centre, rate and span
+    double grid_rate = 0.0;
+    float grid_span = 0.0f;
+
+    bool valid = false;
+    size_t position = 0;          // stream samples consumed (the newest, zero-weight one is not)
+    size_t origin = 0;            // time origin of the twiddles; moves in whole windows
+    double resync_due = 0.0;      // bins owed an exact recompute
+    int resync_cursor = 0;
+    uint64_t resyncs = 0;         // full sweeps over the bins
+
+    // Per bin (structure of arrays, so the update loop vectorises)
+    std::vector<unsigned char> in_band;
+    std::vector<double> omega;    // rad / decimated sample
+    std::vector<double> tw_re, tw_im;      // e^{-j omega (i - origin)} for the next sample i
+    std::vector<double> step_re, step_im;  // e^{-j omega}
+    std::vector<double> back_re, back_im;  // e^{+j omega M}: the leaving sample's twiddle over the entering one's
+    std::vector<double> y0_re, y0_im;      // sum x e^{-j omega (i - origin)}
+    std::vector<double> yp_re, yp_im;      // ... times e^{+j 2 pi (i - origin) / M}
+    std::vector<double> ym_re, ym_im;      // ... times e^{-j 2 pi (i - origin) / M}
+    std::vector<double> psi_re, psi_im;    // e^{+j 2 pi l / M}, l = 0..M-1
+    std::vector<double> block;             // scratch: the samples and rotators of an update (sized in configure())
+
+    void build_grid(float center_hz, double fs_dec, float span_cents);
+    // Recompute bin `b` exactly over the window ending at `position`
+    void resync_bin(const ZoomFFT& stream, int b);
+    // Move the twiddle origin forward by whole windows so (i - origin) stays small
+    void rebase();
+};
+
+} // namespace tuner
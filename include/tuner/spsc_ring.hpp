@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace tuner {
+
+// Padding unit for shared atomics (x86-64 and Cortex-A72 both use 64-byte lines)
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Contiguous run of ring slots
+template <typename T>
+struct RingSpan {
+    T* data = nullptr;
+    size_t size = 0;
+};
+
+// Up to two contiguous runs (the second one starts at the beginning of storage)
+template <typename T>
+struct RingSegments {
+    RingSpan<T> first;
+    RingSpan<T> second;
+    size_t size() const { return first.size + second.size; }
+};
+
+// Wait-free single-producer / single-consumer ring.
+//
+// Capacity is a power of two and indices run freely (masked on access), so
+// every slot is usable. Each side keeps a cached copy of the other side's
+// index and only reloads the shared atomic when the cache says the ring is
+// full / empty. Producer and consumer state live on separate cache lines.
+//
+// Bulk transfers: write()/read() copy up to `count` items; write_segments()/
+// commit_write() and peek()/consume() expose the slots in place as at most
+// two contiguous segments for zero-copy use.
+template <typename T>
+class SpscRing {
+    static_assert(std::is_default_constructible<T>::value, "SpscRing<T> needs default-constructible T");
+
+public:
+    explicit SpscRing(size_t min_capacity) {
+        size_t cap = 1;
+        while (cap < min_capacity) cap <<= 1;
+        capacity_mask = cap - 1;
+        slots.reset(new T[cap]);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return capacity_mask + 1; }
+
+    // ---- producer side ----
+
+    size_t write_available() {
+        const size_t head = prod.head.load(std::memory_order_relaxed);
+        return capacity() - (head - load_tail_if_needed(head, capacity()));
+    }
+
+    // Zero-copy: slots for up to `max_count` items. Fill them, then commit_write().
+    RingSegments<T> write_segments(size_t max_count) {
+        const size_t head = prod.head.load(std::memory_order_relaxed);
+        const size_t tail = load_tail_if_needed(head, max_count);
+        const size_t n = std::min(max_count, capacity() - (head - tail));
+        return segments_at(head, n);
+    }
+
+    void commit_write(size_t count) {
+        prod.head.store(prod.head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Copy up to `count` items in; returns how many fit
+    size_t write(const T* data, size_t count) {
+        RingSegments<T> seg = write_segments(count);
+        copy_items(seg.first.data, data, seg.first.size);
+        copy_items(seg.second.data, data + seg.first.size, seg.second.size);
+        commit_write(seg.size());
+        return seg.size();
+    }
+
+    bool push(const T& item) { return write(&item, 1) == 1; }
+
+    // ---- consumer side ----
+
+    size_t read_available() {
+        const size_t tail = cons.tail.load(std::memory_order_relaxed);
+        return load_head_if_needed(tail, capacity()) - tail;
+    }
+
+    // Zero-copy: readable slots, oldest first. Release them with consume().
+    RingSegments<const T> peek(size_t max_count) {
+        const size_t tail = cons.tail.load(std::memory_order_relaxed);
+        const size_t head = load_head_if_needed(tail, max_count);
+        const size_t n = std::min(max_count, head - tail);
+        RingSegments<T> seg = segments_at(tail, n);
+        return {{seg.first.data, seg.first.size}, {seg.second.data, seg.second.size}};
+    }
+
+    void consume(size_t count) {
+        cons.tail.store(cons.tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Copy out up to `count` items; returns how many were available
+    size_t read(T* out, size_t count) {
+        RingSegments<const T> seg = peek(count);
+        copy_items(out, seg.first.data, seg.first.size);
+        copy_items(out + seg.first.size, seg.second.data, seg.second.size);
+        consume(seg.size());
+        return seg.size();
+    }
+
+    bool pop(T& item) { return read(&item, 1) == 1; }
+
+    // Drop everything currently readable (consumer side)
+    void discard() { consume(read_available()); }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) ProducerState {
+        std::atomic<size_t> head{0};
+        size_t tail_cache = 0;
+    };
+    struct alignas(CACHE_LINE_SIZE) ConsumerState {
+        std::atomic<size_t> tail{0};
+        size_t head_cache = 0;
+    };
+
+    ProducerState prod;
+    ConsumerState cons;
+    alignas(CACHE_LINE_SIZE) size_t capacity_mask = 0;
+    std::unique_ptr<T[]> slots;
+
+    // Producer: refresh the cached tail only if the cache cannot satisfy `want`
+    size_t load_tail_if_needed(size_t head, size_t want) {
+        if (capacity() - (head - prod.tail_cache) < want) {
+            prod.tail_cache = cons.tail.load(std::memory_order_acquire);
+        }
+        return prod.tail_cache;
+    }
+
+    // Consumer: refresh the cached head only if the cache cannot satisfy `want`
+    size_t load_head_if_needed(size_t tail, size_t want) {
+        if (cons.head_cache - tail < want) {
+            cons.head_cache = prod.head.load(std::memory_order_acquire);
+        }
+        return cons.head_cache;
+    }
+
+    RingSegments<T> segments_at(size_t index, size_t n) const {
+        const size_t start = index & capacity_mask;
+        const size_t first = std::min(n, capacity() - start);
+        RingSegments<T> seg;
+        seg.first = {slots.get() + start, first};
+        seg.second = {slots.get(), n - first};
+        return seg;
+    }
+
+    static void copy_items(T* dst, const T* src, size_t n) {
+        if (n == 0) return;
+        if (std::is_trivially_copyable<T>::value) std::memcpy(static_cast<void*>(dst), src, n * sizeof(T));
+        else std::copy(src, src + n, dst);
+    }
+};
+
+// Latest-value mailbox: one writer publishes, any number of readers take a
+// consistent copy of the most recent value. Each slot is guarded by a
+// sequence counter (seqlock); the writer rotates through `Slots` so a reader
+// only retries if the writer laps it while it copies. The writer never waits.
+//
+// Holds no pointers, so it can be placed in shared memory and read through a
+// read-only mapping.
+template <typename T, size_t Slots = 4>
+class LatestSnapshot {
+    static_assert(std::is_trivially_copyable<T>::value, "LatestSnapshot<T> copies T bytewise");
+    static_assert(Slots >= 2, "need at least two slots");
+
+public:
+    void publish(const T& value) {
+        std::memcpy(static_cast<void*>(&begin_write()), &value, sizeof(T));
+        end_write();
+    }
+
+    // In-place publish: fill the returned slot, then end_write(). The slot
+    // holds an older value, so overwrite every field that matters.
+    T& begin_write() {
+        Slot& s = slots[(published.load(std::memory_order_relaxed) + 1) % Slots];
+        s.seq.store(s.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);  // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        return s.value;
+    }
+
+    void end_write() {
+        const uint64_t n = published.load(std::memory_order_relaxed) + 1;
+        Slot& s = slots[n % Slots];
+        s.seq.store(s.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        published.store(n, std::memory_order_release);
+    }
+
+    // Copy the latest value; false if nothing has been published yet.
+    // `version` (optional) receives the publish count of the copied value.
+    bool read(T& out, uint64_t* version = nullptr) const {
+        while (true) {
+            const uint64_t n = published.load(std::memory_order_acquire);
+            if (n == 0) return false;
+            const Slot& s = slots[n % Slots];
+            const uint64_t seq0 = s.seq.load(std::memory_order_acquire);
+            if (seq0 & 1u) continue;
+            std::memcpy(static_cast<void*>(&out), &s.value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) == seq0) {
+                if (version) *version = n;
+                return true;
+            }
+        }
+    }
+
+    uint64_t version() const { return published.load(std::memory_order_acquire); }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> seq{0};
+        T value{};
+    };
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> published{0};
+    Slot slots[Slots];
+};
+
+} // namespace tuner
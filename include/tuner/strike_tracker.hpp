@@ -0,0 +1,75 @@
+#pragma once
+
+namespace tuner {
+
+struct StrikeTrackerConfig {
+    float threshold_scale = 0.3f;      // a strike reaches this fraction of the envelope maximum ..
+    float onset_ratio = 1.5f;          // .. and this multiple of the recent level ..
+    float min_level = 1e-3f;           // .. and this level (-60 dBFS for an RMS)
+    int decaying_frames = 3;           // updates in a row falling before the sustain
+    float attack_seconds = 0.15f;      // never in the sustain sooner: the hammer attack
+    float max_attack_seconds = 0.5f;   // in the sustain by then even if the level never fell steadily
+    float reset_scale = 0.29f;         // back to waiting below this fraction of the sustain's first level
+    float retrigger_scale = 0.75f;     // a sudden rise above this fraction of it strikes again
+    float envelope_half_life = 1.0f;   // seconds; the envelope maximum decays so softer strikes follow loud ones
+    float background_seconds = 0.1f;   // time constant of the recent level
+};
+
+enum class StrikePhase : int {
+    Waiting,     // nothing struck, or the last strike has died away
+    Attack,      // hammer transient: the spectrum is broad and the partials not yet settled
+    Monitoring,  // sustain: the partials decay steadily and can be measured
+};
+
+// Strike state machine over a level measured once per analysis hop, after
+// the WASM example's StrikeTracker. A strike starts when the level jumps
+// above both the recent level and a fraction of the envelope maximum. The
+// attack lasts until the level has fallen for decaying_frames updates in a
+// row, but at least attack_seconds (the ~150 ms tuning-capture-design.md
+// says to ignore) and at most max_attack_seconds. A level that falls well
+// below the threshold during the attack was no strike. The sustain ends
+// when the level falls to reset_scale of where it started, or in a new
+// attack when the key is struck again. Fixed state, no allocation.
+//
+// AnalysisPipeline's Strike node feeds it the input level of each hop.
+// With strike_gate the zoom lanes are fed only from the start of the
+// sustain, so the hammer attack is in neither their window nor what
+// consumers measure, and the zoom runs once the sustain fills half the
+// window.
+class StrikeTracker {
+public:
+    explicit StrikeTracker(const StrikeTrackerConfig& config = StrikeTrackerConfig{});
+
+    void set_config(const StrikeTrackerConfig& config) { cfg = config; }
+    const StrikeTrackerConfig& config() const { return cfg; }
+    void reset();
+
+    // One level (linear, e.g. the RMS of the hop) covering `samples` new
+    // input samples at `sample_rate`; returns the phase after it
+    StrikePhase update(float level, int samples, unsigned int sample_rate);
+
+    StrikePhase phase() const { return current; }
+    StrikePhase previous_phase() const { return previous; }
+    // Strikes whose attack reached the sustain
+    int strikes() const { return strike_count; }
+    // Seconds since the last strike started (input time)
+    double strike_age() const { return now - strike_start; }
+
+private:
+    StrikeTrackerConfig cfg;
+    StrikePhase current = StrikePhase::Waiting;
+    StrikePhase previous = StrikePhase::Waiting;
+    double now = 0.0;                 // input time of the last update
+    double strike_start = 0.0;
+    int strike_count = 0;
+    float last_level = 0.0f;
+    float envelope = 0.0f;            // decaying maximum
+    float background = 0.0f;          // recent level before this update
+    float strike_threshold = 0.0f;    // threshold the strike crossed
+    float entry_level = 0.0f;         // level as the sustain began
+    int decaying = 0;
+
+    void start_attack(float level);
+};
+
+} // namespace tuner
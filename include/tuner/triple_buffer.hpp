@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "spsc_ring.hpp"
+
+namespace tuner {
+
+// Wait-free single-writer / single-reader latest-value exchange.
+//
+// Three copies of T: the writer owns one, the reader owns one, and the third
+// sits in the middle. publish() swaps the writer's copy into the middle and
+// marks it fresh; acquire() swaps a fresh middle copy into the reader's slot.
+// Neither side ever waits or copies T, so T may be large (an AnalysisFrame with
+// a full spectrum). Frames the reader does not get to in time are replaced by
+// newer ones; the reader always sees the newest published value.
+//
+// All storage is allocated once with the object.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // ---- writer side ----
+
+    // Copy to fill before publish(); holds whatever was there before (stale
+    // data from two publishes ago), so overwrite every field that matters.
+    T& write_buffer() { return slots[back]; }
+
+    void publish() {
+        const uint8_t prev = middle.exchange(static_cast<uint8_t>(back | FRESH), std::memory_order_acq_rel);
+        back = prev & INDEX_MASK;
+    }
+
+    // ---- reader side ----
+
+    // Newest published value (or the last one acquired if nothing new has
+    // arrived). Returns true if the value changed since the previous call.
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        const uint8_t prev = middle.exchange(front, std::memory_order_acq_rel);
+        front = prev & INDEX_MASK;
+        return true;
+    }
+
+    const T& read_buffer() const { return slots[front]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    T slots[3]{};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint8_t> middle{1};
+    alignas(CACHE_LINE_SIZE) uint8_t back = 0;   // writer only
+    alignas(CACHE_LINE_SIZE) uint8_t front = 2;  // reader only
+};
+
+} // namespace tuner
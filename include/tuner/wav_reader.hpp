@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "sample_format.hpp"
+
+namespace tuner {
+
+struct WavData {
+    int sample_rate = 0;
+    int channels = 0;
+    SampleFormat format = SampleFormat::S16LE;  // on-disk sample format
+    std::vector<float> samples;                 // interleaved, converted to float
+    int frames() const { return channels > 0 ? static_cast<int>(samples.size()) / channels : 0; }
+};
+
+// Read a RIFF/WAVE file (PCM 16/24/32-bit or IEEE float 32-bit, including
+// WAVE_FORMAT_EXTENSIBLE). Returns false and fills `error` on failure.
+bool read_wav_file(const std::string& path, WavData& out, std::string* error = nullptr);
+
+} // namespace tuner
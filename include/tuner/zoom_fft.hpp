@@ -4,16 +4,39 @@
 #include <array>
 #include <memory>
 
+#include "peak_estimator.hpp"
+#include "pre_decimator.hpp"
+
 namespace tuner {
 
 struct ZoomFFTConfig {
     int decimation = 16;      // Decimation factor (16 or 32 typical)
     int fft_size = 16384;      // FFT size after decimation
-    int num_bins = 1200;       // Number of output bins (±120 cents)
+    int num_bins = 1200;       // Number of output bins (over ±span_cents)
     int sample_rate = 48000;   // Input sample rate
     bool use_hann = true;      // Use Hann window (vs rectangular)
+    float span_cents = 120.0f; // Output bins cover ±span_cents around the centre
 };
 
+// Largest decimation that keeps ±span_cents around `frequency_hz` inside the
+// decimated band and out of reach of aliases the anti-alias filters let
+// through. `front_factor`: the lane runs behind a PreDecimator by that much;
+// the result still counts from `sample_rate` and is a multiple of it.
+// Narrow spans split the lane's decimation over two filter stages (see
+// zoom_first_stage), so they decimate further.
+int max_zoom_decimation(int sample_rate, float frequency_hz, float span_cents = 120.0f, int front_factor = 1);
+
+// The first filter stage's share of a lane `decimation` at `sample_rate`
+// (the lane's input rate) for ±span_cents around `frequency_hz`; all of it
+// when one stage holds off the aliases, else the largest divisor whose
+// output still carries the span in the second stage's passband
+int zoom_first_stage(int sample_rate, int decimation, float frequency_hz, float span_cents = 120.0f);
+
+// Largest PreDecimator factor, up to `max_factor`, ahead of zoom lanes up to
+// `frequency_hz`: the front end must pass the top of the ±span_cents, and the
+// lanes' filter at the lower rate must still hold the span in its passband
+int max_front_decimation(int sample_rate, float frequency_hz, int max_factor, float span_cents = 120.0f);
+
 class ButterworthFilter {
 public:
     struct BiquadSection {
@@ -29,6 +52,8 @@ public:
     void configure(int sample_rate, int decimation);
     bool process_and_decimate(const std::complex<float>& input, std::complex<float>& output);
     void reset();
+    // Gain at DC (the coefficients are not normalised)
+    float dc_gain() const;
     
 private:
     static constexpr int NUM_SECTIONS = 4;  // 8th order = 4 biquads
@@ -43,8 +68,59 @@ public:
     ~ZoomFFT();
     
     // Process input buffer and return magnitude spectrum around center frequency
-    // Returns vector of magnitudes in linear scale, spanning ±120 cents
+    // Returns vector of magnitudes in linear scale, spanning ±span_cents
     std::vector<float> process(const float* input, int input_length, float center_freq_hz);
+
+    // process() in two steps, for callers that need only some of the bins:
+    // compute() mixes, decimates and transforms; sample_bins() interpolates
+    // `count` output bins starting at `first_bin` from the last compute()
+    void compute(const float* input, int input_length, float center_freq_hz);
+    void sample_bins(int first_bin, int count, float* out) const;
+
+    // Streaming use (an STFT over the decimated baseband): push() keeps the
+    // oscillator, filter and decimator running across calls and appends the
+    // decimated samples to a ring; transform() windows the newest `count` of
+    // them and transforms, after which sample_bins() works as after compute().
+    // A hop of H input samples then costs H mixer/filter steps and one FFT
+    // instead of filtering the whole window again. compute() restarts the stream.
+    void reset_stream(float center_freq_hz);
+    void push(const float* input, int input_length);
+    void transform(int count);
+    int baseband_size() const;  // decimated samples available to transform(), at most fft_size
+    // Decimated samples pushed since reset_stream(), and sample `index` of
+    // them (valid for the newest baseband_size()); for consumers that follow
+    // the stream sample by sample
+    size_t baseband_count() const { return baseband_written; }
+    std::complex<float> baseband_sample(size_t index) const { return baseband[index % baseband.size()]; }
+    float center_frequency() const { return last_center_freq; }  // of the stream (or last compute())
+
+    // Transform the newest `count` samples of `stream`'s baseband instead of
+    // our own; `stream` must share sample rate and decimation. This gives a
+    // second window length (e.g. a short, fast level next to the long one)
+    // without running another mixer and filter.
+    void transform(const ZoomFFT& stream, int count);
+
+    // Frequency of the spectral peak nearest `approx_hz` (e.g. the best
+    // sampled bin), located between FFT bins with `method` from the complex
+    // bins of the last compute() or transform(); approx_hz if there is none
+    float refine_peak(float approx_hz, PeakEstimator method) const;
+
+    // Instantaneous frequency near `approx_hz` from the phase advance of the
+    // streamed baseband (phase vocoder): the Hann-windowed DFT at approx_hz
+    // over `count` windows of `window` decimated samples, `lag` apart and
+    // ending at the newest sample. A tone's phase advances linearly with the
+    // window start, so the slope of the unwrapped phases is its offset from
+    // approx_hz (unambiguous within ±fs_dec / (2 lag)). Needs count >= 3
+    // windows of baseband, else returns 0. `variance_hz2`, if given, gets the
+    // slope's variance from the fit residuals.
+    float phase_frequency(float approx_hz, int window, int lag, int count, float* variance_hz2 = nullptr) const;
+
+    // Locked tracking: bins first_bin .. first_bin + count - 1 (signed bin
+    // indices of an fft_size transform) of the newest `window` baseband
+    // samples, windowed as transform() does, evaluated directly as DTFT
+    // bins. The values equal transform()'s bins at O(count x window) instead
+    // of an FFT, which is cheaper for a handful of bins around a known peak.
+    void dtft_bins(int first_bin, int count, int window, std::complex<float>* out) const;
     
     // Get the frequency for a given bin index
     float get_bin_frequency(int bin_index, float center_freq_hz) const;
@@ -55,6 +131,9 @@ public:
 private:
     ZoomFFTConfig config;
     ButterworthFilter filter;
+    ButterworthFilter filter2;  // second stage at the first one's output rate, for narrow spans
+    bool two_stage = false;
+    float stage_gain = 1.0f;    // undoes the first stage's DC gain ahead of the second
     std::vector<std::complex<float>> fft_buffer;
     std::vector<std::complex<float>> decimated_buffer;
     
@@ -62,15 +141,24 @@ private:
     std::complex<float> oscillator_phase;
     int renorm_counter;
     float last_center_freq;
+    bool has_spectrum = false;  // fft_buffer holds a valid compute() result
+    int window_length = 0;      // samples windowed into fft_buffer
+
+    // Streaming state
+    std::vector<std::complex<float>> baseband;  // ring of the newest fft_size decimated samples
+    size_t baseband_written = 0;
+    std::complex<float> phase_increment{1.0f, 0.0f};
+
+    // Mix, filter and decimate one input sample; true when `out` was produced
+    bool mix_sample(float x, std::complex<float>& out);
+    // Split the decimation between the filter stages for `center_freq_hz`
+    void configure_filters(float center_freq_hz);
     
     // Internal FFT implementation
     void compute_fft(std::vector<std::complex<float>>& data);
     
     // Apply window function
     void apply_window(std::vector<std::complex<float>>& data);
-    
-    // Sample magnitude spectrum at specific cents offsets
-    std::vector<float> sample_magnitudes(const std::vector<std::complex<float>>& spectrum);
 };
 
 // Multi-region processor for handling multiple harmonics
@@ -96,9 +184,12 @@ private:
     std::vector<std::unique_ptr<ZoomFFT>> regions;
     std::vector<float> harmonic_frequencies;
     ZoomFFTConfig base_config;
+    PreDecimator front;                 // run once per block; the regions mix from its output
+    std::vector<float> front_out;
     
-    // Adaptive decimation based on frequency
-    int select_decimation(float frequency_hz) const;
+    // Adaptive decimation based on frequency (from the input rate), behind
+    // a front end decimating by `front_factor`
+    int select_decimation(float frequency_hz, int front_factor) const;
 };
 
 } // namespace tuner
\ No newline at end of file
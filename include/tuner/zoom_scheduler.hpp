@@ -0,0 +1,44 @@
+#pragma once
+
+#include "app_settings.hpp"
+
+namespace tuner {
+
+// Targets for picking zoom parameters per analysed frequency
+struct ZoomSchedulerConfig {
+    float resolution_cents = 10.0f;   // window resolution 1/T, in cents at the centre
+    float bin_cents = 4.0f;           // FFT bin spacing; peaks are refined between bins (peak_estimator.hpp)
+    float min_window_seconds = 0.10f;
+    float max_window_seconds = 1.0f;
+    int min_fft_size = 256;
+    int max_fft_size = 32768;
+    float span_cents = 120.0f;        // zoom span is ±span_cents
+    int pre_decimation = 4;           // the pipeline's shared front end (AnalysisPipelineConfig::pre_decimation)
+};
+
+struct ZoomSchedule {
+    int fft_size = 4096;
+    int decimation = 16;
+    float window_seconds = 0.35f;
+    // What the chosen parameters achieve at the centre frequency
+    float resolution_cents = 0.0f;
+    float bin_cents = 0.0f;
+    float mflops = 0.0f;              // estimated cost of one zoom lane per pass
+    bool overridden = false;          // an AppSettings override applied
+};
+
+// Cheapest zoom parameters for `center_hz`:
+//  - decimation: the largest the ±span and the anti-alias filters allow
+//    behind the front end (max_zoom_decimation); narrower spans decimate
+//    further and shrink the FFT
+//  - window: long enough for resolution_cents, within the window limits
+//  - FFT size: the smallest power of two that holds the decimated window and
+//    gives bin_cents spacing, within the FFT limits
+// Bass keys end up with long windows, treble keys with short windows and small FFTs.
+ZoomSchedule schedule_zoom(float center_hz, unsigned int sample_rate, const ZoomSchedulerConfig& config);
+
+// The same with the targets from `settings`, then the first override whose
+// key range contains `key` (1..88; 0 = none)
+ZoomSchedule schedule_zoom(const AppSettings& settings, float center_hz, unsigned int sample_rate, int key);
+
+} // namespace tuner
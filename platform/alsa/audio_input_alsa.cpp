@@ -1,6 +1,7 @@
 #include "audio_input.hpp"
 
 #include <alsa/asoundlib.h>
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <cstring>
@@ -11,12 +12,23 @@
 
 namespace tuner {
 
+static snd_pcm_format_t to_alsa_format(SampleFormat fmt) {
+    switch (fmt) {
+        case SampleFormat::Float32LE: return SND_PCM_FORMAT_FLOAT_LE;
+        case SampleFormat::S32LE: return SND_PCM_FORMAT_S32_LE;
+        case SampleFormat::S24LE: return SND_PCM_FORMAT_S24_LE;
+        case SampleFormat::S24_3LE: return SND_PCM_FORMAT_S24_3LE;
+        case SampleFormat::S16LE: return SND_PCM_FORMAT_S16_LE;
+    }
+    return SND_PCM_FORMAT_FLOAT_LE;
+}
+
 class AlsaAudioInput : public IAudioInput {
 public:
     explicit AlsaAudioInput(const AudioConfig& cfg)
         : config(cfg), pcm_handle(nullptr), running(false),
           min_latency_ms(1000.0f), max_latency_ms(0.0f), total_latency_ms(0.0f),
-          latency_count(0), xrun_count(0), sample_format(SND_PCM_FORMAT_FLOAT_LE) {}
+          latency_count(0), xrun_count(0) {}
 
     ~AlsaAudioInput() override { stop(); }
 
@@ -76,8 +88,6 @@ private:
     mutable std::atomic<int> latency_count;
     mutable std::atomic<int> xrun_count;
 
-    snd_pcm_format_t sample_format;
-
     bool setup_alsa() {
         int err;
         // Build candidate device list for portability
@@ -143,24 +153,46 @@ private:
             return false;
         }
 
-        sample_format = SND_PCM_FORMAT_FLOAT_LE;
-        err = snd_pcm_hw_params_set_format(pcm_handle, hw_params, sample_format);
-        if (err < 0) {
-            sample_format = SND_PCM_FORMAT_S16_LE;
-            err = snd_pcm_hw_params_set_format(pcm_handle, hw_params, sample_format);
-            if (err < 0) {
-                std::cerr << "Cannot set format: " << snd_strerror(err) << std::endl;
-                cleanup_alsa();
-                return false;
+        // Negotiate the capture format: configured preference first, then
+        // highest resolution down to S16
+        const SampleFormat preference[] = {
+            config.sample_format,
+            SampleFormat::Float32LE,
+            SampleFormat::S32LE,
+            SampleFormat::S24LE,
+            SampleFormat::S24_3LE,
+            SampleFormat::S16LE,
+        };
+        bool format_set = false;
+        for (SampleFormat fmt : preference) {
+            if (snd_pcm_hw_params_test_format(pcm_handle, hw_params, to_alsa_format(fmt)) != 0) continue;
+            err = snd_pcm_hw_params_set_format(pcm_handle, hw_params, to_alsa_format(fmt));
+            if (err == 0) {
+                config.sample_format = fmt;
+                format_set = true;
+                break;
             }
         }
+        if (!format_set) {
+            std::cerr << "Cannot set format: no supported capture format" << std::endl;
+            cleanup_alsa();
+            return false;
+        }
 
-        err = snd_pcm_hw_params_set_channels(pcm_handle, hw_params, 1);
+        unsigned int channels = std::max(1u, config.channels);
+        err = snd_pcm_hw_params_set_channels_near(pcm_handle, hw_params, &channels);
         if (err < 0) {
             std::cerr << "Cannot set channels: " << snd_strerror(err) << std::endl;
             cleanup_alsa();
             return false;
         }
+        if (channels != config.channels) {
+            std::cout << "Channel count adjusted to " << channels << std::endl;
+        }
+        config.channels = channels;
+        if (config.channel_select >= static_cast<int>(channels)) {
+            config.channel_select = static_cast<int>(channels) - 1;
+        }
 
         unsigned int rate = config.sample_rate;
         err = snd_pcm_hw_params_set_rate_near(pcm_handle, hw_params, &rate, 0);
@@ -212,11 +244,15 @@ private:
 
         snd_pcm_hw_params_get_period_size(hw_params, &period_size, 0);
         snd_pcm_hw_params_get_rate(hw_params, &rate, 0);
+        snd_pcm_hw_params_get_periods(hw_params, &periods, 0);
 
         config.sample_rate = rate;
         config.period_size = static_cast<unsigned int>(period_size);
+        config.num_periods = periods;
 
         std::cout << "ALSA configured: " << rate << " Hz, "
+                  << sample_format_name(config.sample_format) << ", "
+                  << config.channels << " ch (" << channel_mode_name(config.channel_mode) << "), "
                   << period_size << " frames/period ("
                   << (1000.0f * period_size / rate) << " ms)" << std::endl;
         return true;
@@ -240,22 +276,34 @@ private:
         snd_pcm_hw_params_current(pcm_handle, hw_params);
         snd_pcm_hw_params_get_period_size(hw_params, &period_size, nullptr);
 
-        std::vector<float> buffer_f;
-        std::vector<int16_t> buffer_s16;
-        if (sample_format == SND_PCM_FORMAT_FLOAT_LE) {
-            buffer_f.resize(period_size);
-        } else {
-            buffer_s16.resize(period_size);
+        // Raw device bytes are converted to float in one vectorized pass, then
+        // multi-channel frames are deinterleaved and reduced to mono
+        const int channels = static_cast<int>(std::max(1u, config.channels));
+        const bool is_float = (config.sample_format == SampleFormat::Float32LE);
+        const bool direct = is_float && channels == 1;
+        std::vector<float> buffer_f(period_size);
+        std::vector<float> buffer_interleaved;
+        std::vector<uint8_t> buffer_raw;
+        if (!direct) {
+            buffer_interleaved.resize(period_size * channels);
+        }
+        if (!is_float) {
+            buffer_raw.resize(period_size * channels * bytes_per_sample(config.sample_format));
         }
+        ChannelCombiner combiner;
+        combiner.configure(channels, config.channel_mode, config.channel_select,
+                           static_cast<int>(config.sample_rate), static_cast<int>(period_size));
 
         while (running.load()) {
             auto start_time = std::chrono::high_resolution_clock::now();
 
             int frames_read = 0;
-            if (sample_format == SND_PCM_FORMAT_FLOAT_LE) {
+            if (direct) {
                 frames_read = snd_pcm_readi(pcm_handle, buffer_f.data(), period_size);
+            } else if (is_float) {
+                frames_read = snd_pcm_readi(pcm_handle, buffer_interleaved.data(), period_size);
             } else {
-                frames_read = snd_pcm_readi(pcm_handle, buffer_s16.data(), period_size);
+                frames_read = snd_pcm_readi(pcm_handle, buffer_raw.data(), period_size);
             }
 
             if (frames_read < 0) {
@@ -270,14 +318,15 @@ private:
                 }
             } else if (frames_read > 0) {
                 if (process_callback) {
-                    if (sample_format == SND_PCM_FORMAT_FLOAT_LE) {
-                        process_callback(buffer_f.data(), frames_read);
-                    } else {
-                        if (buffer_f.size() < static_cast<size_t>(frames_read)) buffer_f.resize(frames_read);
-                        const float scale = 1.0f / 32768.0f;
-                        for (int i = 0; i < frames_read; ++i) buffer_f[i] = static_cast<float>(buffer_s16[i]) * scale;
-                        process_callback(buffer_f.data(), frames_read);
+                    if (!is_float) {
+                        float* dst = channels == 1 ? buffer_f.data() : buffer_interleaved.data();
+                        convert_to_float(config.sample_format, buffer_raw.data(), dst,
+                                         static_cast<size_t>(frames_read) * channels);
+                    }
+                    if (channels > 1) {
+                        combiner.process(buffer_interleaved.data(), frames_read, buffer_f.data());
                     }
+                    process_callback(buffer_f.data(), frames_read);
                 }
 
                 auto end_time = std::chrono::high_resolution_clock::now();
@@ -309,7 +358,7 @@ private:
     }
 };
 
-std::unique_ptr<IAudioInput> createAudioInput(const AudioConfig& config) {
+std::unique_ptr<IAudioInput> createAlsaAudioInput(const AudioConfig& config) {
     return std::make_unique<AlsaAudioInput>(config);
 }
 
@@ -0,0 +1,11 @@
+#include "audio_input.hpp"
+
+namespace tuner {
+
+std::unique_ptr<IAudioInput> createAudioInput(const AudioConfig& config) {
+    if (config.device_name.rfind("file:", 0) == 0) return createFileAudioInput(config);
+    if (config.device_name.rfind("synth:", 0) == 0) return createSynthAudioInput(config);
+    return createAlsaAudioInput(config);
+}
+
+} // namespace tuner
@@ -0,0 +1,147 @@
+#include "audio_input_buffer.hpp"
+#include "channel_mix.hpp"
+#include "wav_reader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace tuner {
+
+BufferAudioInput::BufferAudioInput(const AudioConfig& cfg, std::vector<float> mono, int sample_rate)
+    : config(cfg), samples(std::move(mono)) {
+    if (sample_rate > 0) config.sample_rate = static_cast<unsigned int>(sample_rate);
+    if (config.period_size == 0) config.period_size = 64;
+    // The callback always sees mono, whatever the source had
+    config.channels = 1;
+    config.sample_format = SampleFormat::Float32LE;
+}
+
+BufferAudioInput::~BufferAudioInput() {
+    stop();
+}
+
+bool BufferAudioInput::start() {
+    if (running.load()) return false;
+    if (samples.empty()) {
+        std::cerr << "Audio source " << config.device_name << " has no samples" << std::endl;
+        return false;
+    }
+    position = 0;
+    delivered.store(0);
+    done.store(false);
+    running.store(true);
+    if (config.playback_mode != PlaybackMode::SingleStep) {
+        worker = std::thread(&BufferAudioInput::thread_func, this);
+    }
+    std::cout << "Audio source: " << config.device_name << " @ " << config.sample_rate << " Hz, "
+              << samples.size() << " frames, period " << config.period_size << std::endl;
+    return true;
+}
+
+void BufferAudioInput::stop() {
+    running.store(false);
+    if (worker.joinable()) worker.join();
+}
+
+IAudioInput::LatencyStats BufferAudioInput::get_latency_stats() const {
+    LatencyStats stats{};
+    stats.min_ms = min_latency_ms.load();
+    stats.max_ms = max_latency_ms.load();
+    int count = latency_count.load();
+    stats.avg_ms = count > 0 ? total_latency_ms.load() / count : 0.0f;
+    stats.xruns = xrun_count.load();
+    return stats;
+}
+
+bool BufferAudioInput::step() {
+    if (config.playback_mode != PlaybackMode::SingleStep || !running.load()) return false;
+    return deliver_period();
+}
+
+bool BufferAudioInput::deliver_period() {
+    const size_t period = config.period_size;
+    if (position >= samples.size()) {
+        if (!config.loop_playback) {
+            done.store(true);
+            return false;
+        }
+        position = 0;
+    }
+
+    // Hand out whole periods; the final partial period is passed as-is
+    const size_t n = std::min(period, samples.size() - position);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    if (process_callback) process_callback(samples.data() + position, static_cast<int>(n));
+    auto t1 = std::chrono::high_resolution_clock::now();
+    position += n;
+    delivered.fetch_add(n);
+
+    float latency_ms = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() / 1000.0f;
+    float current_min = min_latency_ms.load();
+    while (latency_ms < current_min && !min_latency_ms.compare_exchange_weak(current_min, latency_ms));
+    float current_max = max_latency_ms.load();
+    while (latency_ms > current_max && !max_latency_ms.compare_exchange_weak(current_max, latency_ms));
+    total_latency_ms.store(total_latency_ms.load() + latency_ms);
+    latency_count.store(latency_count.load() + 1);
+
+    if (position >= samples.size() && !config.loop_playback) done.store(true);
+    return true;
+}
+
+void BufferAudioInput::thread_func() {
+    using clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(config.period_size) / config.sample_rate));
+    auto next = clock::now();
+
+    while (running.load()) {
+        if (!deliver_period()) break;
+        if (config.playback_mode == PlaybackMode::Realtime) {
+            next += period;
+            auto now = clock::now();
+            if (now > next) {
+                // Consumer could not keep up with the device rate: count it like an
+                // overrun and resynchronise instead of bursting to catch up
+                xrun_count++;
+                next = now;
+            } else {
+                std::this_thread::sleep_until(next);
+            }
+        }
+    }
+    running.store(false);
+}
+
+std::unique_ptr<IAudioInput> createFileAudioInput(const AudioConfig& config) {
+    std::string path = config.device_name;
+    if (path.rfind("file:", 0) == 0) path = path.substr(5);
+
+    WavData wav;
+    std::string error;
+    if (!read_wav_file(path, wav, &error)) {
+        std::cerr << "Failed to load " << path << ": " << error << std::endl;
+        // Empty source: start() reports the failure like a device that cannot open
+        return std::make_unique<BufferAudioInput>(config, std::vector<float>{}, 0);
+    }
+
+    std::vector<float> mono(static_cast<size_t>(wav.frames()));
+    if (wav.channels == 1) {
+        mono = std::move(wav.samples);
+    } else {
+        ChannelCombiner combiner;
+        const int block = static_cast<int>(std::max(64u, config.period_size));
+        combiner.configure(wav.channels, config.channel_mode, config.channel_select, wav.sample_rate, block);
+        for (int off = 0; off < wav.frames(); off += block) {
+            const int n = std::min(block, wav.frames() - off);
+            combiner.process(wav.samples.data() + static_cast<size_t>(off) * wav.channels, n, mono.data() + off);
+        }
+    }
+
+    std::cout << "Loaded " << path << ": " << wav.channels << " ch, " << sample_format_name(wav.format)
+              << ", " << wav.sample_rate << " Hz" << std::endl;
+    return std::make_unique<BufferAudioInput>(config, std::move(mono), wav.sample_rate);
+}
+
+} // namespace tuner
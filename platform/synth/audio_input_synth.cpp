@@ -0,0 +1,27 @@
+#include "audio_input_buffer.hpp"
+#include "piano_synth.hpp"
+
+#include <iostream>
+
+namespace tuner {
+
+std::unique_ptr<IAudioInput> createSynthAudioInput(const AudioConfig& config) {
+    PianoSynthConfig synth;
+    synth.sample_rate = static_cast<int>(config.sample_rate);
+    std::string error;
+    if (!parse_piano_synth_spec(config.device_name, synth, &error)) {
+        std::cerr << "Bad synth spec '" << config.device_name << "': " << error << std::endl;
+        // Empty source: start() reports the failure like a device that cannot open
+        return std::make_unique<BufferAudioInput>(config, std::vector<float>{}, 0);
+    }
+
+    PianoGroundTruth truth;
+    std::vector<float> samples = synthesize_piano(synth, &truth);
+    for (const auto& note : truth.notes) {
+        std::cout << "Synth note: f1=" << note.f1 << " Hz B=" << note.B << " partials=" << note.partial_hz.size()
+                  << " onset=" << note.onset_s << " s" << std::endl;
+    }
+    return std::make_unique<BufferAudioInput>(config, std::move(samples), synth.sample_rate);
+}
+
+} // namespace tuner
@@ -0,0 +1,156 @@
+#include "analysis_pipeline.hpp"
+#include "piano_synth.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace tuner;
+
+// Silence idle (idle_gate) against the pipeline always running.
+// Usage: idle_mode_bench
+// 64-frame callbacks at 48 kHz, the GUI's NotesState lanes subscribed:
+// 1.5 s of a -80 dBFS noise floor, A4 struck and left to decay, then the
+// floor alone until 8 s. Then the floor raised to -64.5 dBFS, between the
+// idle and wake levels, for 2 s. Reports the idle/wake transitions, how long
+// after the strike a frame with the centre lane came, the pipeline's cost
+// per second of audio in the silence after the decay (idle and not), and
+// the CPU time the frames say idling saved against the time measured.
+// Fails unless it idles before the strike, wakes once at it, idles again
+// after the decay and stays idle in the raised floor; on a centre lane
+// later than one hop after the strike; on silence costing over a fifth
+// of the ungated run; or on the reported saving more than 15% off the
+// measured one.
+
+namespace {
+
+constexpr int FS = 48000;
+constexpr int BLOCK = 64;
+constexpr float ONSET = 1.5f;
+constexpr float SILENT_FROM = 6.0f;  // the note has decayed and the hold passed
+constexpr float FLOOR_END = 8.0f;
+constexpr float TOTAL = 10.0f;
+constexpr int RUNS = 5;
+constexpr double SAVED_TOLERANCE = 0.15;  // reported against measured saving
+
+std::vector<float> scene() {
+    PianoSynthConfig synth;
+    synth.sample_rate = FS;
+    synth.duration_s = TOTAL;
+    synth.snr_db = 300.0f;  // no noise; the floor is added below
+    PianoNoteSpec n;
+    n.f1 = 440.0f;
+    n.B = typical_inharmonicity(69);
+    n.onset_s = ONSET;
+    n.decay_s = 0.4f;
+    synth.notes.push_back(n);
+    std::vector<float> x = synthesize_piano(synth);
+    std::mt19937 rng(5);
+    std::normal_distribution<float> floor_noise(0.0f, 1e-4f);          // -80 dBFS
+    std::normal_distribution<float> raised_noise(0.0f, 5.96e-4f);      // -64.5 dBFS
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] += static_cast<float>(i) < FLOOR_END * FS ? floor_noise(rng) : raised_noise(rng);
+    }
+    return x;
+}
+
+struct Run {
+    std::vector<float> idle_at, wake_at;  // transitions, in seconds
+    float center_after_s = -1.0f;         // strike to the first centre lane
+    double silent_us = 0.0;               // measured pipeline time over SILENT_FROM..FLOOR_END
+    double total_us = 0.0;
+    float reported_idle_s = 0.0f;
+    float reported_saved_s = 0.0f;
+    bool raised_idle = true;              // every frame in the raised floor idle
+    float hop_s = 0.0f;
+};
+
+Run run(const std::vector<float>& x, bool gate) {
+    AnalysisPipelineConfig config;
+    config.idle_gate = gate;
+    AnalysisPipeline pipeline(config);
+    pipeline.set_center_frequency(440.0f);
+    pipeline.graph().subscribe(AnalysisConsumer::NotesState,
+                               node_bit(AnalysisNode::LaneCenter) | node_bit(AnalysisNode::LaneF0));
+    Run r;
+    r.hop_s = config.hop_seconds;
+    AnalysisFrame frame;
+    bool was_idle = false;
+    for (size_t i = 0; i + BLOCK <= x.size(); i += BLOCK) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool due = pipeline.process(&x[i], BLOCK, FS, frame);
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        const float t = static_cast<float>(i + BLOCK) / FS;
+        r.total_us += us;
+        if (t > SILENT_FROM && t <= FLOOR_END) r.silent_us += us;
+        if (!due) continue;
+        if (frame.idle != was_idle) (frame.idle ? r.idle_at : r.wake_at).push_back(t);
+        was_idle = frame.idle;
+        if (t >= ONSET && r.center_after_s < 0.0f && (frame.nodes_run & node_bit(AnalysisNode::LaneCenter))) {
+            r.center_after_s = t - ONSET;
+        }
+        if (t > FLOOR_END && !frame.idle) r.raised_idle = false;
+        r.reported_idle_s = frame.idle_seconds;
+        r.reported_saved_s = frame.idle_saved_seconds;
+    }
+    return r;
+}
+
+std::ostream& operator<<(std::ostream& os, const std::vector<float>& v) {
+    os << '[';
+    for (size_t i = 0; i < v.size(); ++i) os << (i ? " " : "") << v[i];
+    return os << ']';
+}
+
+} // namespace
+
+int main() {
+    const std::vector<float> x = scene();
+    // Warm up caches and allocations, then pairs of runs; the saving is
+    // compared on the median pair, as one run can be slowed by the rest of
+    // the system
+    run(x, true);
+    std::vector<std::pair<Run, Run>> pairs;
+    for (int i = 0; i < RUNS; ++i) {
+        Run o = run(x, false);
+        Run g = run(x, true);
+        pairs.emplace_back(std::move(o), std::move(g));
+    }
+    auto error = [](const std::pair<Run, Run>& p) {
+        return 1e3 * p.second.reported_saved_s - 1e-3 * (p.first.total_us - p.second.total_us);
+    };
+    std::sort(pairs.begin(), pairs.end(), [&](const auto& a, const auto& b) { return error(a) < error(b); });
+    const Run& open = pairs[RUNS / 2].first;
+    const Run& idle = pairs[RUNS / 2].second;
+    const double reported_ms = 1e3 * idle.reported_saved_s;
+    const double measured_ms = 1e-3 * (open.total_us - idle.total_us);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "idle at " << idle.idle_at << " s, woke at " << idle.wake_at << " s\n";
+    std::cout << "centre lane " << idle.center_after_s << " s after the strike (hop " << idle.hop_s
+              << " s; ungated " << open.center_after_s << " s)\n";
+    const double silent_s = FLOOR_END - SILENT_FROM;
+    std::cout << std::setprecision(1) << "silence: " << open.silent_us / silent_s << " µs per second of audio ungated, "
+              << idle.silent_us / silent_s << " idle (" << 100.0 * (1.0 - idle.silent_us / open.silent_us) << "% saved)\n";
+    std::cout << std::setprecision(3) << "run: " << idle.reported_idle_s << " s of " << TOTAL << " idle; saved "
+              << reported_ms << " ms reported, " << measured_ms << " ms measured\n";
+
+    bool ok = true;
+    if (idle.idle_at.size() != 2 || idle.wake_at.size() != 1 || !(idle.idle_at[0] < ONSET) ||
+        !(idle.wake_at[0] >= ONSET && idle.wake_at[0] < ONSET + idle.hop_s) || !(idle.idle_at[1] < FLOOR_END)) {
+        ok = false;
+    }
+    if (!idle.raised_idle) ok = false;
+    if (!(idle.center_after_s >= 0.0f && idle.center_after_s <= idle.hop_s)) ok = false;
+    if (idle.silent_us > 0.2 * open.silent_us) ok = false;
+    if (std::fabs(reported_ms - measured_ms) > SAVED_TOLERANCE * measured_ms) ok = false;
+    if (!ok) {
+        std::cout << "FAILED\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "key_channelizer.hpp"
+#include "piano_synth.hpp"
+#include <iostream>
+#include <iomanip>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace tuner;
+
+// Keyboard-wide polyphase channelizer.
+// Usage: key_channelizer_test
+// At 48 kHz, fed in 256-sample blocks:
+//  - a -20 dBFS sine on every key, up to 20 cents out of tune: the loudest
+//    key, its coarse frequency error in cents, and how far the keys either
+//    side are down (per register: worst case)
+//  - every key of the synthetic piano struck from silence at 40 dB SNR: an
+//    onset on the struck key, the latency from the strike (mean / worst),
+//    and stray onsets on any other key, on the keys its partials fall on
+//    and on the rest
+//  - 10 s of white noise at -40 dBFS: onsets anywhere
+// Cost is µs per second of audio. Fails on a wrong loudest key, a pitch more
+// than 5 cents off, a neighbour less than 6 dB down, a missed strike, an
+// onset on one of its partials' keys before the struck key's, more such
+// onsets than one per ten strikes or other stray onsets than one per
+// strike, an onset out of noise, or a cost over 1% of real time.
+
+namespace {
+
+constexpr int FS = 48000;
+constexpr int BLOCK = 256;
+
+float key_hz(int key) { return 440.0f * std::pow(2.0f, (key - 48) / 12.0f); }
+
+// Detune within ±20 cents, different per key
+float detune_cents(int key) { return 20.0f * std::sin(1.7f * static_cast<float>(key)); }
+
+struct Feed {
+    double seconds = 0.0;                   // time in push()
+    std::vector<std::array<KeyBand, KeyChannelizer::NUM_KEYS>> snapshots;  // after each block
+};
+
+Feed feed(KeyChannelizer& bank, const std::vector<float>& x, bool keep) {
+    Feed f;
+    for (size_t i = 0; i + BLOCK <= x.size(); i += BLOCK) {
+        const auto t0 = std::chrono::steady_clock::now();
+        bank.push(&x[i], BLOCK, FS);
+        f.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (keep) f.snapshots.push_back(bank.keys());
+    }
+    return f;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    const char* registers[] = {"A0-G#2", "A2-G#4", "A4-G#6", "A6-C8"};
+    double cost_s = 0.0, audio_s = 0.0;
+    std::cout << std::fixed << std::setprecision(2);
+
+    std::cout << "sine per key\nregister  loudest_ok  max_err_cents  min_neighbour_down_db\n";
+    for (int r = 0; r < 4; ++r) {
+        int right = 0, count = 0;
+        float worst_err = 0.0f, worst_down = 1e9f;
+        for (int key = r * 24; key < std::min(88, (r + 1) * 24); ++key) {
+            const double hz = key_hz(key) * std::pow(2.0, detune_cents(key) / 1200.0);
+            std::vector<float> x(static_cast<size_t>(5.0 * FS));
+            for (size_t i = 0; i < x.size(); ++i) x[i] = 0.1f * static_cast<float>(std::sin(2.0 * M_PI * hz * i / FS));
+            KeyChannelizer bank;
+            const Feed f = feed(bank, x, false);
+            cost_s += f.seconds;
+            audio_s += 5.0;
+            const auto& keys = bank.keys();
+            int loudest = 0;
+            for (int k = 1; k < KeyChannelizer::NUM_KEYS; ++k) if (keys[k].level_db > keys[loudest].level_db) loudest = k;
+            ++count;
+            if (loudest == key) ++right;
+            else std::cout << "  key " << key + 1 << ": loudest " << loudest + 1 << "\n";
+            const float err = keys[key].hz > 0.0f ? std::fabs(1200.0f * std::log2(keys[key].hz / static_cast<float>(hz))) : 1e9f;
+            worst_err = std::max(worst_err, err);
+            for (int n : {key - 1, key + 1}) {
+                if (n < 0 || n >= KeyChannelizer::NUM_KEYS) continue;
+                worst_down = std::min(worst_down, keys[key].level_db - keys[n].level_db);
+            }
+            if (loudest != key || !(err <= 5.0f)) ok = false;
+        }
+        std::cout << std::setw(8) << registers[r] << std::setw(8) << right << "/" << std::left << std::setw(5) << count
+                  << std::right << std::setw(13) << worst_err << std::setw(23) << worst_down << "\n";
+        if (!(worst_down >= 6.0f)) ok = false;
+    }
+
+    std::cout << "piano strike from silence\nregister  detected  latency_mean_s  latency_max_s  partial_stray  other_stray\n";
+    int partial_strays = 0, other_strays = 0, strikes = 0;
+    for (int r = 0; r < 4; ++r) {
+        int detected = 0, count = 0, partial_stray = 0, other_stray = 0;
+        float sum = 0.0f, worst = 0.0f;
+        for (int key = r * 24; key < std::min(88, (r + 1) * 24); ++key) {
+            PianoSynthConfig synth;
+            synth.sample_rate = FS;
+            synth.duration_s = 4.5f;
+            synth.snr_db = 40.0f;
+            synth.seed = static_cast<uint32_t>(key + 1);
+            PianoNoteSpec n;
+            n.f1 = key_hz(key) * std::pow(2.0f, detune_cents(key) / 1200.0f);
+            n.B = typical_inharmonicity(key + 21);
+            n.onset_s = 0.5f;
+            n.decay_s = 3.0f;
+            synth.notes.push_back(n);
+            KeyChannelizer bank;
+            PianoGroundTruth truth;
+            const Feed f = feed(bank, synthesize_piano(synth, &truth), true);
+            cost_s += f.seconds;
+            audio_s += synth.duration_s;
+            ++count;
+            std::array<bool, KeyChannelizer::NUM_KEYS> partial{};
+            for (int k = 0; k < KeyChannelizer::NUM_KEYS; ++k) {
+                for (float p : truth.notes[0].partial_hz) {
+                    partial[k] = partial[k] || (k != key && std::fabs(12.0f * std::log2(p / key_hz(k))) < 0.5f);
+                }
+                if (k != key) (partial[k] ? partial_stray : other_stray) += bank.keys()[k].onsets;
+            }
+            float latency = -1.0f;
+            bool stray_first = false;
+            for (size_t b = 0; b < f.snapshots.size() && latency < 0.0f; ++b) {
+                for (int k = 0; k < KeyChannelizer::NUM_KEYS; ++k) {
+                    if (partial[k] && f.snapshots[b][k].onsets > 0) stray_first = true;
+                }
+                if (f.snapshots[b][key].onsets > 0) latency = static_cast<float>((b + 1) * BLOCK) / FS - n.onset_s;
+            }
+            if (stray_first) {
+                std::cout << "  key " << key + 1 << ": a partial's onset before the struck key's\n";
+                ok = false;
+            }
+            if (latency >= 0.0f) {
+                ++detected;
+                sum += latency;
+                worst = std::max(worst, latency);
+            } else {
+                std::cout << "  key " << key + 1 << ": no onset\n";
+                ok = false;
+            }
+        }
+        std::cout << std::setw(8) << registers[r] << std::setw(7) << detected << "/" << std::left << std::setw(5)
+                  << count << std::right << std::setw(12) << (detected ? sum / detected : 0.0f) << std::setw(15) << worst
+                  << std::setw(15) << partial_stray << std::setw(13) << other_stray << "\n";
+        partial_strays += partial_stray;
+        other_strays += other_stray;
+        strikes += count;
+    }
+    if (10 * partial_strays > strikes || other_strays > strikes) ok = false;
+
+    {
+        std::vector<float> x(static_cast<size_t>(10.0 * FS));
+        std::mt19937 rng(7);
+        std::normal_distribution<float> noise(0.0f, 0.01f);
+        for (float& v : x) v = noise(rng);
+        KeyChannelizer bank;
+        const Feed f = feed(bank, x, false);
+        cost_s += f.seconds;
+        audio_s += 10.0;
+        int onsets = 0;
+        for (const KeyBand& k : bank.keys()) onsets += k.onsets;
+        std::cout << "noise only: " << onsets << " onsets\n";
+        if (onsets != 0) ok = false;
+    }
+
+    const double us_per_s = cost_s / audio_s * 1e6;
+    std::cout << std::setprecision(1) << "cost: " << us_per_s << " µs per second of audio\n";
+    if (!(us_per_s <= 10000.0)) ok = false;
+
+    if (!ok) {
+        std::cout << "FAILED\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}
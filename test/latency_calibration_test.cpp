@@ -0,0 +1,93 @@
+#include "latency_calibrator.hpp"
+#include "app_settings_io.hpp"
+#include "zoom_fft.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace tuner;
+
+// Sweep period size / count on a capture device under a ZoomFFT load similar
+// to the GUI's precise lane, print the trials, and optionally store the best
+// configuration in config/settings.json.
+// Usage: latency_calibration_test [device] [seconds_per_trial] [--save]
+// The device may also be "synth:..." to exercise the sweep without hardware.
+
+int main(int argc, char* argv[]) {
+    std::string device = "hw:1,0";
+    float seconds = 3.0f;
+    bool save = false;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--save") == 0) { save = true; continue; }
+        if (positional == 0) device = argv[i];
+        else if (positional == 1) seconds = static_cast<float>(std::atof(argv[i]));
+        ++positional;
+    }
+
+    AudioConfig audio_config;
+    audio_config.device_name = device;
+    audio_config.sample_rate = 48000;
+
+    // DSP load: one 16384-point zoom every ~100 ms over a 350 ms window, as the GUI does
+    ZoomFFTConfig zc;
+    zc.sample_rate = 48000;
+    zc.decimation = 16;
+    zc.fft_size = 16384;
+    zc.num_bins = 1200;
+    ZoomFFT zoom(zc);
+    std::vector<float> window(16800, 0.0f);
+    size_t filled = 0, since_last = 0;
+
+    auto process = [&](const float* input, int num_samples) {
+        for (int i = 0; i < num_samples; ++i) {
+            window[filled] = input[i];
+            filled = (filled + 1) % window.size();
+        }
+        since_last += static_cast<size_t>(num_samples);
+        if (since_last >= 4800) {
+            since_last = 0;
+            zoom.process(window.data(), static_cast<int>(window.size()), 440.0f);
+        }
+    };
+
+    CalibrationOptions options;
+    options.trial_seconds = seconds;
+    LatencyCalibrator calibrator(audio_config, options);
+
+    std::cout << "Calibrating " << device << " (" << seconds << " s per trial)" << std::endl;
+    std::cout << std::setw(8) << "period" << std::setw(9) << "periods" << std::setw(8) << "xruns"
+              << std::setw(10) << "avg load" << std::setw(11) << "peak load" << std::setw(10) << "ms"
+              << "  result" << std::endl;
+    auto result = calibrator.run(process, [](const CalibrationTrial& t, int, int) {
+        // A trial that failed to open has no negotiated config, only the request
+        std::cout << std::fixed << std::setw(8) << (t.started ? t.negotiated.period_size : t.period_size)
+                  << std::setw(9) << (t.started ? t.negotiated.num_periods : t.num_periods)
+                  << std::setw(8) << t.xruns << std::setw(10) << std::setprecision(3) << t.avg_load
+                  << std::setw(11) << t.peak_load << std::setw(10) << std::setprecision(2) << t.latency_ms << "  "
+                  << (!t.started ? "open failed" : (t.stable ? "stable" : "unstable")) << std::endl;
+    });
+
+    if (!result.found) {
+        std::cout << "No stable configuration found" << std::endl;
+        return 1;
+    }
+    std::cout << "Best: " << result.best.period_size << " x " << result.best.num_periods << " @ "
+              << result.best.sample_rate << " Hz" << std::endl;
+
+    if (save) {
+        const char* path = "config/settings.json";
+        AppSettings settings;
+        load_settings(path, settings);
+        store_audio_profile(settings, device, result.best_trial);
+        if (!save_settings(path, settings)) {
+            std::cerr << "Failed to write " << path << std::endl;
+            return 1;
+        }
+        std::cout << "Saved profile for " << device << " to " << path << std::endl;
+    }
+    return 0;
+}
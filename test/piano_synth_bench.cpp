@@ -0,0 +1,141 @@
+#include "piano_synth.hpp"
+#include "zoom_fft.hpp"
+#include "analysis/long_analysis_engine.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace tuner;
+
+// Accuracy-versus-cost benchmark on synthetic piano notes with known partials.
+// Usage: piano_synth_bench [snr_db] [seed]
+// For each test key: ZoomFFT peak error per partial and FFT size, and the
+// LongAnalysisEngine partial / B estimates, all against the synth ground truth.
+// Fails on a ZoomFFT partial more than 4 cents off, a LongAnalysisEngine
+// partial more than 2 cents off, or a B estimate more than 25% off.
+
+static float cents(double f, double ref) { return static_cast<float>(1200.0 * std::log2(f / ref)); }
+
+constexpr float ZOOM_MAX_CENTS = 4.0f;
+constexpr float LONG_MAX_CENTS = 2.0f;
+constexpr float LONG_MAX_B_ERROR = 0.25f;  // relative
+
+// Peak of a ZoomFFT magnitude vector with parabolic refinement, in Hz
+static double zoom_peak_hz(const std::vector<float>& mags, double center_hz) {
+    const int n = static_cast<int>(mags.size());
+    int k = 0;
+    for (int i = 1; i < n; ++i) if (mags[i] > mags[k]) k = i;
+    double delta = 0.0;
+    if (k > 0 && k + 1 < n) {
+        const double l = mags[k - 1], c = mags[k], r = mags[k + 1];
+        const double denom = l - 2.0 * c + r;
+        if (std::fabs(denom) > 1e-20) delta = 0.5 * (l - r) / denom;
+    }
+    const double c = -120.0 + 240.0 * (k + delta) / (n - 1);
+    return center_hz * std::pow(2.0, c / 1200.0);
+}
+
+int main(int argc, char* argv[]) {
+    PianoSynthConfig base;
+    base.sample_rate = 48000;
+    base.duration_s = 6.0f;
+    if (argc > 1) base.snr_db = static_cast<float>(std::atof(argv[1]));
+    if (argc > 2) base.seed = static_cast<uint32_t>(std::atoi(argv[2]));
+
+    const int keys[] = {21, 33, 45, 57, 69, 81, 93};  // A0..A6
+    const int fft_sizes[] = {1024, 4096, 16384};
+    const int decimation = 16;
+    const int max_partial = 4;
+
+    std::cout << "Synthetic piano benchmark (SNR " << base.snr_db << " dB, seed " << base.seed << ")" << std::endl;
+    std::cout << std::fixed;
+    int failures = 0;
+
+    for (int key : keys) {
+        PianoSynthConfig cfg = base;
+        std::string err;
+        parse_piano_synth_spec("synth:note=" + std::to_string(key), cfg, &err);
+        PianoGroundTruth truth;
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<float> audio = synthesize_piano(cfg, &truth);
+        auto t1 = std::chrono::steady_clock::now();
+        const PianoNoteTruth& gt = truth.notes[0];
+        const double nominal = 440.0 * std::pow(2.0, (key - 69) / 12.0);
+
+        std::cout << "\nkey " << key << ": f1=" << std::setprecision(3) << gt.f1 << " Hz B=" << std::scientific
+                  << std::setprecision(2) << gt.B << std::fixed << " (render " << std::setprecision(1)
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms for "
+                  << cfg.duration_s << " s)" << std::endl;
+
+        // ZoomFFT: centre on the harmonic guess k*nominal, like the live lanes do
+        std::cout << "  ZoomFFT   fft   " ;
+        for (int k = 1; k <= max_partial; ++k) std::cout << "   err p" << k;
+        std::cout << "   us/call" << std::endl;
+        for (int fft_size : fft_sizes) {
+            ZoomFFTConfig zc;
+            zc.sample_rate = cfg.sample_rate;
+            zc.decimation = decimation;
+            zc.fft_size = fft_size;
+            zc.num_bins = 1200;
+            ZoomFFT zoom(zc);
+            const int len = decimation * fft_size;
+            // Skip the hammer attack so the window holds the sustained tone
+            const float* in = audio.data() + cfg.sample_rate / 10;
+
+            std::cout << "          " << std::setw(6) << fft_size << " ";
+            double total_us = 0.0;
+            int calls = 0;
+            for (int k = 1; k <= max_partial; ++k) {
+                if (k > static_cast<int>(gt.partial_hz.size())) { std::cout << std::setw(9) << "-"; continue; }
+                const double center = nominal * k;
+                auto c0 = std::chrono::steady_clock::now();
+                auto mags = zoom.process(in, len, static_cast<float>(center));
+                auto c1 = std::chrono::steady_clock::now();
+                total_us += std::chrono::duration<double, std::micro>(c1 - c0).count();
+                ++calls;
+                const double est = zoom_peak_hz(mags, center);
+                const float err = cents(est, gt.partial_hz[k - 1]);
+                std::cout << std::setw(9) << std::setprecision(3) << err;
+                if (std::fabs(err) > ZOOM_MAX_CENTS) ++failures;
+            }
+            std::cout << std::setw(10) << std::setprecision(0) << (calls ? total_us / calls : 0.0) << std::endl;
+        }
+
+        // LongAnalysisEngine on a 4 s capture
+        gui::LongAnalysisEngine engine;
+        engine.set_center_frequency(static_cast<float>(nominal));
+        engine.set_num_harmonics(8);
+        engine.start_capture(4.0f, cfg.sample_rate);
+        engine.feed_audio(audio.data() + cfg.sample_rate / 10, static_cast<int>(audio.size()) - cfg.sample_rate / 10,
+                          cfg.sample_rate);
+        auto l0 = std::chrono::steady_clock::now();
+        engine.poll_process();
+        while (engine.is_processing()) std::this_thread::sleep_for(std::chrono::microseconds(200));
+        auto l1 = std::chrono::steady_clock::now();
+
+        std::cout << "  Long      err";
+        for (const auto& hr : engine.harmonic_results()) {
+            if (hr.n > max_partial) break;
+            if (hr.n > static_cast<int>(gt.partial_hz.size())) continue;
+            const float err = cents(hr.frequency_hz, gt.partial_hz[hr.n - 1]);
+            std::cout << std::setw(9) << std::setprecision(3) << err;
+            if (std::fabs(err) > LONG_MAX_CENTS) ++failures;
+        }
+        const float B = engine.inharmonicity_B();
+        if (std::fabs(B - gt.B) > LONG_MAX_B_ERROR * gt.B) ++failures;
+        std::cout << "  B=" << std::scientific << std::setprecision(2) << B << std::fixed
+                  << "  " << std::setprecision(1) << std::chrono::duration<double, std::milli>(l1 - l0).count()
+                  << " ms" << std::endl;
+    }
+
+    if (failures > 0) {
+        std::cout << "FAILED: " << failures << " estimates outside tolerance" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "analysis_pipeline.hpp"
+#include <iostream>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+using namespace tuner;
+
+// The audio thread's side of AnalysisPipeline never touches the heap once
+// submit_config() has built what a config needs.
+// Usage: pipeline_alloc_test
+// A4 with eight partials at 48 kHz in 64-frame callbacks, every zoom node,
+// CoarsePitch, Strike, KeyDetect and KeyBands subscribed. After a second
+// of warm-up it counts heap allocations and frees inside process() over
+// three more seconds: steady, after the centre moves far enough that the
+// front end changes factor, and after a new config (a longer FFT) was
+// submitted. All of it once with the zoom FFT on the centre lane and once
+// with the sliding DFT bank (sliding_dft). Fails on any of them, or when
+// the first frame after the centre move has less than the full window:
+// the history must survive the new factor.
+
+namespace {
+
+std::atomic<long> heap_calls{0};
+bool counting = false;
+
+constexpr int FS = 48000;
+constexpr int BLOCK = 64;
+
+}
+
+void* operator new(size_t size) {
+    if (counting) heap_calls.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    if (counting && p) heap_calls.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+// One pass of the three stretches; false (after saying why) on a failure
+bool check(bool sliding_dft) {
+    AnalysisPipelineConfig config;
+    config.sliding_dft = sliding_dft;
+    AnalysisPipeline pipeline(config);
+    pipeline.set_center_frequency(440.0f);
+    pipeline.graph().subscribe(AnalysisConsumer::FrameOutput,
+                               node_bit(AnalysisNode::ZoomCenter) | node_bit(AnalysisNode::ZoomF0) |
+                                   node_bit(AnalysisNode::ZoomFast) | node_bit(AnalysisNode::LaneCenter) |
+                                   node_bit(AnalysisNode::LaneF0) | node_bit(AnalysisNode::Spectrum) |
+                                   node_bit(AnalysisNode::Peak) | node_bit(AnalysisNode::FusedPeak) |
+                                   node_bit(AnalysisNode::CoarsePitch) | node_bit(AnalysisNode::Strike) |
+                                   node_bit(AnalysisNode::KeyDetect) | node_bit(AnalysisNode::KeyBands));
+    bool ok = pipeline.submit_config(config, FS);
+
+    std::vector<float> x(static_cast<size_t>(4 * FS));
+    for (size_t i = 0; i < x.size(); ++i) {
+        const double t = static_cast<double>(i) / FS;
+        double v = 0.0;
+        for (int k = 1; k <= 8; ++k) v += 0.2 / k * std::sin(2.0 * M_PI * 440.0 * k * t);
+        x[i] = static_cast<float>(v);
+    }
+    auto frame = std::make_unique<AnalysisFrame>();
+
+    // Run [from, to) seconds; returns the heap calls process() made and the
+    // window of the first frame
+    auto run = [&](float from, float to, int& first_window) {
+        first_window = -1;
+        const long before = heap_calls.load();
+        for (size_t i = static_cast<size_t>(from * FS); i + BLOCK <= static_cast<size_t>(to * FS); i += BLOCK) {
+            counting = true;
+            const bool produced = pipeline.process(&x[i], BLOCK, FS, *frame);
+            counting = false;
+            if (produced && first_window < 0) first_window = frame->decimated_samples;
+        }
+        return heap_calls.load() - before;
+    };
+
+    int window = 0;
+    run(0.0f, 1.0f, window);
+    const long steady = run(1.0f, 2.0f, window);
+    const int full_window = frame->decimated_samples;
+
+    // 5 kHz is beyond the front end's passband at 4x; it drops to 2x
+    pipeline.set_center_frequency(5000.0f);
+    int moved_window = 0;
+    const long moved = run(2.0f, 3.0f, moved_window);
+
+    config.fft_size = 8192;
+    ok = pipeline.submit_config(config, FS) && ok;
+    int resized_window = 0;
+    const long resized = run(3.0f, 4.0f, resized_window);
+
+    std::cout << (sliding_dft ? "sliding DFT centre" : "zoom FFT centre") << "\n";
+    std::cout << "  heap calls in process(): " << steady << " steady, " << moved << " after the factor change, "
+              << resized << " after a new config\n";
+    std::cout << "  first window after the factor change: " << moved_window << " of " << full_window
+              << " decimated samples\n";
+    if (!ok) {
+        std::cout << "FAILED: submit_config() refused a config\n";
+        return false;
+    }
+    if (steady != 0 || moved != 0 || resized != 0) {
+        std::cout << "FAILED: process() allocated\n";
+        return false;
+    }
+    if (moved_window < full_window) {
+        std::cout << "FAILED: the history was lost with the factor change\n";
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    if (!check(false) || !check(true)) return 1;
+    std::cout << "All checks passed\n";
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include "analysis_pipeline.hpp"
+#include "pitch_locator.hpp"
+#include "piano_synth.hpp"
+#include "pre_decimator.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace tuner;
+
+// Coarse f0 (YIN) ahead of the zoom.
+// Usage: pitch_locator_bench
+// As CoarsePitch runs it: the synthetic piano at 48 kHz through the
+// pipeline's 4x front end, searched from an eighth of the key to four times
+// it. Per register:
+//  - every key, up to 20 cents out of tune, 0.5 s after the strike: the
+//    partial of the f0 found nearest the key, and its worst error in cents;
+//    the direct and FFT lag products must agree
+//  - -40 dBFS white noise over the same ranges: anything found
+//  - cost per hop (µs) of the direct and FFT lag products and of the one
+//    picked, on the bottom key of the register
+// Then the pipeline with coarse_gate: 1 s of noise, then A4 struck. Frames
+// that skipped the zoom during the noise, how long after the strike the
+// zoom was back, and the pipeline's cost per second of audio gated and not.
+// Fails on a key missed or over 35 cents off, methods disagreeing by more
+// than 1 cent, a pitch out of noise, a picked method over 1.5x the cheaper
+// one, or the zoom back later than 0.1 s after the strike.
+
+namespace {
+
+constexpr int FS = 48000;
+constexpr int FRONT = 4;
+constexpr float RATE = static_cast<float>(FS / FRONT);
+
+float key_hz(int key) { return 440.0f * std::pow(2.0f, (key - 48) / 12.0f); }
+float detune_cents(int key) { return 20.0f * std::sin(1.7f * static_cast<float>(key)); }
+
+std::vector<float> front_end(const std::vector<float>& x) {
+    PreDecimator front;
+    front.configure(FS, FRONT);
+    std::vector<float> out(static_cast<size_t>(front.max_output(static_cast<int>(x.size()))));
+    out.resize(static_cast<size_t>(front.process(x.data(), static_cast<int>(x.size()), out.data())));
+    return out;
+}
+
+std::vector<float> strike(int key, float duration, float onset) {
+    PianoSynthConfig synth;
+    synth.sample_rate = FS;
+    synth.duration_s = duration;
+    synth.snr_db = 40.0f;
+    synth.seed = static_cast<uint32_t>(key + 1);
+    PianoNoteSpec n;
+    n.f1 = key_hz(key) * std::pow(2.0f, detune_cents(key) / 1200.0f);
+    n.B = typical_inharmonicity(key + 21);
+    n.onset_s = onset;
+    n.decay_s = 3.0f;
+    synth.notes.push_back(n);
+    return synthesize_piano(synth);
+}
+
+float lo_hz(int key) { return std::max(25.0f, key_hz(key) / 8.0f); }
+float hi_hz(int key) { return std::min(4.0f * key_hz(key), 0.4f * RATE); }
+
+double cost_us(PitchLocator& locator, LagMethod method, const std::vector<float>& x, int key) {
+    locator.set_method(method);
+    const int reps = 200;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; ++i) locator.locate(x.data(), static_cast<int>(x.size()), RATE, lo_hz(key), hi_hz(key));
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / reps;
+}
+
+struct GateRun {
+    int gated = 0;           // noise frames that skipped the zoom
+    int noise_frames = 0;
+    float back_s = -1.0f;    // strike to the first frame with the centre lane
+    double seconds = 0.0;    // push() and analyse()
+};
+
+GateRun gate_run(bool gate) {
+    std::vector<float> x = strike(48, 3.0f, 1.0f);
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    for (size_t i = 0; i < static_cast<size_t>(FS); ++i) x[i] = noise(rng);
+    AnalysisPipelineConfig config;
+    config.coarse_gate = gate;
+    AnalysisPipeline pipeline(config);
+    pipeline.set_center_frequency(key_hz(48));
+    pipeline.graph().subscribe(AnalysisConsumer::OctaveLock,
+                               node_bit(AnalysisNode::LaneCenter) | node_bit(AnalysisNode::LaneF0));
+    GateRun run;
+    AnalysisFrame frame;
+    const int block = 64;
+    for (size_t i = 0; i + block <= x.size(); i += block) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool due = pipeline.process(&x[i], block, FS, frame);
+        run.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (!due) continue;
+        const float t = static_cast<float>(i + block) / FS;
+        if (t < 1.0f) {
+            // The first half second lets the gate close
+            if (t >= 0.5f) {
+                ++run.noise_frames;
+                if (frame.zoom_gated) ++run.gated;
+            }
+        } else if (run.back_s < 0.0f && (frame.nodes_run & node_bit(AnalysisNode::LaneCenter))) {
+            run.back_s = t - 1.0f;
+        }
+    }
+    return run;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    const char* registers[] = {"A0-G#2", "A2-G#4", "A4-G#6", "A6-C8"};
+    PitchLocator locator;
+    std::cout << std::fixed << std::setprecision(2);
+
+    std::cout << "register  found  max_err_cents  max_method_diff_cents  noise_found  direct_us  fft_us  picked_us\n";
+    for (int r = 0; r < 4; ++r) {
+        int found = 0, count = 0, noise_found = 0;
+        float worst = 0.0f, worst_diff = 0.0f;
+        for (int key = r * 24; key < std::min(88, (r + 1) * 24); ++key) {
+            const std::vector<float> y = front_end(strike(key, 1.0f, 0.5f));
+            const float truth = key_hz(key) * std::pow(2.0f, detune_cents(key) / 1200.0f);
+            locator.set_method(LagMethod::Direct);
+            const PitchEstimate direct = locator.locate(y.data(), static_cast<int>(y.size()), RATE, lo_hz(key), hi_hz(key));
+            locator.set_method(LagMethod::Fft);
+            const PitchEstimate fft = locator.locate(y.data(), static_cast<int>(y.size()), RATE, lo_hz(key), hi_hz(key));
+            ++count;
+            // The partial nearest the centre, as CoarsePitch reports it: an
+            // octave below lands back on the key
+            const float partial = direct.f0_hz * std::max(1.0f, std::round(key_hz(key) / std::max(1e-3f, direct.f0_hz)));
+            const float err = direct.f0_hz > 0.0f ? std::fabs(1200.0f * std::log2(partial / truth)) : 1e9f;
+            if (err <= 35.0f) ++found;
+            else {
+                std::cout << "  key " << key + 1 << ": " << partial << " Hz for " << truth << " Hz\n";
+                ok = false;
+            }
+            worst = std::max(worst, err);
+            const float diff = direct.f0_hz > 0.0f && fft.f0_hz > 0.0f
+                                   ? std::fabs(1200.0f * std::log2(direct.f0_hz / fft.f0_hz))
+                                   : (direct.f0_hz == fft.f0_hz ? 0.0f : 1e9f);
+            worst_diff = std::max(worst_diff, diff);
+        }
+        for (int key = r * 24; key < std::min(88, (r + 1) * 24); key += 4) {
+            std::vector<float> x(static_cast<size_t>(FS));
+            std::mt19937 rng(static_cast<uint32_t>(key));
+            std::normal_distribution<float> noise(0.0f, 0.01f);
+            for (float& v : x) v = noise(rng);
+            const std::vector<float> y = front_end(x);
+            locator.set_method(LagMethod::Auto);
+            if (locator.locate(y.data(), static_cast<int>(y.size()), RATE, lo_hz(key), hi_hz(key)).f0_hz > 0.0f) {
+                ++noise_found;
+            }
+        }
+        const std::vector<float> y = front_end(strike(r * 24, 1.0f, 0.5f));
+        const double direct_us = cost_us(locator, LagMethod::Direct, y, r * 24);
+        const double fft_us = cost_us(locator, LagMethod::Fft, y, r * 24);
+        const double picked_us = cost_us(locator, LagMethod::Auto, y, r * 24);
+        std::cout << std::setw(8) << registers[r] << std::setw(5) << found << "/" << std::left << std::setw(5) << count
+                  << std::right << std::setw(12) << worst << std::setw(23) << worst_diff << std::setw(13) << noise_found
+                  << std::setw(11) << direct_us << std::setw(8) << fft_us << std::setw(11) << picked_us << "\n";
+        if (!(worst_diff <= 1.0f) || noise_found > 0 || picked_us > 1.5 * std::min(direct_us, fft_us)) ok = false;
+    }
+
+    const GateRun open = gate_run(false);
+    const GateRun gated = gate_run(true);
+    std::cout << "gate: " << gated.gated << "/" << gated.noise_frames << " noise frames skipped the zoom, back "
+              << gated.back_s << " s after the strike\n";
+    std::cout << std::setprecision(1) << "pipeline cost: " << open.seconds / 3.0 * 1e6 << " µs per second of audio ungated, "
+              << gated.seconds / 3.0 * 1e6 << " gated\n";
+    if (gated.gated != gated.noise_frames || !(gated.back_s >= 0.0f && gated.back_s <= 0.1f)) ok = false;
+
+    if (!ok) {
+        std::cout << "FAILED\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}
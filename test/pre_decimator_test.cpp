@@ -0,0 +1,147 @@
+#include "pre_decimator.hpp"
+#include "zoom_fft.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace tuner;
+
+// Shared front end ahead of the zoom lanes.
+// Usage: pre_decimator_test
+// Response of each factor at 48 kHz: worst passband deviation (dB) up to
+// passband_hz() and worst attenuation (dB) of tones that would fold below
+// it. Then A4 and C8 through a ZoomFFT lane behind the front end against the
+// lane on the raw input at 48, 96 and 192 kHz, and the front-end cost per
+// second of audio. Fails if the passband moves by more than 0.01 dB, the
+// stopband is under 75 dB, or a lane's refined peak moves by 0.001 cents.
+
+namespace {
+
+std::vector<float> tone(double hz, int fs, double seconds) {
+    std::vector<float> x(static_cast<size_t>(seconds * fs));
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<float>(std::sin(2.0 * M_PI * hz * static_cast<double>(i) / fs));
+    }
+    return x;
+}
+
+// Gain (dB) of a unit sine through `front`, from the Hann-weighted power of
+// its output after the filter has settled
+double gain_db(PreDecimator& front, int fs, double hz) {
+    const std::vector<float> x = tone(hz, fs, 0.5);
+    std::vector<float> y(static_cast<size_t>(front.max_output(static_cast<int>(x.size()))));
+    front.reset();
+    const int n = front.process(x.data(), static_cast<int>(x.size()), y.data());
+    const int start = n / 4;
+    double p = 0.0, wsum = 0.0;
+    for (int i = start; i < n; ++i) {
+        const double w = 0.5 - 0.5 * std::cos(2.0 * M_PI * (i - start) / (n - start));
+        p += w * static_cast<double>(y[i]) * y[i];
+        wsum += w;
+    }
+    return 10.0 * std::log10(std::max(1e-30, 2.0 * p / wsum));
+}
+
+float lane_peak_hz(int fs, int factor, int decimation, float center, double hz) {
+    PreDecimator front;
+    front.configure(fs, factor);
+    ZoomFFTConfig cfg;
+    cfg.sample_rate = fs / front.factor();
+    cfg.decimation = decimation / front.factor();
+    cfg.fft_size = 4096;
+    ZoomFFT zoom(cfg);
+    const std::vector<float> x = tone(hz, fs, 1.0);
+    std::vector<float> y(static_cast<size_t>(front.max_output(static_cast<int>(x.size()))));
+    const int n = front.process(x.data(), static_cast<int>(x.size()), y.data());
+    zoom.reset_stream(center);
+    zoom.push(y.data(), n);
+    zoom.transform(static_cast<int>(0.35 * fs / decimation));
+    std::vector<float> mags(static_cast<size_t>(cfg.num_bins));
+    zoom.sample_bins(0, cfg.num_bins, mags.data());
+    int best = 0;
+    for (int b = 1; b < cfg.num_bins; ++b) if (mags[b] > mags[best]) best = b;
+    return zoom.refine_peak(zoom.get_bin_frequency(best, center), PeakEstimator::WindowCorrected);
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    std::cout << std::fixed << std::setprecision(4);
+
+    const int fs = 48000;
+    std::cout << "factor  passband_hz  ripple_db  stopband_db\n";
+    for (int factor : {2, 4, 8, 16}) {
+        PreDecimator front;
+        front.configure(fs, factor);
+        const double fp = PreDecimator::passband_hz(fs, factor);
+        const double fo = front.output_rate();
+        double ripple = 0.0;
+        for (double f = 20.0; f <= fp; f += fp / 37.0) ripple = std::max(ripple, std::fabs(gain_db(front, fs, f)));
+        double stop = -300.0;
+        for (double f = fo - fp; f < 0.5 * fs; f += (0.5 * fs - (fo - fp)) / 53.0) {
+            stop = std::max(stop, gain_db(front, fs, f));
+        }
+        std::cout << std::setw(6) << factor << std::setw(13) << fp << std::setw(11) << ripple << std::setw(13) << -stop << "\n";
+        if (!(ripple <= 0.01) || !(stop <= -75.0)) ok = false;
+    }
+
+    std::cout << "\nrate    note  factor  peak_shift_cents\n";
+    for (int rate : {48000, 96000, 192000}) {
+        for (float center : {440.0f, 4186.0f}) {
+            const int decimation = max_zoom_decimation(rate, center) / 4 * 4;
+            const int factor = max_front_decimation(rate, center, 4 * rate / 48000);
+            const double hz = center * std::pow(2.0, 7.3 / 1200.0);
+            const float direct = lane_peak_hz(rate, 1, decimation, center, hz);
+            const float shared = lane_peak_hz(rate, factor, decimation, center, hz);
+            const float shift = static_cast<float>(std::fabs(1200.0 * std::log2(shared / direct)));
+            std::cout << std::setw(6) << rate << std::setw(7) << (center < 1000.0f ? "A4" : "C8") << std::setw(8)
+                      << factor << std::setw(18) << shift << "\n";
+            if (!(shift <= 0.001f)) ok = false;
+        }
+    }
+
+    std::cout << "\nrate    front_us_per_s  lane_us_per_s (direct -> shared)\n";
+    for (int rate : {48000, 96000, 192000}) {
+        const std::vector<float> x = tone(440.3, rate, 2.0);
+        const int factor = 4 * rate / 48000;
+        PreDecimator front;
+        front.configure(rate, factor);
+        std::vector<float> y(x.size());
+        const int block = 256 * rate / 48000;
+        auto seconds_since = [](std::chrono::steady_clock::time_point t0) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        };
+        auto t0 = std::chrono::steady_clock::now();
+        int n = 0;
+        for (size_t i = 0; i + block <= x.size(); i += static_cast<size_t>(block)) {
+            n += front.process(&x[i], block, &y[static_cast<size_t>(n)]);
+        }
+        const double front_s = seconds_since(t0);
+        double lane_s[2] = {0.0, 0.0};
+        for (int shared = 0; shared < 2; ++shared) {
+            ZoomFFTConfig cfg;
+            cfg.sample_rate = shared ? rate / factor : rate;
+            cfg.decimation = shared ? 4 : 4 * factor;
+            ZoomFFT zoom(cfg);
+            zoom.reset_stream(440.0f);
+            const float* in = shared ? y.data() : x.data();
+            const int len = shared ? n : static_cast<int>(x.size());
+            const int step = shared ? block / factor : block;
+            t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i + step <= len; i += step) zoom.push(in + i, step);
+            lane_s[shared] = seconds_since(t0);
+        }
+        std::cout << std::setw(6) << rate << std::setw(16) << std::setprecision(1) << front_s / 2.0 * 1e6
+                  << std::setw(15) << lane_s[0] / 2.0 * 1e6 << " -> " << lane_s[1] / 2.0 * 1e6 << "\n";
+    }
+
+    if (!ok) {
+        std::cout << "FAILED\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "sample_format.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace tuner;
+
+// Benchmark and verify sample-format conversion kernels.
+// Usage: sample_format_bench [samples_per_block] [iterations]
+
+static std::vector<uint8_t> make_random_bytes(SampleFormat fmt, size_t count, std::mt19937& rng) {
+    std::vector<uint8_t> bytes(count * bytes_per_sample(fmt));
+    std::uniform_int_distribution<int> dist(0, 255);
+    for (auto& b : bytes) b = static_cast<uint8_t>(dist(rng));
+    if (fmt == SampleFormat::Float32LE) {
+        // Keep float payload finite
+        std::uniform_real_distribution<float> fd(-1.0f, 1.0f);
+        float* f = reinterpret_cast<float*>(bytes.data());
+        for (size_t i = 0; i < count; ++i) f[i] = fd(rng);
+    }
+    return bytes;
+}
+
+template <typename Fn>
+static double time_msps(Fn&& fn, size_t count, int iterations) {
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; ++it) fn();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double sec = std::chrono::duration<double>(t1 - t0).count();
+    return sec > 0.0 ? (static_cast<double>(count) * iterations / sec) / 1e6 : 0.0;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = 4096;
+    int iterations = 20000;
+    if (argc > 1) count = static_cast<size_t>(std::max(1, std::atoi(argv[1])));
+    if (argc > 2) iterations = std::max(1, std::atoi(argv[2]));
+
+    std::cout << "Sample format conversion benchmark (" << sample_format_simd_backend()
+              << " kernels, " << count << " samples x " << iterations << ")" << std::endl;
+
+    const SampleFormat formats[] = {
+        SampleFormat::S16LE, SampleFormat::S24_3LE, SampleFormat::S24LE,
+        SampleFormat::S32LE, SampleFormat::Float32LE
+    };
+
+    std::mt19937 rng(1234);
+    bool all_ok = true;
+    std::cout << std::left << std::setw(10) << "format"
+              << std::right << std::setw(14) << "scalar MS/s"
+              << std::setw(14) << "simd MS/s"
+              << std::setw(10) << "speedup"
+              << std::setw(8) << "check" << std::endl;
+
+    for (SampleFormat fmt : formats) {
+        // Odd lengths exercise the scalar tails as well
+        for (size_t n : {count, count + 7}) {
+            auto bytes = make_random_bytes(fmt, n, rng);
+            std::vector<float> ref(n), out(n);
+            convert_to_float_scalar(fmt, bytes.data(), ref.data(), n);
+            convert_to_float(fmt, bytes.data(), out.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                if (ref[i] != out[i]) {
+                    std::cerr << sample_format_name(fmt) << ": mismatch at " << i
+                              << " ref=" << ref[i] << " simd=" << out[i] << std::endl;
+                    all_ok = false;
+                    break;
+                }
+                if (!(out[i] >= -1.0f && out[i] < 1.0f)) {
+                    std::cerr << sample_format_name(fmt) << ": out of range at " << i << std::endl;
+                    all_ok = false;
+                    break;
+                }
+            }
+        }
+
+        auto bytes = make_random_bytes(fmt, count, rng);
+        std::vector<float> out(count);
+        volatile float sink = 0.0f;
+        double scalar = time_msps([&] {
+            convert_to_float_scalar(fmt, bytes.data(), out.data(), count);
+            sink = sink + out[count / 2];
+        }, count, iterations);
+        double simd = time_msps([&] {
+            convert_to_float(fmt, bytes.data(), out.data(), count);
+            sink = sink + out[count / 2];
+        }, count, iterations);
+
+        std::cout << std::left << std::setw(10) << sample_format_name(fmt)
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << scalar
+                  << std::setw(14) << simd
+                  << std::setw(9) << (scalar > 0.0 ? simd / scalar : 0.0) << "x"
+                  << std::setw(8) << (all_ok ? "ok" : "FAIL") << std::endl;
+    }
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+#include "shm_ipc.hpp"
+#include "triple_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace tuner;
+
+// Frame hand-off latency: in-process TripleBuffer (GUI and DSP in one
+// process) versus the shared-memory seqlock between an engine process and a
+// GUI process. The writer stamps each frame, fills the spectrum and publishes
+// once per period; the reader polls, copies the frame out and records
+// publish-to-read latency. Also checks frames for tearing and times a
+// SetNote command round trip through the command queue.
+// Usage: shm_latency_bench [frames] [period_us]
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+static void fill_frame(AnalysisFrame& f, uint64_t seq, float center_hz) {
+    f.seq = seq;
+    f.num_bins = AnalysisFrame::MAX_BINS;
+    f.center_frequency_hz = center_hz;
+    std::fill(f.spectrum.begin(), f.spectrum.end(), static_cast<float>(seq & 0xFFFFFF));
+    f.capture_time_ns = now_ns();  // stamped last: latency covers publish + read only
+}
+
+static bool frame_intact(const AnalysisFrame& f) {
+    const float expect = static_cast<float>(f.seq & 0xFFFFFF);
+    for (int i = 0; i < f.num_bins; ++i) if (f.spectrum[i] != expect) return false;
+    return true;
+}
+
+struct LatencyResult {
+    std::vector<double> us;
+    uint64_t torn = 0;
+};
+
+static void report(const char* name, LatencyResult& r) {
+    if (r.us.empty()) {
+        std::cout << name << ": no frames received" << std::endl;
+        return;
+    }
+    std::sort(r.us.begin(), r.us.end());
+    auto pct = [&](double p) { return r.us[std::min(r.us.size() - 1, static_cast<size_t>(p * r.us.size()))]; };
+    std::cout << std::fixed << std::setprecision(1) << name << ": " << r.us.size() << " frames, p50 " << pct(0.5)
+              << " us, p99 " << pct(0.99) << " us, max " << r.us.back() << " us, torn " << r.torn << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const int frames = argc > 1 ? std::max(10, std::atoi(argv[1])) : 2000;
+    const int period_us = argc > 2 ? std::max(50, std::atoi(argv[2])) : 1000;
+    bool ok = true;
+
+    // --- In-process: TripleBuffer between two threads ---
+    {
+        static TripleBuffer<AnalysisFrame> tb;
+        std::atomic<bool> done{false};
+        LatencyResult res;
+        res.us.reserve(static_cast<size_t>(frames));
+        std::thread reader([&]() {
+            AnalysisFrame copy;
+            while (true) {
+                const bool finished = done.load(std::memory_order_acquire);
+                if (tb.acquire()) {
+                    copy = tb.read_buffer();  // the GUI copies what it draws
+                    res.us.push_back((now_ns() - copy.capture_time_ns) / 1000.0);
+                    if (!frame_intact(copy)) ++res.torn;
+                } else if (finished) {
+                    break;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        auto next = Clock::now();
+        for (int i = 1; i <= frames; ++i) {
+            next += std::chrono::microseconds(period_us);
+            fill_frame(tb.write_buffer(), static_cast<uint64_t>(i), 440.0f);
+            tb.publish();
+            std::this_thread::sleep_until(next);
+        }
+        done.store(true, std::memory_order_release);
+        reader.join();
+        report("In-process TripleBuffer", res);
+        ok &= res.torn == 0 && !res.us.empty();
+    }
+
+    // --- Cross-process: engine child publishes into shm, parent reads ---
+    {
+        const std::string name = "tuner_bench_" + std::to_string(getpid());
+        const pid_t child = fork();
+        if (child == 0) {
+            ShmEngineChannel engine;
+            if (!engine.create(name)) _exit(2);
+            float center = 440.0f;
+            auto next = Clock::now();
+            bool stop = false;
+            // Publish until the parent says stop (bounded in case it died)
+            for (uint64_t seq = 1; !stop && seq <= static_cast<uint64_t>(frames) * 4; ++seq) {
+                EngineCommand cmd;
+                while (engine.poll_command(cmd)) {
+                    if (cmd.type == EngineCommandType::SetNote) center = cmd.center_hz;
+                    if (cmd.type == EngineCommandType::Stop) stop = true;
+                }
+                next += std::chrono::microseconds(period_us);
+                fill_frame(engine.begin_frame(), seq, center);
+                engine.end_frame();
+                std::this_thread::sleep_until(next);
+            }
+            engine.close();  // _exit skips destructors; unlink the segments
+            _exit(0);
+        }
+
+        ShmClientChannel client;
+        auto deadline = Clock::now() + std::chrono::seconds(5);
+        while (!client.attach(name) && Clock::now() < deadline) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (!client.is_attached()) {
+            std::cout << "Shared memory: could not attach to engine" << std::endl;
+            ok = false;
+        } else {
+            LatencyResult res;
+            res.us.reserve(static_cast<size_t>(frames));
+            AnalysisFrame copy;
+            uint64_t seen = client.frame_version();
+            while (res.us.size() < static_cast<size_t>(frames)) {
+                const uint64_t v = client.frame_version();
+                if (v == seen) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                uint64_t got = 0;
+                if (!client.read_frame(copy, &got)) continue;
+                seen = got;
+                res.us.push_back((now_ns() - copy.capture_time_ns) / 1000.0);
+                if (!frame_intact(copy)) ++res.torn;
+            }
+            report("Shared-memory seqlock", res);
+            ok &= res.torn == 0;
+
+            // Command round trip: SetNote until a frame carries the new centre
+            EngineCommand cmd;
+            cmd.type = EngineCommandType::SetNote;
+            cmd.center_hz = 523.25f;
+            const auto t0 = Clock::now();
+            bool echoed = client.send(cmd);
+            while (echoed && Clock::now() - t0 < std::chrono::seconds(2)) {
+                if (client.read_frame(copy) && copy.center_frequency_hz == cmd.center_hz) break;
+                std::this_thread::yield();
+            }
+            echoed = echoed && copy.center_frequency_hz == cmd.center_hz;
+            const double rtt_us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+            std::cout << "SetNote round trip (command queue + next frame): "
+                      << (echoed ? std::to_string(static_cast<int>(rtt_us)) + " us" : std::string("FAILED")) << std::endl;
+            std::cout << "Engine alive: " << (client.engine_alive() ? "yes" : "no") << std::endl;
+            ok &= echoed;
+
+            cmd.type = EngineCommandType::Stop;
+            client.send(cmd);
+        }
+        int status = 0;
+        waitpid(child, &status, 0);
+        ok &= WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    std::cout << (ok ? "All checks passed" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#include "zoom_fft.hpp"
+#include "sliding_dft.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace tuner;
+
+// Sliding DFT bank against the streaming ZoomFFT for the centre spectrum.
+// Usage: sliding_dft_bench
+// A4 plus noise at 48 kHz, decimation 16, a 0.35 s window and 1200 bins.
+// Cost in µs per second of audio for: one zoom FFT + sample_bins per 10 ms
+// hop; the bank updated per hop and per decimated sample; and a zoom FFT per
+// decimated sample (extrapolated from the per-hop transform). Accuracy is the
+// bank's worst magnitude error against a direct Hann DTFT at the grid
+// frequencies after 20 s, relative to the peak. Fails if that exceeds 1e-4 or
+// if the bank per decimated sample is not cheaper than the zoom FFT would be.
+
+namespace {
+
+// Hann DTFT of the newest window of `zoom`'s baseband at each grid bin, as
+// the bank defines it (periodic Hann over N - 1, newest sample left out)
+std::vector<double> direct_dtft(const ZoomFFT& zoom, int bins, int window) {
+    const ZoomFFTConfig& zc = zoom.get_config();
+    const double fs_dec = static_cast<double>(zc.sample_rate) / zc.decimation;
+    const int m = window - 1;
+    const size_t start = zoom.baseband_count() - 1 - static_cast<size_t>(m);
+    std::vector<double> out(static_cast<size_t>(bins), 0.0);
+    for (int b = 0; b < bins; ++b) {
+        const double cents = -120.0 + 240.0 * b / (bins - 1);
+        const double w = 2.0 * M_PI * zoom.center_frequency() * (std::pow(2.0, cents / 1200.0) - 1.0) / fs_dec;
+        std::complex<double> acc = 0.0;
+        for (int l = 0; l < m; ++l) {
+            const double hann = 0.5 - 0.5 * std::cos(2.0 * M_PI * l / m);
+            acc += hann * std::complex<double>(zoom.baseband_sample(start + static_cast<size_t>(l))) *
+                   std::polar(1.0, -w * l);
+        }
+        out[static_cast<size_t>(b)] = std::abs(acc);
+    }
+    return out;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace
+
+int main() {
+    const int fs = 48000;
+    const int hop = fs / 100;
+    const float center = 440.0f;
+    const double seconds = 20.0;
+
+    ZoomFFTConfig cfg;
+    cfg.sample_rate = fs;
+    cfg.decimation = 16;
+    cfg.fft_size = 4096;
+    const int window = static_cast<int>(0.35f * fs / cfg.decimation);
+    const int decimated_per_s = fs / cfg.decimation;
+
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::vector<float> x(static_cast<size_t>(seconds * fs));
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * 440.7 * static_cast<double>(i) / fs)) + noise(rng);
+    }
+
+    std::vector<float> mags(static_cast<size_t>(cfg.num_bins));
+
+    // Zoom FFT per hop
+    double fft_s = 0.0;
+    {
+        ZoomFFT zoom(cfg);
+        zoom.reset_stream(center);
+        for (size_t i = 0; i + hop <= x.size(); i += hop) {
+            zoom.push(&x[i], hop);
+            const auto t0 = std::chrono::steady_clock::now();
+            zoom.transform(std::min(window, zoom.baseband_size()));
+            zoom.sample_bins(0, cfg.num_bins, mags.data());
+            fft_s += seconds_since(t0);
+        }
+    }
+
+    // Bank per hop, then per decimated sample
+    double bank_hop_s = 0.0, bank_sample_s = 0.0;
+    float worst = 0.0f;
+    {
+        ZoomFFT zoom(cfg);
+        SlidingDftBank bank;
+        bank.configure(cfg.num_bins, window);
+        zoom.reset_stream(center);
+        for (size_t i = 0; i + hop <= x.size(); i += hop) {
+            zoom.push(&x[i], hop);
+            const auto t0 = std::chrono::steady_clock::now();
+            bank.update(zoom);
+            bank.magnitudes(mags.data(), cfg.num_bins);
+            bank_hop_s += seconds_since(t0);
+        }
+        const std::vector<double> ref = direct_dtft(zoom, cfg.num_bins, window);
+        double peak = 0.0;
+        for (double v : ref) peak = std::max(peak, v);
+        for (int b = 0; b < cfg.num_bins; ++b) {
+            worst = std::max(worst, static_cast<float>(std::fabs(mags[b] - ref[static_cast<size_t>(b)]) / peak));
+        }
+    }
+    {
+        ZoomFFT zoom(cfg);
+        SlidingDftBank bank;
+        bank.configure(cfg.num_bins, window);
+        zoom.reset_stream(center);
+        for (size_t i = 0; i + cfg.decimation <= x.size(); i += static_cast<size_t>(cfg.decimation)) {
+            zoom.push(&x[i], cfg.decimation);
+            const auto t0 = std::chrono::steady_clock::now();
+            bank.update(zoom);
+            bank_sample_s += seconds_since(t0);
+        }
+    }
+
+    const double per_s = 1e6 / seconds;
+    const double fft_sample_s = fft_s / (seconds * 100.0) * decimated_per_s * seconds;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "centre spectrum, " << cfg.num_bins << " bins, window " << window << " of " << cfg.fft_size
+              << " at " << decimated_per_s << " Hz; µs per second of audio\n";
+    std::cout << std::setw(34) << std::left << "zoom FFT per 10 ms hop" << std::right << std::setw(12)
+              << fft_s * per_s << "\n";
+    std::cout << std::setw(34) << std::left << "sliding DFT per 10 ms hop" << std::right << std::setw(12)
+              << bank_hop_s * per_s << "\n";
+    std::cout << std::setw(34) << std::left << "sliding DFT per decimated sample" << std::right << std::setw(12)
+              << bank_sample_s * per_s << "\n";
+    std::cout << std::setw(34) << std::left << "zoom FFT per decimated sample (est)" << std::right << std::setw(12)
+              << fft_sample_s * per_s << "\n";
+    std::cout << std::scientific << std::setprecision(2) << "sliding DFT max error vs direct DTFT: " << worst
+              << " of the peak\n";
+
+    if (!(worst <= 1e-4f) || !(bank_sample_s < fft_sample_s)) {
+        std::cout << "FAILED\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include "spsc_ring.hpp"
+#include "triple_buffer.hpp"
+#include "analysis_frame.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <pthread.h>
+#include <sched.h>
+
+using namespace tuner;
+
+// Throughput / latency microbenchmark for SpscRing, LatestSnapshot and the
+// TripleBuffer<AnalysisFrame> DSP -> UI hand-off between
+// two pinned cores, with the previous single-element RingBuffer as baseline.
+// Usage: spsc_ring_bench [producer_core] [consumer_core] [block_size] [log2_total]
+
+// The RingBuffer<T> this replaces: modulo indexing, shared cache line, one item per call
+template <typename T>
+class LegacyRing {
+public:
+    explicit LegacyRing(size_t size) : buffer(size), write_index(0), read_index(0) {}
+    bool push(const T& item) {
+        size_t w = write_index.load(std::memory_order_relaxed);
+        size_t next = (w + 1) % buffer.size();
+        if (next == read_index.load(std::memory_order_acquire)) return false;
+        buffer[w] = item;
+        write_index.store(next, std::memory_order_release);
+        return true;
+    }
+    bool pop(T& item) {
+        size_t r = read_index.load(std::memory_order_relaxed);
+        if (r == write_index.load(std::memory_order_acquire)) return false;
+        item = buffer[r];
+        read_index.store((r + 1) % buffer.size(), std::memory_order_release);
+        return true;
+    }
+private:
+    std::vector<T> buffer;
+    std::atomic<size_t> write_index;
+    std::atomic<size_t> read_index;
+};
+
+static void pin_to_core(int core) {
+    if (core < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        std::cerr << "warning: could not pin to core " << core << std::endl;
+    }
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Busy-wait on `ready`, yielding after a while so a single-core run still progresses
+template <typename Fn>
+static void spin_until(Fn&& ready) {
+    int spins = 0;
+    while (!ready()) {
+        if (++spins >= 256) { spins = 0; std::this_thread::yield(); }
+    }
+}
+
+template <typename Producer, typename Consumer>
+static double run_pair(int pcore, int ccore, Producer&& produce, Consumer&& consume) {
+    std::atomic<int> ready{0};
+    auto t0 = Clock::now();
+    std::thread c([&] { pin_to_core(ccore); ready++; spin_until([&] { return ready.load() >= 2; }); consume(); });
+    std::thread p([&] { pin_to_core(pcore); ready++; spin_until([&] { return ready.load() >= 2; }); produce(); });
+    p.join();
+    c.join();
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int main(int argc, char* argv[]) {
+    const int pcore = argc > 1 ? std::atoi(argv[1]) : 0;
+    const int ccore = argc > 2 ? std::atoi(argv[2]) : 1;
+    const size_t block = argc > 3 ? static_cast<size_t>(std::max(1, std::atoi(argv[3]))) : 64;
+    const int log2_total = argc > 4 ? std::max(10, std::min(34, std::atoi(argv[4]))) : 26;
+    const size_t total = size_t(1) << log2_total;  // samples per throughput run
+    const size_t capacity = 8192;
+
+    std::cout << "SPSC ring benchmark: producer core " << pcore << ", consumer core " << ccore
+              << ", block " << block << ", " << total << " floats" << std::endl;
+    bool ok = true;
+
+    // --- throughput: legacy, one element per call ---
+    {
+        LegacyRing<float> ring(capacity);
+        size_t errors = 0;
+        double sec = run_pair(pcore, ccore,
+            [&] { for (size_t i = 0; i < total; ++i) spin_until([&] { return ring.push(static_cast<float>(i & 0xFFFFFF)); }); },
+            [&] {
+                float v;
+                for (size_t i = 0; i < total; ++i) {
+                    spin_until([&] { return ring.pop(v); });
+                    if (v != static_cast<float>(i & 0xFFFFFF)) ++errors;
+                }
+            });
+        std::cout << std::fixed << std::setprecision(1) << "legacy RingBuffer  push/pop  "
+                  << std::setw(8) << total / sec / 1e6 << " M floats/s" << (errors ? "  DATA ERRORS" : "") << std::endl;
+        ok &= errors == 0;
+    }
+
+    // --- throughput: SpscRing, element and bulk ---
+    {
+        SpscRing<float> ring(capacity);
+        size_t errors = 0;
+        double sec = run_pair(pcore, ccore,
+            [&] { for (size_t i = 0; i < total; ++i) spin_until([&] { return ring.push(static_cast<float>(i & 0xFFFFFF)); }); },
+            [&] {
+                float v;
+                for (size_t i = 0; i < total; ++i) {
+                    spin_until([&] { return ring.pop(v); });
+                    if (v != static_cast<float>(i & 0xFFFFFF)) ++errors;
+                }
+            });
+        std::cout << "SpscRing          push/pop  " << std::setw(8) << total / sec / 1e6 << " M floats/s"
+                  << (errors ? "  DATA ERRORS" : "") << std::endl;
+        ok &= errors == 0;
+    }
+    {
+        SpscRing<float> ring(capacity);
+        size_t errors = 0;
+        double sec = run_pair(pcore, ccore,
+            [&] {
+                std::vector<float> buf(block);
+                for (size_t i = 0; i < total; i += block) {
+                    for (size_t k = 0; k < block; ++k) buf[k] = static_cast<float>((i + k) & 0xFFFFFF);
+                    size_t done = 0;
+                    spin_until([&] { done += ring.write(buf.data() + done, block - done); return done == block; });
+                }
+            },
+            [&] {
+                size_t i = 0;
+                while (i < total) {
+                    // Zero-copy read of whatever is available, in at most two segments
+                    auto seg = ring.peek(4 * block);
+                    if (seg.size() == 0) { std::this_thread::yield(); continue; }
+                    for (size_t k = 0; k < seg.first.size; ++k) if (seg.first.data[k] != static_cast<float>((i + k) & 0xFFFFFF)) ++errors;
+                    i += seg.first.size;
+                    for (size_t k = 0; k < seg.second.size; ++k) if (seg.second.data[k] != static_cast<float>((i + k) & 0xFFFFFF)) ++errors;
+                    i += seg.second.size;
+                    ring.consume(seg.size());
+                }
+            });
+        std::cout << "SpscRing          bulk/peek " << std::setw(8) << total / sec / 1e6 << " M floats/s"
+                  << (errors ? "  DATA ERRORS" : "") << std::endl;
+        ok &= errors == 0;
+    }
+
+    // --- latency: ping-pong round trip of one block ---
+    {
+        const int iters = static_cast<int>(std::min<size_t>(200000, total / 256));
+        SpscRing<float> to_b(capacity), to_a(capacity);
+        std::vector<double> rtt_ns;
+        rtt_ns.reserve(iters);
+        run_pair(pcore, ccore,
+            [&] {
+                std::vector<float> buf(block, 1.0f);
+                for (int it = 0; it < iters; ++it) {
+                    auto t0 = Clock::now();
+                    size_t done = 0;
+                    spin_until([&] { done += to_b.write(buf.data() + done, block - done); return done == block; });
+                    done = 0;
+                    spin_until([&] { done += to_a.read(buf.data() + done, block - done); return done == block; });
+                    rtt_ns.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count());
+                }
+            },
+            [&] {
+                std::vector<float> buf(block);
+                for (int it = 0; it < iters; ++it) {
+                    size_t done = 0;
+                    spin_until([&] { done += to_b.read(buf.data() + done, block - done); return done == block; });
+                    done = 0;
+                    spin_until([&] { done += to_a.write(buf.data() + done, block - done); return done == block; });
+                }
+            });
+        std::sort(rtt_ns.begin(), rtt_ns.end());
+        auto pct = [&](double p) { return rtt_ns[std::min(rtt_ns.size() - 1, static_cast<size_t>(p * rtt_ns.size()))] / 2.0; };
+        std::cout << std::setprecision(0) << "SpscRing one-way latency (block " << block << "): p50 " << pct(0.5)
+                  << " ns, p99 " << pct(0.99) << " ns, p99.9 " << pct(0.999) << " ns" << std::endl;
+    }
+
+    // --- LatestSnapshot: one writer, two readers, check for torn frames ---
+    {
+        struct Frame { uint64_t id; float values[62]; };
+        LatestSnapshot<Frame> snap;
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> reads{0}, torn{0};
+        auto reader = [&](int core) {
+            pin_to_core(core);
+            Frame f;
+            uint64_t n = 0, bad = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (!snap.read(f)) continue;
+                ++n;
+                for (float v : f.values) if (v != static_cast<float>(f.id & 0xFFFFFF)) { ++bad; break; }
+            }
+            reads += n;
+            torn += bad;
+        };
+        std::thread r1(reader, ccore), r2(reader, ccore >= 0 ? ccore + 1 : -1);
+        pin_to_core(pcore);
+        Frame f;
+        const uint64_t publishes = std::min<uint64_t>(5000000, total / 8);
+        auto t0 = Clock::now();
+        for (uint64_t id = 1; id <= publishes; ++id) {
+            f.id = id;
+            std::fill(std::begin(f.values), std::end(f.values), static_cast<float>(id & 0xFFFFFF));
+            snap.publish(f);
+        }
+        double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        stop = true;
+        r1.join();
+        r2.join();
+        std::cout << std::setprecision(1) << "LatestSnapshot (256 B): " << publishes / sec / 1e6 << " M publishes/s, "
+                  << reads.load() / sec / 1e6 << " M reads/s across 2 readers, torn " << torn.load() << std::endl;
+        ok &= torn.load() == 0;
+    }
+
+    // --- TripleBuffer<AnalysisFrame>: DSP -> UI hand-off, frames must arrive whole and in order ---
+    {
+        static TripleBuffer<AnalysisFrame> frames;
+        std::atomic<bool> stop{false};
+        uint64_t acquired = 0, torn = 0, backwards = 0;
+        std::thread ui([&]() {
+            pin_to_core(ccore);
+            uint64_t last = 0;
+            while (true) {
+                const bool done = stop.load(std::memory_order_acquire);
+                if (!frames.acquire()) {
+                    if (done) break;
+                    continue;
+                }
+                const AnalysisFrame& f = frames.read_buffer();
+                ++acquired;
+                if (f.seq <= last) ++backwards;
+                last = f.seq;
+                const float expect = static_cast<float>(f.seq & 0xFFFFFF);
+                for (int i = 0; i < f.num_bins; ++i) if (f.spectrum[i] != expect) { ++torn; break; }
+            }
+        });
+        pin_to_core(pcore);
+        const uint64_t publishes = std::min<uint64_t>(1000000, total / 64);
+        auto t0 = Clock::now();
+        for (uint64_t seq = 1; seq <= publishes; ++seq) {
+            AnalysisFrame& f = frames.write_buffer();
+            f.seq = seq;
+            f.num_bins = AnalysisFrame::MAX_BINS;
+            std::fill(f.spectrum.begin(), f.spectrum.end(), static_cast<float>(seq & 0xFFFFFF));
+            frames.publish();
+        }
+        double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        stop.store(true, std::memory_order_release);
+        ui.join();
+        std::cout << std::setprecision(2) << "TripleBuffer<AnalysisFrame> (" << sizeof(AnalysisFrame) << " B): "
+                  << publishes / sec / 1e6 << " M publishes/s, " << acquired << " acquired, torn " << torn
+                  << ", out of order " << backwards << std::endl;
+        ok &= torn == 0 && backwards == 0;
+    }
+
+    std::cout << (ok ? "All checks passed" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+#include "analysis_pipeline.hpp"
+#include "strike_tracker.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace tuner;
+
+// Strike phases (StrikeTracker) and the zoom measuring only the sustain
+// (strike_gate), against the pipeline measuring throughout.
+// Usage: strike_gate_bench
+// Three strikes with a hammer thump and the attack's pitch glide (partials
+// start 10 cents sharp, settling with a 80 ms time constant): A4 mezzo at
+// 0.5 s, A4 again forte at 1.5 s over its sustain, C5 at 4.5 s after A4
+// has died away; 64-frame callbacks at 48 kHz, centred on the note struck,
+// NotesState lanes subscribed. Reports when each strike was seen and its
+// sustain began, the earliest centre-lane measurement after each strike,
+// the centre lane's error in cents over the first 0.6 s of each strike
+// (median and worst of the frames measured, gated and not), and the
+// pipeline's cost per second of audio.
+// Also drives a StrikeTracker alone with a one-hop click over a quiet
+// floor, which starts an attack that falls back to waiting, and then a note.
+// Fails on a strike missed, counted twice or seen later than one hop; a
+// lane measured before attack_seconds; a gated median error not below
+// the ungated one; the gated run costing more than the ungated one; or the
+// click not starting an attack, or being counted as a strike.
+
+namespace {
+
+constexpr int FS = 48000;
+constexpr int BLOCK = 64;
+constexpr float TOTAL = 7.0f;
+constexpr float GLIDE_CENTS = 10.0f;
+constexpr float GLIDE_SECONDS = 0.08f;
+constexpr float MEASURE_SECONDS = 0.6f;
+
+struct Strike {
+    float onset;
+    float f1;
+    float amplitude;
+};
+const Strike STRIKES[] = {{0.5f, 440.0f, 0.15f}, {1.5f, 440.0f, 0.4f}, {4.5f, 523.25f, 0.3f}};
+constexpr int NUM_STRIKES = 3;
+
+std::vector<float> scene() {
+    std::vector<float> x(static_cast<size_t>(TOTAL * FS), 0.0f);
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    for (const Strike& s : STRIKES) {
+        // A4 is damped when C5 is struck
+        const float end = s.f1 == 440.0f ? STRIKES[2].onset : TOTAL;
+        for (int k = 1; k <= 8; ++k) {
+            double phase = 0.0;
+            const double fk = k * s.f1 * std::sqrt(1.0 + 4e-4 * k * k);
+            for (size_t i = static_cast<size_t>(s.onset * FS); i < static_cast<size_t>(end * FS); ++i) {
+                const double t = static_cast<double>(i) / FS - s.onset;
+                const double f = fk * std::exp2(GLIDE_CENTS * std::exp(-t / GLIDE_SECONDS) / 1200.0);
+                phase += 2.0 * M_PI * f / FS;
+                x[i] += static_cast<float>(s.amplitude / k * std::exp(-t * (1.0 + 0.35 * (k - 1)) / 1.5) * std::sin(phase));
+            }
+        }
+        for (size_t i = static_cast<size_t>(s.onset * FS), n = 0; n < static_cast<size_t>(0.05f * FS); ++i, ++n) {
+            x[i] += s.amplitude * 0.3f * std::exp(-static_cast<float>(n) / (0.012f * FS)) * noise(rng);
+        }
+    }
+    std::normal_distribution<float> floor_noise(0.0f, 1e-4f);
+    for (float& v : x) v += floor_noise(rng);
+    return x;
+}
+
+int strike_at(float t) {
+    int s = -1;
+    for (int i = 0; i < NUM_STRIKES; ++i) {
+        if (t > STRIKES[i].onset) s = i;  // the block holds samples after the onset
+    }
+    return s;
+}
+
+struct Run {
+    float seen[NUM_STRIKES] = {-1.0f, -1.0f, -1.0f};     // attack started, after the onset
+    int counted[NUM_STRIKES] = {0, 0, 0};                // strikes counted in each strike's time
+    float sustain[NUM_STRIKES] = {-1.0f, -1.0f, -1.0f};  // sustain began, after the onset
+    float first_lane[NUM_STRIKES] = {-1.0f, -1.0f, -1.0f};
+    std::vector<float> errors[NUM_STRIKES];             // |cents| of the centre lane
+    int strikes = 0;
+    double seconds = 0.0;
+};
+
+Run run(const std::vector<float>& x, bool gate) {
+    AnalysisPipelineConfig config;
+    config.strike_gate = gate;
+    AnalysisPipeline pipeline(config);
+    pipeline.graph().subscribe(AnalysisConsumer::NotesState,
+                               node_bit(AnalysisNode::LaneCenter) | node_bit(AnalysisNode::LaneF0));
+    pipeline.graph().subscribe(AnalysisConsumer::FrameOutput, node_bit(AnalysisNode::Strike));
+    Run r;
+    AnalysisFrame frame;
+    int strikes = 0;
+    bool sustain = false;
+    for (size_t i = 0; i + BLOCK <= x.size(); i += BLOCK) {
+        const float t = static_cast<float>(i + BLOCK) / FS;
+        const int s = strike_at(t);
+        // Centred on the note struck, as auto note would move it
+        pipeline.set_center_frequency(s >= 0 ? STRIKES[s].f1 : STRIKES[0].f1);
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool due = pipeline.process(&x[i], BLOCK, FS, frame);
+        r.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (!due || s < 0) continue;
+        const float age = t - STRIKES[s].onset;
+        // Seen as its attack starts; counted once the attack reaches the sustain
+        if (frame.strike_phase == StrikePhase::Attack && r.seen[s] < 0.0f) r.seen[s] = age;
+        if (frame.strikes != strikes) {
+            if (frame.strikes != strikes + 1 || ++r.counted[s] > 1) r.seen[s] = 1e9f;  // counted twice
+            strikes = frame.strikes;
+        }
+        const bool now_sustain = frame.strike_phase == StrikePhase::Monitoring;
+        if (now_sustain && !sustain && r.sustain[s] < 0.0f) r.sustain[s] = age;
+        sustain = now_sustain;
+        if (!(frame.nodes_run & node_bit(AnalysisNode::LaneCenter)) || !(frame.lane2.freq_hz > 0.0f)) continue;
+        if (r.first_lane[s] < 0.0f) r.first_lane[s] = age;
+        if (age <= MEASURE_SECONDS) {
+            const double truth = STRIKES[s].f1 * std::sqrt(1.0 + 4e-4);
+            r.errors[s].push_back(static_cast<float>(std::fabs(1200.0 * std::log2(frame.lane2.freq_hz / truth))));
+        }
+    }
+    r.strikes = strikes;
+    return r;
+}
+
+float median(std::vector<float> v) {
+    if (v.empty()) return 1e9f;
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    return v[v.size() / 2];
+}
+
+float worst(const std::vector<float>& v) { return v.empty() ? 1e9f : *std::max_element(v.begin(), v.end()); }
+
+// StrikeTracker alone, one level per 10 ms hop: a click starts an attack
+// that falls back to waiting, then a decaying note. Returns the strikes
+// counted after each; the attack the click started is reported through
+// `click_attack`
+std::pair<int, int> transient_then_strike(bool& click_attack) {
+    StrikeTracker tracker;
+    const int hop = FS / 100;
+    auto feed = [&](float level, int hops) {
+        for (int i = 0; i < hops; ++i) {
+            if (tracker.update(level, hop, FS) == StrikePhase::Attack) click_attack = true;
+        }
+    };
+    click_attack = false;
+    feed(5e-4f, 100);  // floor under min_level
+    feed(5e-2f, 1);    // one hop of click
+    feed(5e-4f, 50);
+    const int after_click = tracker.strikes();
+    for (int i = 0; i < 100; ++i) tracker.update(0.1f * std::pow(0.97f, static_cast<float>(i)), hop, FS);
+    return {after_click, tracker.strikes()};
+}
+
+} // namespace
+
+int main() {
+    const std::vector<float> x = scene();
+    run(x, true);  // warm up
+    const Run open = run(x, false);
+    const Run gated = run(x, true);
+    const float hop = AnalysisPipelineConfig{}.hop_seconds;
+    const float attack = StrikeTrackerConfig{}.attack_seconds;
+
+    bool ok = gated.strikes == NUM_STRIKES;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "strike  seen_s  sustain_s  first_lane_s  median_cents  worst_cents  ungated_first_s  ungated_median  ungated_worst\n";
+    for (int s = 0; s < NUM_STRIKES; ++s) {
+        std::cout << std::setw(6) << s + 1 << std::setw(8) << gated.seen[s] << std::setw(11) << gated.sustain[s]
+                  << std::setw(14) << gated.first_lane[s] << std::setw(14) << median(gated.errors[s]) << std::setw(13)
+                  << worst(gated.errors[s]) << std::setw(17) << open.first_lane[s] << std::setw(16)
+                  << median(open.errors[s]) << std::setw(15) << worst(open.errors[s]) << "\n";
+        if (!(gated.seen[s] >= 0.0f && gated.seen[s] <= hop + 1e-3f) || gated.counted[s] != 1) ok = false;
+        if (!(gated.first_lane[s] >= attack)) ok = false;
+        if (!(median(gated.errors[s]) < median(open.errors[s]))) ok = false;
+    }
+    std::cout << std::setprecision(1) << "pipeline cost: " << open.seconds / TOTAL * 1e6 << " µs per second of audio ungated, "
+              << gated.seconds / TOTAL * 1e6 << " gated\n";
+    if (gated.seconds > open.seconds) ok = false;
+    bool click_attack = false;
+    const auto counts = transient_then_strike(click_attack);
+    std::cout << "click: " << (click_attack ? "attack" : "no attack") << ", strikes " << counts.first
+              << "; a note after it: strikes " << counts.second << "\n";
+    if (!click_attack || counts.first != 0 || counts.second != 1) ok = false;
+    if (!ok) {
+        std::cout << "FAILED\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "zoom_fft.hpp"
+#include "audio_input.hpp"
+#include "audio_input_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tuner;
+
+// Headless playback of a WAV file through the file backend and ZoomFFT.
+// Usage: wav_playback_test <file.wav> [center_hz] [realtime|fast|step]
+// Prints the zoom peak for each analysis window and the overall throughput.
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.wav> [center_hz] [realtime|fast|step]" << std::endl;
+        return 1;
+    }
+    const std::string path = argv[1];
+    const float center_hz = argc > 2 ? std::strtof(argv[2], nullptr) : 440.0f;
+    PlaybackMode mode = PlaybackMode::AsFastAsPossible;
+    if (argc > 3) {
+        if (std::strcmp(argv[3], "realtime") == 0) mode = PlaybackMode::Realtime;
+        else if (std::strcmp(argv[3], "step") == 0) mode = PlaybackMode::SingleStep;
+    }
+
+    AudioConfig audio_config;
+    audio_config.device_name = "file:" + path;
+    audio_config.period_size = 256;
+    audio_config.playback_mode = mode;
+
+    auto audio = createAudioInput(audio_config);
+    const int sample_rate = static_cast<int>(audio->get_config().sample_rate);
+
+    ZoomFFTConfig config;
+    config.sample_rate = sample_rate;
+    config.decimation = 16;
+    config.fft_size = 1024;
+    config.num_bins = 240;
+    ZoomFFT zoom(config);
+
+    const size_t window = static_cast<size_t>(config.decimation) * config.fft_size;
+    std::vector<float> block;
+    block.reserve(window);
+    int windows = 0;
+
+    audio->set_process_callback([&](const float* input, int num_samples) {
+        block.insert(block.end(), input, input + num_samples);
+        if (block.size() < window) return;
+
+        auto mags = zoom.process(block.data(), static_cast<int>(block.size()), center_hz);
+        int peak_idx = 0;
+        for (size_t i = 1; i < mags.size(); ++i) {
+            if (mags[i] > mags[peak_idx]) peak_idx = static_cast<int>(i);
+        }
+        const float t = static_cast<float>(windows * window) / static_cast<float>(sample_rate);
+        std::cout << std::fixed << std::setprecision(3) << "t=" << t << "s peak "
+                  << zoom.get_bin_frequency(peak_idx, center_hz) << " Hz mag " << mags[peak_idx] << std::endl;
+        ++windows;
+        block.clear();
+    });
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (!audio->start()) {
+        std::cerr << "Audio failed\n";
+        return 1;
+    }
+
+    auto* source = dynamic_cast<BufferAudioInput*>(audio.get());
+    if (mode == PlaybackMode::SingleStep) {
+        while (audio->step()) {}
+    } else {
+        while (source && !source->finished()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    audio->stop();
+    auto t1 = std::chrono::steady_clock::now();
+
+    const double wall = std::chrono::duration<double>(t1 - t0).count();
+    const double audio_sec = source ? static_cast<double>(source->frames_delivered()) / sample_rate : 0.0;
+    auto stats = audio->get_latency_stats();
+    std::cout << std::setprecision(2) << "Played " << audio_sec << " s of audio in " << wall * 1000.0 << " ms ("
+              << (wall > 0.0 ? audio_sec / wall : 0.0) << "x realtime), callback avg " << stats.avg_ms
+              << " ms max " << stats.max_ms << " ms, late periods " << stats.xruns << std::endl;
+    return 0;
+}
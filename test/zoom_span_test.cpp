@@ -0,0 +1,103 @@
+#include "pre_decimator.hpp"
+#include "zoom_fft.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+
+using namespace tuner;
+
+// Span-driven zoom decimation.
+// Usage: zoom_span_test
+// For A1, A4 and C7 at ±25, ±50, ±120 and ±600 cents at 48 kHz, behind the
+// pipeline's front end: the decimation max_zoom_decimation allows, how the
+// lane splits it over its filter stages, and then through that lane
+//  - the refined peak of a tone at 0.6 of the span against a one-stage lane
+//    at the largest decimation one stage allows
+//  - the level of a tone that folds just inside the span's lower edge,
+//    relative to the same tone at that edge
+// Fails if a peak moves by 0.001 cents or an alias is less than 40 dB down.
+
+namespace {
+
+std::vector<float> tone(double hz, int fs, double seconds) {
+    std::vector<float> x(static_cast<size_t>(seconds * fs));
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<float>(std::sin(2.0 * M_PI * hz * static_cast<double>(i) / fs));
+    }
+    return x;
+}
+
+struct LanePeak {
+    float hz = 0.0f;
+    float magnitude = 0.0f;
+};
+
+// `decimation` from the input rate, of which `front` is the front end's
+LanePeak lane_peak(int fs, int front, int decimation, float span, float center, double hz) {
+    PreDecimator pre;
+    pre.configure(fs, front);
+    ZoomFFTConfig cfg;
+    cfg.sample_rate = fs / pre.factor();
+    cfg.decimation = decimation / pre.factor();
+    cfg.fft_size = 4096;
+    cfg.span_cents = span;
+    ZoomFFT zoom(cfg);
+    const std::vector<float> x = tone(hz, fs, 2.0);
+    std::vector<float> y(static_cast<size_t>(pre.max_output(static_cast<int>(x.size()))));
+    const int n = pre.process(x.data(), static_cast<int>(x.size()), y.data());
+    zoom.reset_stream(center);
+    zoom.push(y.data(), n);
+    // The newest second: the filters have long settled
+    zoom.transform(static_cast<int>(1.0 * fs / decimation));
+    std::vector<float> mags(static_cast<size_t>(cfg.num_bins));
+    zoom.sample_bins(0, cfg.num_bins, mags.data());
+    int best = 0;
+    for (int b = 1; b < cfg.num_bins; ++b) if (mags[b] > mags[best]) best = b;
+    return {zoom.refine_peak(zoom.get_bin_frequency(best, center), PeakEstimator::WindowCorrected), mags[best]};
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    const int fs = 48000;
+    std::cout << std::fixed;
+    std::cout << "note  span  front      D  stages  fs_dec_hz  peak_shift_cents  alias_db\n";
+    for (float center : {55.0f, 440.0f, 2093.0f}) {
+        for (float span : {25.0f, 50.0f, 120.0f, 600.0f}) {
+            const int front = max_front_decimation(fs, center, 4, span);
+            const int d = max_zoom_decimation(fs, center, span, front);
+            const int first = zoom_first_stage(fs / front, d / front, center, span);
+            int reference = 32;  // largest the lane filters in one stage
+            while (reference > 1 && zoom_first_stage(fs, reference, center, span) != reference) --reference;
+
+            const double offset = center * (std::pow(2.0, 0.6 * span / 1200.0) - 1.0);
+            const LanePeak lane = lane_peak(fs, front, d, span, center, center + offset);
+            const LanePeak ref = lane_peak(fs, 1, reference, span, center, center + offset);
+            const float shift = static_cast<float>(std::fabs(1200.0 * std::log2(lane.hz / ref.hz)));
+
+            // Content one decimated rate above the span's lower edge folds
+            // just inside it: the nearest alias the filters must hold off
+            const float fs_dec = static_cast<float>(fs) / static_cast<float>(d);
+            const double edge = center * (1.0 - std::pow(2.0, -0.9 * span / 1200.0));
+            const LanePeak at_center = lane_peak(fs, front, d, span, center, center - edge);
+            const LanePeak alias = lane_peak(fs, front, d, span, center, center - edge + fs_dec);
+            const float alias_db = 20.0f * std::log10(std::max(1e-30f, alias.magnitude) / at_center.magnitude);
+
+            std::cout << std::setw(4) << (center < 100.0f ? "A1" : center < 1000.0f ? "A4" : "C7") << std::setw(6)
+                      << std::setprecision(0) << span << std::setw(7) << front << std::setw(7) << d << std::setw(5)
+                      << first << "x" << std::left << std::setw(3) << d / front / first << std::right << std::setw(10)
+                      << std::setprecision(1) << fs_dec << std::setw(18) << std::setprecision(4) << shift << std::setw(10)
+                      << std::setprecision(1) << alias_db << "\n";
+            if (!(shift <= 0.001f) || !(alias_db <= -40.0f)) ok = false;
+        }
+    }
+
+    if (!ok) {
+        std::cout << "FAILED\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}
@@ -90,6 +90,8 @@ void NotesController::render(const tuner::SessionSettings& session, const NotesS
         if (pk > 1) std::snprintf(partial_note, sizeof(partial_note), "%d %s — %s partial (center)", knum, label.c_str(), ordinal(pk));
         else std::snprintf(partial_note, sizeof(partial_note), "%d %s", knum, label.c_str());
         ImGui::Text("Current note: %s", partial_note);
+        if (state.following()) ImGui::Text("Following the coarse pitch: centre %.2f Hz", state.center_frequency_hz());
+        ImGui::Text("Strikes heard: %d", state.onsets(sel));
     }
 
     // Computed
@@ -9,16 +9,25 @@ void NotesState::update_from_session(const tuner::SessionSettings& s) {
     int n = key_index_ - 48;
     float f1 = a4_hz * std::pow(2.0f, n / 12.0f);
     // Center on preferred partial (e.g., k=2 for starting on A3 2nd partial)
-    center_hz_ = f1 * std::max(1, preferred_partial_k_);
+    center_hz_ = followed_hz_ > 0.0f ? followed_hz_ : f1 * std::max(1, preferred_partial_k_);
 }
 
 void NotesState::set_key_index(int idx) {
     if (idx < 0) idx = 0; if (idx > 87) idx = 87;
     key_index_ = idx;
+    followed_hz_ = 0.0f;
+}
+
+void NotesState::record_onsets(const int* counts) {
+    if (!counts) return;
+    for (int k = 0; k < 88; ++k) {
+        if (counts[k] > onsets_seen_[k]) per_note_[k].onsets += counts[k] - onsets_seen_[k];
+        onsets_seen_[k] = counts[k];
+    }
 }
 
 void NotesState::ingest_measurement(const NotesStateReading& r) {
-    tracker_.push_frame(r.f0_hz, r.f2_hz, r.mag0, r.mag2, r.snr0, r.snr2);
+    tracker_.push_frame(r.f0_hz, r.f2_hz, r.mag0, r.mag2, r.snr0, r.snr2, r.var0, r.var2);
     // Lightweight B inference from higher partials if f0 is weak
     // Use pairs among {f2,f3,f4} when available to estimate B, then back out f1.
     auto have = [&](float x){ return x > 0.0f && std::isfinite(x); };
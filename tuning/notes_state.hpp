@@ -20,6 +20,8 @@ struct NotesStateReading {
     float snr2 = 0.0f;
     float snr3 = 0.0f;
     float snr4 = 0.0f;
+    float var0 = 0.0f;  // phase-advance frequency variance (cents^2), 0 = unknown
+    float var2 = 0.0f;
 };
 
 class NotesState {
@@ -27,11 +29,22 @@ public:
     void update_from_session(const tuner::SessionSettings& s);
     void set_key_index(int idx); // 0..87
     int key_index() const { return key_index_; }
-    void set_preferred_partial_k(int k) { preferred_partial_k_ = k < 1 ? 1 : k; }
+    void set_preferred_partial_k(int k) { preferred_partial_k_ = k < 1 ? 1 : k; followed_hz_ = 0.0f; }
     int preferred_partial_k() const { return preferred_partial_k_; }
 
+    // Centre on a partial the coarse pitch found instead of the key's; the
+    // next key or partial chosen ends it
+    void follow_center(float hz) { if (hz > 0.0f) followed_hz_ = center_hz_ = hz; }
+    bool following() const { return followed_hz_ > 0.0f; }
+
     void ingest_measurement(const NotesStateReading& r);
 
+    // Onset counts per key from the keyboard-wide key bank (88 entries,
+    // counted since the bank started, so frames skipped on the way lose
+    // none); a count that falls means the bank started over
+    void record_onsets(const int* counts);
+    int onsets(int idx) const { return idx < 0 || idx > 87 ? 0 : per_note_[idx].onsets; }
+
     // Live (per-frame) measurements for troubleshooting (not gated)
     void set_live_measurements(float f0_hz, float f2_hz, float snr0, float snr2) {
         live_f0_hz_ = f0_hz; live_f2_hz_ = f2_hz; live_snr0_ = snr0; live_snr2_ = snr2; }
@@ -48,9 +61,11 @@ private:
     int key_index_ = 48; // A4
     int preferred_partial_k_ = 1; // center on this partial (e.g., 2 for A3 start)
     float center_hz_ = 440.0f;
+    float followed_hz_ = 0.0f; // follow_center(); 0 = the key's
     OctaveLockTracker tracker_{};
-    struct NoteAnalysis { bool has_b=false; float B=0.0f; float f1_inferred=0.0f; };
+    struct NoteAnalysis { bool has_b=false; float B=0.0f; float f1_inferred=0.0f; int onsets=0; };
     NoteAnalysis per_note_[88]{};
+    int onsets_seen_[88]{};  // bank counts already recorded
 
     // Live fields
     float live_f0_hz_ = 0.0f;